@@ -35,6 +35,8 @@ namespace casadi {
   bool CasadiOptions::profilingBinary = true;
   bool CasadiOptions::purgeSeeds = false;
   bool CasadiOptions::allowed_internal_api = false;
+  std::string CasadiOptions::sparsity_cache_dir = "";
+  std::string CasadiOptions::jit_cache_dir = "";
 
   void CasadiOptions::startProfiling(const std::string &filename) {
     profilingLog.open(filename.c_str(), std::ofstream::out);
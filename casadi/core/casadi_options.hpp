@@ -79,6 +79,18 @@ namespace casadi {
 
       static bool allowed_internal_api;
 
+      /** \brief Default directory of the on-disk cache of Jacobian sparsity patterns
+      * Used by functions for which the option "sparsity_cache" is not set.
+      * Default: "" (no caching)
+      */
+      static std::string sparsity_cache_dir;
+
+      /** \brief Default directory of the cache of just-in-time compiled code
+      * Used by functions for which the option "jit_cache" is not set.
+      * Default: "" (a directory of the current user, see JitCache::defaultDirectory)
+      */
+      static std::string jit_cache_dir;
+
 #endif //SWIG
       // Setter and getter for catch_errors_swig
       static void setCatchErrorsSwig(bool flag) { catch_errors_swig = flag; }
@@ -105,6 +117,12 @@ namespace casadi {
 
       static void setAllowedInternalAPI(bool flag) { allowed_internal_api= flag; }
       static bool getAllowedInternalAPI() { return allowed_internal_api; }
+
+      static void setSparsityCacheDir(const std::string& dir) { sparsity_cache_dir = dir; }
+      static std::string getSparsityCacheDir() { return sparsity_cache_dir; }
+
+      static void setJitCacheDir(const std::string& dir) { jit_cache_dir = dir; }
+      static std::string getJitCacheDir() { return jit_cache_dir; }
   };
 
 } // namespace casadi
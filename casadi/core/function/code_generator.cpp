@@ -32,7 +32,15 @@
 using namespace std;
 namespace casadi {
 
+  CodeGenerator::CodeGenerator() : static_auxiliaries_(false) {
+  }
+
   void CodeGenerator::flush(std::ostream& s) const {
+    flushHeader(s);
+    flushBody(s);
+  }
+
+  void CodeGenerator::flushHeader(std::ostream& s) const {
     s << includes_.str();
     s << endl;
 
@@ -40,7 +48,9 @@ namespace casadi {
     s << "#define d double" << endl << endl;
 
     s << auxiliaries_.str();
+  }
 
+  void CodeGenerator::flushBody(std::ostream& s) const {
     // Print integer constants
     stringstream name;
     for (int i=0; i<integer_constants_.size(); ++i) {
@@ -233,6 +243,12 @@ namespace casadi {
     // Quick return if it already exists
     if (!added) return;
 
+    // Add dependencies first
+    if (f==AUX_COPY_SPARSE) addAuxiliary(AUX_COPY);
+
+    // Keep the definition local to the translation unit, if requested
+    if (static_auxiliaries_) auxiliaries_ << "static ";
+
     // Add the appropriate function
     switch (f) {
     case AUX_COPY:
@@ -272,7 +288,6 @@ namespace casadi {
       auxSign();
       break;
     case AUX_COPY_SPARSE:
-      addAuxiliary(AUX_COPY);
       auxiliaries_ << codegen_str_copy_sparse << endl;
       break;
     case AUX_TRANS:
@@ -38,6 +38,9 @@ namespace casadi {
   class CASADI_EXPORT CodeGenerator {
   public:
 
+    /// Constructor
+    CodeGenerator();
+
     /// Add an include file optionally using a relative path "..." instead of an absolute path <...>
     void addInclude(const std::string& new_include, bool relative_path = false);
 
@@ -92,6 +95,12 @@ namespace casadi {
     /// Flush generated file to a stream
     void flush(std::ostream& s) const;
 
+    /// Flush the includes, macros and auxiliary functions to a stream
+    void flushHeader(std::ostream& s) const;
+
+    /// Flush the constants, dependencies and functions to a stream
+    void flushBody(std::ostream& s) const;
+
     /** Convert in integer to a string */
     static std::string numToString(int n);
 
@@ -123,6 +132,9 @@ namespace casadi {
     std::stringstream function_;
     std::stringstream finalization_;
 
+    // Declare auxiliary functions static, for code spread over several files
+    bool static_auxiliaries_;
+
     // Set of already included header files
     typedef std::map<const void*, int> PointerMap;
     std::set<std::string> added_includes_;
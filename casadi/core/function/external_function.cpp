@@ -41,6 +41,10 @@ using namespace std;
     assignNode(new ExternalFunctionInternal(bin_name));
   }
 
+  ExternalFunction::ExternalFunction(const std::string& bin_name, const std::string& f_name) {
+    assignNode(new ExternalFunctionInternal(bin_name, f_name));
+  }
+
   ExternalFunctionInternal* ExternalFunction::operator->() {
     return static_cast<ExternalFunctionInternal*>(Function::operator->());
   }
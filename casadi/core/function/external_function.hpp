@@ -50,6 +50,11 @@ public:
   /** \brief  Create an empty function */
   explicit ExternalFunction(const std::string& bin_name);
 
+  /** \brief  Load the function f_name from a library with several functions
+   * \see Function::generateLibrary
+   */
+  ExternalFunction(const std::string& bin_name, const std::string& f_name);
+
   /** \brief  Access functions of the node */
   ExternalFunctionInternal* operator->();
 
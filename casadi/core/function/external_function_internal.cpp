@@ -34,9 +34,15 @@ namespace casadi {
 
 using namespace std;
 
-ExternalFunctionInternal::ExternalFunctionInternal(const std::string& bin_name) :
-    bin_name_(bin_name) {
+ExternalFunctionInternal::ExternalFunctionInternal(const std::string& bin_name,
+                                                   const std::string& f_name) :
+    bin_name_(bin_name), f_name_(f_name) {
 #ifdef WITH_DL
+  // Names of the entry points
+  string prefix = f_name.empty() ? string() : f_name + "_";
+  string init_name = prefix + "init";
+  string sparsity_name = prefix + "getSparsity";
+  string evaluate_name = prefix + "evaluateWrap";
 
   // Load the dll
 #ifdef _WIN32
@@ -44,12 +50,14 @@ ExternalFunctionInternal::ExternalFunctionInternal(const std::string& bin_name)
   casadi_assert_message(handle_!=0, "ExternalFunctionInternal: Cannot open function: "
                         << bin_name_ << ". error code (WIN32): "<< GetLastError());
 
-  initPtr init = (initPtr)GetProcAddress(handle_, TEXT("init"));
-  if (init==0) throw CasadiException("ExternalFunctionInternal: no \"init\" found");
-  getSparsityPtr getSparsity = (getSparsityPtr)GetProcAddress(handle_, TEXT("getSparsity"));
-  if (getSparsity==0) throw CasadiException("ExternalFunctionInternal: no \"getSparsity\" found");
-  evaluate_ = (evaluatePtr) GetProcAddress(handle_, TEXT("evaluateWrap"));
-  if (evaluate_==0) throw CasadiException("ExternalFunctionInternal: no \"evaluateWrap\" found");
+  initPtr init = (initPtr)GetProcAddress(handle_, init_name.c_str());
+  if (init==0) throw CasadiException("ExternalFunctionInternal: no \"" + init_name + "\" found");
+  getSparsityPtr getSparsity = (getSparsityPtr)GetProcAddress(handle_, sparsity_name.c_str());
+  if (getSparsity==0) throw CasadiException("ExternalFunctionInternal: no \"" + sparsity_name
+                                            + "\" found");
+  evaluate_ = (evaluatePtr) GetProcAddress(handle_, evaluate_name.c_str());
+  if (evaluate_==0) throw CasadiException("ExternalFunctionInternal: no \"" + evaluate_name
+                                          + "\" found");
 
 #else // _WIN32
   handle_ = dlopen(bin_name_.c_str(), RTLD_LAZY);
@@ -60,15 +68,18 @@ ExternalFunctionInternal::ExternalFunctionInternal(const std::string& bin_name)
   dlerror();
 
   // Load symbols
-  initPtr init = (initPtr)dlsym(handle_, "init");
-  if (dlerror()) throw CasadiException("ExternalFunctionInternal: no \"init\" found. "
+  initPtr init = (initPtr)dlsym(handle_, init_name.c_str());
+  if (dlerror()) throw CasadiException("ExternalFunctionInternal: no \"" + init_name
+                                       + "\" found. "
                                        "Possible cause: If the function was generated from CasADi, "
                                        "make sure that it was compiled with a C compiler. If the "
                                        "function is C++, make sure to use extern \"C\" linkage.");
-  getSparsityPtr getSparsity = (getSparsityPtr)dlsym(handle_, "getSparsity");
-  if (dlerror()) throw CasadiException("ExternalFunctionInternal: no \"getSparsity\" found");
-  evaluate_ = (evaluatePtr) dlsym(handle_, "evaluateWrap");
-  if (dlerror()) throw CasadiException("ExternalFunctionInternal: no \"evaluateWrap\" found");
+  getSparsityPtr getSparsity = (getSparsityPtr)dlsym(handle_, sparsity_name.c_str());
+  if (dlerror()) throw CasadiException("ExternalFunctionInternal: no \"" + sparsity_name
+                                       + "\" found");
+  evaluate_ = (evaluatePtr) dlsym(handle_, evaluate_name.c_str());
+  if (dlerror()) throw CasadiException("ExternalFunctionInternal: no \"" + evaluate_name
+                                       + "\" found");
 #endif // _WIN32
 
   // Initialize and get the number of inputs and outputs
@@ -135,6 +146,31 @@ void ExternalFunctionInternal::evaluate() {
 #endif // WITH_DL
 }
 
+void ExternalFunctionInternal::evalD(const double** arg, double** res, FunctionMemory& mem) {
+#ifdef WITH_DL
+  // The generated code does not accept null inputs, pass zeros instead
+  size_t nzero = 0;
+  bool has_null = false;
+  for (int i=0; i<getNumInputs(); ++i) {
+    if (arg[i]==0) {
+      has_null = true;
+      nzero = std::max(nzero, static_cast<size_t>(input(i).size()));
+    }
+  }
+  if (has_null) {
+    mem.w.resize(nzero);
+    fill(mem.w.begin(), mem.w.end(), 0);
+    mem.arg_nz.resize(getNumInputs());
+    for (int i=0; i<getNumInputs(); ++i) {
+      mem.arg_nz[i] = arg[i]==0 ? getPtr(mem.w) : arg[i];
+    }
+    arg = getPtr(mem.arg_nz);
+  }
+  int flag = evaluate_(arg, res);
+  if (flag) throw CasadiException("ExternalFunctionInternal: \"evaluate\" failed");
+#endif // WITH_DL
+}
+
 void ExternalFunctionInternal::init() {
   // Call the init function of the base class
   FunctionInternal::init();
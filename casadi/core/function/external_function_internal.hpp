@@ -47,7 +47,8 @@ class CASADI_EXPORT ExternalFunctionInternal : public FunctionInternal {
   public:
 
     /** \brief  constructor */
-    explicit ExternalFunctionInternal(const std::string& bin_name);
+    explicit ExternalFunctionInternal(const std::string& bin_name,
+                                      const std::string& f_name="");
 
     /** \brief  clone function */
     virtual ExternalFunctionInternal* clone() const;
@@ -58,6 +59,9 @@ class CASADI_EXPORT ExternalFunctionInternal : public FunctionInternal {
     /** \brief  Evaluate */
     virtual void evaluate();
 
+    /** \brief  Evaluate with caller-owned arguments and results, without copying */
+    virtual void evalD(const double** arg, double** res, FunctionMemory& mem);
+
     /** \brief  Initialize */
     virtual void init();
 
@@ -73,6 +77,9 @@ class CASADI_EXPORT ExternalFunctionInternal : public FunctionInternal {
   /** \brief  Name of binary */
   std::string bin_name_;
 
+  /** \brief Prefix of the entry points, empty for a library with a single function */
+  std::string f_name_;
+
   /** \brief  Function pointers */
   evaluatePtr evaluate_;
 
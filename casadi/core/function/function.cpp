@@ -126,7 +126,34 @@ namespace casadi {
 
   void Function::evaluate() {
     assertInit();
-    (*this)->evaluate();
+    (*this)->evaluateJit();
+  }
+
+  void Function::evaluate(const double** arg, double** res, FunctionMemory& mem) {
+    assertInit();
+    if ((*this)->jit_) {
+      // Generated code is re-entrant, no memory needed
+      (*this)->jitFunction().evaluate(arg, res, mem);
+    } else {
+      (*this)->evalD(arg, res, mem);
+    }
+  }
+
+  FunctionMemory Function::allocMemory() const {
+    assertInit();
+    FunctionMemory mem;
+    if ((*this)->jit_) {
+      // Compile before any concurrent evaluation
+      const_cast<Function*>(this)->operator->()->jitFunction();
+    } else {
+      (*this)->allocMemory(mem);
+    }
+    return mem;
+  }
+
+  bool Function::isReentrant() const {
+    assertInit();
+    return (*this)->jit_ || (*this)->isReentrant();
   }
 
   int Function::getNumInputNonzeros() const {
@@ -283,6 +310,20 @@ namespace casadi {
     (*this)->generateCode(stream, generate_main);
   }
 
+  void Function::generateCodeSplit(const std::string& dirname, const std::string& basename,
+                                   int chunk_size) {
+    (*this)->generateCodeSplit(dirname, basename, chunk_size);
+  }
+
+  void Function::generateLibrary(const std::string& filename, const std::vector<Function>& f,
+                                 const std::vector<std::string>& names,
+                                 const std::string& fused) {
+    std::ofstream cfile(filename.c_str());
+    casadi_assert_message(cfile.good(), "Function::generateLibrary: Cannot open \""
+                          << filename << "\" for writing");
+    FunctionInternal::generateLibrary(cfile, f, names, fused);
+  }
+
   const IOScheme& Function::inputScheme() const {
     return (*this)->inputScheme();
   }
@@ -54,6 +54,38 @@ namespace casadi {
   /** Forward declaration of internal class */
   class FunctionInternal;
 
+#ifndef SWIG
+  /** \brief Memory for a re-entrant evaluation of a Function
+   *
+   * Holds everything that an evaluation writes to, so that a single Function can be
+   * evaluated concurrently from several threads, each with its own memory object.
+   * Allocate with Function::allocMemory and pass to Function::evaluate.
+   *
+   * \author Joel Andersson
+   * \date 2014
+   */
+  struct CASADI_EXPORT FunctionMemory {
+    /// Integer work vector
+    std::vector<int> iw;
+
+    /// Real work vector
+    std::vector<double> w;
+
+    /// Matrix-valued work vector
+    std::vector<DMatrix> work;
+
+    /// Pointers to the matrix-valued arguments and results of an operation
+    std::vector<DMatrix*> arg, res;
+
+    /// Pointers to the nonzeros of the arguments and results of an embedded function call
+    std::vector<const double*> arg_nz;
+    std::vector<double*> res_nz;
+
+    /// Memory for embedded function calls
+    std::vector<FunctionMemory> sub;
+  };
+#endif // SWIG
+
   /** \brief General function
 
       A general function \f$f\f$ in casadi can be multi-input, multi-output.\n
@@ -180,6 +212,25 @@ namespace casadi {
     /** \brief  Evaluate */
     void evaluate();
 
+/// \cond INTERNAL
+#ifndef SWIG
+    /** \brief  Evaluate with caller-owned arguments, results and memory
+     *
+     * arg[i] (res[i]) points to the nonzeros of input (output) i, or is null, in which case
+     * the input is taken to be zero (the output is not calculated). The inputs and outputs
+     * of the function object are not used. If isReentrant() returns true, concurrent calls
+     * are safe provided that they use different memory objects.
+     */
+    void evaluate(const double** arg, double** res, FunctionMemory& mem);
+
+    /** \brief  Allocate memory for a call to evaluate(arg, res, mem) */
+    FunctionMemory allocMemory() const;
+#endif // SWIG
+/// \endcond
+
+    /** \brief  Can the function be evaluated concurrently with different memory objects? */
+    bool isReentrant() const;
+
     ///@{
     /** \brief Generate a Jacobian function of output \a oind with respect to input \a iind
      * \param iind The index of the input
@@ -408,7 +459,13 @@ NOTE: Does _not_ take ownership, only weak references to the derivatives are kep
         setJacSparsity(sp, inputSchemeEntry(iind), outputSchemeEntry(oind), compact); }
     ///@}
 
-    /** \brief Export / Generate C code for the function */
+    /** \brief Export / Generate C code for the function
+     *
+     * With the option "codegen_batch", the code also gets the entry point
+     * evaluateBatch(n, x, r) for n instances, with nonzero k of instance j of input (output) i
+     * at x[i][k*n+j] (r[i][k*n+j]). This interleaved layout differs from the one of
+     * SXFunction::evaluateBatch, which stores one instance after the other.
+     */
     void generateCode(const std::string& filename, bool generate_main=false);
 
     /** \brief Generate C code for the function */
@@ -417,6 +474,29 @@ NOTE: Does _not_ take ownership, only weak references to the derivatives are kep
     /** \brief Generate C code for the function */
     void generateCode(std::ostream& filename, bool generate_main=false);
 
+    /** \brief Generate C code split into several files, for compiling very large functions
+     *
+     * Writes basename.c, a header basename.h, one file basename_chunkN.c for every chunk_size
+     * operations and a Makefile to dirname, which must exist. Running "make -j" in dirname
+     * compiles the files in parallel and links basename.so, which can be loaded with
+     * ExternalFunction. Functions that do not support splitting are written to a single file.
+     */
+    void generateCodeSplit(const std::string& dirname, const std::string& basename,
+                           int chunk_size=10000);
+
+    /** \brief Generate C code for several related functions in one file
+     *
+     * The entry points of f[k] are prefixed by names[k] + "_" and can be loaded with
+     * ExternalFunction(bin_name, names[k]). Sparsity patterns, constants and embedded
+     * functions are shared. If fused is not empty, an additional function with this name
+     * returns the outputs of all functions in order, with the inputs that are the same
+     * expression merged. It requires SXFunctions and evaluates their common subexpressions
+     * only once.
+     */
+    static void generateLibrary(const std::string& filename, const std::vector<Function>& f,
+                                const std::vector<std::string>& names,
+                                const std::string& fused="");
+
     /// \cond INTERNAL
     /** \brief  Access functions of the node */
     FunctionInternal* operator->();
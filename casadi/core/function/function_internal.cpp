@@ -28,6 +28,7 @@
 #include <typeinfo>
 #include "../std_vector_tools.hpp"
 #include "mx_function.hpp"
+#include "parallelizer.hpp"
 #include "../matrix/matrix_tools.hpp"
 #include "../sx/sx_tools.hpp"
 #include "../mx/mx_tools.hpp"
@@ -35,8 +36,11 @@
 
 #include "../casadi_options.hpp"
 #include "../profiling.hpp"
+#include "sparsity_cache.hpp"
+#include "jit_cache.hpp"
 
 #include <cctype>
+#include <fstream>
 #ifdef WITH_DL
 #include <cstdlib>
 #include <ctime>
@@ -69,6 +73,34 @@ namespace casadi {
               "Function that returns a derivative function given a number of forward "
               "and reverse directional derivative, overrides internal routines. "
               "Check documentation of DerivativeGenerator.");
+    addOption("jacobian_num_threads",     OT_INTEGER,             1,
+              "Number of threads used to evaluate the directional derivatives of a "
+              "Jacobian or Hessian calculated by calling derivative functions. "
+              "The color groups are split into (at least) this number of chunks.");
+    addOption("sparsity_width",           OT_INTEGER,             bvec_size,
+              "Number of directions propagated per sweep when generating Jacobian "
+              "sparsity patterns, rounded up to a multiple of the bit vector size. "
+              "Only used by functions that can propagate several bit vectors at once, "
+              "which then skip the hierarchical block structure recognition.");
+    addOption("sparsity_cache",           OT_STRING,              "",
+              "Directory where the sparsity patterns of Jacobian blocks and their "
+              "colorings are stored and reused between runs. Only used by functions "
+              "that can hash their algorithm. Defaults to CasadiOptions::getSparsityCacheDir().");
+    addOption("jit",                      OT_BOOLEAN,             false,
+              "Evaluate numerically with C code generated for the function and compiled "
+              "just in time, on the first evaluation. The compiled code is stored in "
+              "the directory \"jit_cache\" and reused if the same code is generated again.");
+    addOption("jit_compiler",             OT_STRING,              "gcc -fPIC -O2",
+              "Compiler command used for just-in-time compilation");
+    addOption("jit_cache",                OT_STRING,              "",
+              "Directory of the just-in-time compiled code. Defaults to "
+              "CasadiOptions::getJitCacheDir() or else to a cache directory of the user.");
+    addOption("codegen_batch",            OT_BOOLEAN,             false,
+              "Generated C code also gets an entry point evaluateBatch(n, x, r) that "
+              "evaluates n instances at once. Nonzero k of instance j of an input or output "
+              "is stored at position k*n+j, so the instances can be processed with SIMD "
+              "instructions. Note that SXFunction::evaluateBatch instead stores one instance "
+              "after the other.");
 
     verbose_ = false;
     user_data_ = 0;
@@ -80,6 +112,29 @@ namespace casadi {
   FunctionInternal::~FunctionInternal() {
   }
 
+  void FunctionInternal::evalD(const double** arg, double** res, FunctionMemory& mem) {
+    // Pass the inputs
+    for (int ind=0; ind<getNumInputs(); ++ind) {
+      vector<double>& v = input(ind).data();
+      if (arg[ind]==0) {
+        fill(v.begin(), v.end(), 0);
+      } else {
+        copy(arg[ind], arg[ind]+v.size(), v.begin());
+      }
+    }
+
+    // Evaluate
+    evaluateJit();
+
+    // Get the outputs
+    for (int ind=0; ind<getNumOutputs(); ++ind) {
+      if (res[ind]!=0) {
+        const vector<double>& v = output(ind).data();
+        copy(v.begin(), v.end(), res[ind]);
+      }
+    }
+  }
+
   void FunctionInternal::deepCopyMembers(
       std::map<SharedObjectNode*, SharedObject>& already_copied) {
     OptionsFunctionalityNode::deepCopyMembers(already_copied);
@@ -87,7 +142,9 @@ namespace casadi {
         i!=derivative_fcn_.end(); ++i) {
       for (vector<WeakRef>::iterator j=i->begin(); j!=i->end(); ++j) {
         if (!j->isNull()) {
-          *j = getcopy(j->shared(), already_copied);
+          // Derivatives that have not been copied are generated again when needed
+          SharedObject ref = getcopy(j->shared(), already_copied);
+          *j = ref.isNull() ? WeakRef() : WeakRef(ref);
         }
       }
     }
@@ -111,6 +168,18 @@ namespace casadi {
         SparseStorage<Sparsity>(Sparsity::sparse(getNumOutputs(), getNumInputs()));
     jac_ = jac_compact_ = SparseStorage<WeakRef>(Sparsity::sparse(getNumOutputs(), getNumInputs()));
 
+    // Directory of the sparsity cache
+    sparsity_cache_ = getOption("sparsity_cache").toString();
+    if (sparsity_cache_.empty()) sparsity_cache_ = CasadiOptions::getSparsityCacheDir();
+
+    // Just-in-time compilation, the code is generated and compiled when first needed
+    jit_ = getOption("jit");
+    jit_compiler_ = getOption("jit_compiler").toString();
+    jit_cache_ = getOption("jit_cache").toString();
+    if (jit_cache_.empty()) jit_cache_ = CasadiOptions::getJitCacheDir();
+    if (jit_cache_.empty()) jit_cache_ = JitCache::defaultDirectory();
+    jit_fcn_ = Function();
+
     if (hasSetOption("user_data")) {
       user_data_ = getOption("user_data").toVoidPointer();
     }
@@ -285,6 +354,7 @@ namespace casadi {
     f.setInputScheme(getInputScheme());
     f.setOutputScheme(getOutputScheme());
     f.setOption("ad_mode", getOption("ad_mode")); // Why?
+    f.setOption("jacobian_num_threads", getOption("jacobian_num_threads"));
     if (hasSetOption("derivative_generator"))
         f.setOption("derivative_generator", getOption("derivative_generator"));
 
@@ -298,6 +368,7 @@ namespace casadi {
     log("FunctionInternal::getHessian generating gradient");
     Function g = gradient(iind, oind);
     g.setOption("verbose", getOption("verbose"));
+    g.setOption("jacobian_num_threads", getOption("jacobian_num_threads"));
     g.setInputScheme(input_.scheme);
     g.init();
 
@@ -529,6 +600,126 @@ namespace casadi {
     return ret;
   }
 
+  Sparsity FunctionInternal::getJacSparsityWide(int iind, int oind, int nw) {
+    // Number of nonzero inputs
+    int nz_in = input(iind).size();
+
+    // Number of nonzero outputs
+    int nz_out = output(oind).size();
+
+    // Number of directions per sweep
+    int ndir = nw*bvec_size;
+
+    // Number of forward sweeps we must make
+    int nsweep_fwd = nz_in/ndir;
+    if (nz_in%ndir>0) nsweep_fwd++;
+
+    // Number of adjoint sweeps we must make
+    int nsweep_adj = nz_out/ndir;
+    if (nz_out%ndir>0) nsweep_adj++;
+
+    // Use forward mode?
+    bool use_fwd = spCanEvaluate(true) && nsweep_fwd <= nsweep_adj;
+
+    // Override default behavior?
+    if (getOption("ad_mode") == "forward") {
+      use_fwd = true;
+    } else if (getOption("ad_mode") == "reverse") {
+      use_fwd = false;
+    }
+
+    // Reset the virtual machine
+    spInit(use_fwd);
+
+    // Seeds and sensitivities, nw bit vectors per nonzero
+    vector<vector<bvec_t> > arg_v(getNumInputs()), res_v(getNumOutputs());
+    vector<bvec_t*> arg(getNumInputs()), res(getNumOutputs());
+    for (int ind=0; ind<getNumInputs(); ++ind) {
+      arg_v[ind].resize(nw*input(ind).size()+1, 0);
+      arg[ind] = &arg_v[ind].front();
+    }
+    for (int ind=0; ind<getNumOutputs(); ++ind) {
+      res_v[ind].resize(nw*output(ind).size()+1, 0);
+      res[ind] = &res_v[ind].front();
+    }
+    bvec_t* seed_v = use_fwd ? arg[iind] : res[oind];
+    bvec_t* sens_v = use_fwd ? res[oind] : arg[iind];
+
+    // Number of sweeps needed
+    int nsweep = use_fwd ? nsweep_fwd : nsweep_adj;
+
+    // The number of zeros in the seed and sensitivity directions
+    int nz_seed = use_fwd ? nz_in  : nz_out;
+    int nz_sens = use_fwd ? nz_out : nz_in;
+
+    // Print
+    if (verbose()) {
+      std::cout << "FunctionInternal::getJacSparsityWide: using "
+                << (use_fwd ? "forward" : "adjoint") << " mode: ";
+      std::cout << nsweep << " sweeps of " << ndir << " directions needed for "
+                << nz_seed << " directions" << endl;
+    }
+
+    // Temporary vectors
+    std::vector<int> jcol, jrow;
+
+    // Loop over the variables, ndir variables at a time
+    for (int s=0; s<nsweep; ++s) {
+
+      // Nonzero offset
+      int offset = s*ndir;
+
+      // Number of local seed directions
+      int ndir_local = std::min(ndir, nz_seed-offset);
+
+      // Direction i is bit i%bvec_size of bit vector i/bvec_size of nonzero offset+i
+      for (int i=0; i<ndir_local; ++i) {
+        seed_v[(offset+i)*nw + i/bvec_size] |= bvec_t(1) << (i%bvec_size);
+      }
+
+      // Propagate the dependencies
+      spEvaluateWide(use_fwd, nw, getPtr(arg), getPtr(res));
+
+      // Loop over the nonzeros of the output
+      for (int el=0; el<nz_sens; ++el) {
+        for (int w=0; w<nw; ++w) {
+          // Get the sparsity sensitivity
+          bvec_t spsens = sens_v[el*nw + w];
+
+          // If there is a dependency in any of the directions
+          if (0==spsens) continue;
+
+          // Loop over seed directions
+          for (int i=0; i<bvec_size; ++i) {
+            if ((bvec_t(1) << i) & spsens) {
+              // Add to pattern
+              jcol.push_back(el);
+              jrow.push_back(offset + w*bvec_size + i);
+            }
+          }
+        }
+      }
+
+      // Remove the seeds and clear the adjoint sensitivities for the next sweep
+      fill_n(seed_v + offset*nw, ndir_local*nw, bvec_t(0));
+      if (!use_fwd) {
+        for (int ind=0; ind<getNumInputs(); ++ind) {
+          fill(arg_v[ind].begin(), arg_v[ind].end(), bvec_t(0));
+        }
+      }
+    }
+
+    // Construct sparsity pattern
+    Sparsity ret = Sparsity::triplet(nz_out, nz_in, use_fwd ? jcol : jrow, use_fwd ? jrow : jcol);
+
+    casadi_log("Formed Jacobian sparsity pattern (dimension " << ret.shape() << ", "
+               << ret.size() << " nonzeros, " << (100.0*ret.size())/ret.numel() << " % nonzeros).");
+    casadi_log("FunctionInternal::getJacSparsityWide end ");
+
+    // Return sparsity pattern
+    return ret;
+  }
+
   Sparsity FunctionInternal::getJacSparsityHierarchicalSymm(int iind, int oind) {
     casadi_assert(spCanEvaluate(true));
 
@@ -1065,6 +1256,15 @@ namespace casadi {
   }
 
   Sparsity FunctionInternal::getJacSparsity(int iind, int oind, bool symmetric) {
+    // Propagate several bit vectors per sweep if requested and supported
+    int nw = (static_cast<int>(getOption("sparsity_width"))+bvec_size-1)/bvec_size;
+    if (nw>1 && spCanEvaluateWide(true) && spCanEvaluateWide(false)) {
+      // No more bit vectors than needed for the smaller dimension
+      int nz_min = std::min(input(iind).size(), output(oind).size());
+      nw = std::max(1, std::min(nw, (nz_min+bvec_size-1)/bvec_size));
+      return getJacSparsityWide(iind, oind, nw);
+    }
+
     // Check if we are able to propagate dependencies through the function
     if (spCanEvaluate(true) || spCanEvaluate(false)) {
 
@@ -1104,8 +1304,25 @@ namespace casadi {
     if (jsp.isNull()) {
       if (compact) {
 
-        // Use internal routine to determine sparsity
-        jsp = getJacSparsity(iind, oind, symmetric);
+        // Try to read the sparsity pattern from the on-disk cache
+        size_t key, check;
+        vector<Sparsity> ref, cached;
+        bool use_cache = sparsityCacheKey(key, check, ref, iind, oind, true, symmetric, false);
+        if (use_cache && SparsityCache::load(sparsity_cache_, key, check, ref, cached)
+            && cached.size()==1
+            && (cached[0].isNull() || (cached[0].size1()==output(oind).size()
+                                       && cached[0].size2()==input(iind).size()))) {
+          log("FunctionInternal::jacSparsity", "read from the sparsity cache");
+          jsp = cached[0];
+        } else {
+          // Use internal routine to determine sparsity
+          jsp = getJacSparsity(iind, oind, symmetric);
+
+          // Store in the cache
+          if (use_cache) {
+            SparsityCache::save(sparsity_cache_, key, check, ref, vector<Sparsity>(1, jsp));
+          }
+        }
 
       } else {
 
@@ -1157,6 +1374,21 @@ namespace casadi {
 
     // Sparsity pattern with transpose
     Sparsity &AT = jacSparsity(iind, oind, compact, symmetric);
+
+    // Try to read the seed matrices from the on-disk cache
+    size_t key, check;
+    vector<Sparsity> ref, cached;
+    bool use_cache = sparsityCacheKey(key, check, ref, iind, oind, compact, symmetric, true);
+    if (use_cache && SparsityCache::load(sparsity_cache_, key, check, ref, cached)
+        && cached.size()==2
+        && (cached[0].isNull() || cached[0].size1()==AT.size2())
+        && (cached[1].isNull() || cached[1].size1()==AT.size1())) {
+      log("FunctionInternal::getPartition", "read from the sparsity cache");
+      D1 = cached[0];
+      D2 = cached[1];
+      return;
+    }
+
     Sparsity A = symmetric ? AT : AT.T();
 
     // Which AD mode?
@@ -1232,9 +1464,60 @@ namespace casadi {
       }
 
     }
+
+    // Store in the cache
+    if (use_cache) {
+      vector<Sparsity> sp(2);
+      sp[0] = D1;
+      sp[1] = D2;
+      SparsityCache::save(sparsity_cache_, key, check, ref, sp);
+    }
     log("FunctionInternal::getPartition end");
   }
 
+  bool FunctionInternal::sparsityCacheKey(size_t& key, size_t& check, vector<Sparsity>& ref,
+                                          int iind, int oind, bool compact, bool symmetric,
+                                          bool coloring) {
+    if (sparsity_cache_.empty()) return false;
+
+    // The key names the file and the check value is verified on loading. Both hash the same
+    // data, but starting from different seeds, so a collision of the keys alone is detected.
+    size_t h[2] = {0, 0x9e3779b9};
+    for (int k=0; k<2; ++k) {
+      // Structure of the algorithm
+      if (!structuralHash(h[k])) return false;
+
+      // Sparsity of the inputs and outputs
+      hash_combine(h[k], getNumInputs());
+      for (int i=0; i<getNumInputs(); ++i) hash_combine(h[k], input(i).sparsity().hash());
+      hash_combine(h[k], getNumOutputs());
+      for (int i=0; i<getNumOutputs(); ++i) hash_combine(h[k], output(i).sparsity().hash());
+
+      // Requested block
+      hash_combine(h[k], iind);
+      hash_combine(h[k], oind);
+      hash_combine(h[k], symmetric);
+      hash_combine(h[k], coloring);
+
+      // The coloring also depends on the pattern format and the allowed AD modes
+      if (coloring) {
+        hash_combine(h[k], compact);
+        string ad_mode = getOption("ad_mode").toString();
+        for (string::const_iterator c=ad_mode.begin(); c!=ad_mode.end(); ++c) {
+          hash_combine(h[k], *c);
+        }
+      }
+    }
+    key = h[0];
+    check = h[1];
+
+    // The input and output sparsities are stored in the entry and compared exactly
+    ref.clear();
+    for (int i=0; i<getNumInputs(); ++i) ref.push_back(input(i).sparsity());
+    for (int i=0; i<getNumOutputs(); ++i) ref.push_back(output(i).sparsity());
+    return true;
+  }
+
   void FunctionInternal::evalSX(const std::vector<SX>& arg, std::vector<SX>& res,
                                 const std::vector<std::vector<SX> >& fseed,
                                 std::vector<std::vector<SX> >& fsens,
@@ -1439,6 +1722,44 @@ namespace casadi {
     }
   }
 
+  void FunctionInternal::spEvaluateWide(bool fwd, int nw, bvec_t** arg, bvec_t** res) {
+    // Propagate one bit vector at a time, passing it via the input and output buffers
+    for (int w=0; w<nw; ++w) {
+      for (int ind=0; ind<getNumInputs(); ++ind) {
+        vector<double> &v = inputNoCheck(ind).data();
+        if (v.empty()) continue;
+        bvec_t* vb = get_bvec_t(v);
+        for (int k=0; k<v.size(); ++k) vb[k] = fwd ? arg[ind][k*nw+w] : 0;
+      }
+      for (int ind=0; ind<getNumOutputs(); ++ind) {
+        vector<double> &v = outputNoCheck(ind).data();
+        if (v.empty()) continue;
+        bvec_t* vb = get_bvec_t(v);
+        for (int k=0; k<v.size(); ++k) vb[k] = fwd ? 0 : res[ind][k*nw+w];
+      }
+      spEvaluate(fwd);
+      if (fwd) {
+        for (int ind=0; ind<getNumOutputs(); ++ind) {
+          vector<double> &v = outputNoCheck(ind).data();
+          if (v.empty()) continue;
+          const bvec_t* vb = get_bvec_t(v);
+          for (int k=0; k<v.size(); ++k) res[ind][k*nw+w] = vb[k];
+        }
+      } else {
+        for (int ind=0; ind<getNumInputs(); ++ind) {
+          vector<double> &v = inputNoCheck(ind).data();
+          if (v.empty()) continue;
+          const bvec_t* vb = get_bvec_t(v);
+          for (int k=0; k<v.size(); ++k) arg[ind][k*nw+w] |= vb[k];
+        }
+      }
+    }
+
+    // Leave the buffers cleared
+    for (int ind=0; ind<getNumInputs(); ++ind) input(ind).setZero();
+    for (int ind=0; ind<getNumOutputs(); ++ind) output(ind).setZero();
+  }
+
   void FunctionInternal::spEvaluateViaJacSparsity(bool fwd) {
     if (fwd) {
       // Clear the outputs
@@ -1850,6 +2171,103 @@ namespace casadi {
     return ret;
   }
 
+  Function FunctionInternal::getDerivativeBatch(int nfwd, int nadj) {
+    return getDerivative(nfwd, nadj);
+  }
+
+  Function FunctionInternal::getParallelDerivative(int nfwd, int nadj, int num_threads) {
+    casadi_assert_message(num_threads>=1, "Number of threads must be positive");
+
+    // Number of inputs and outputs
+    const int n_in = getNumInputs();
+    const int n_out = getNumOutputs();
+
+    // Split the forward directions into batches of (nearly) equal size
+    int max_nfwd = (nfwd+num_threads-1)/num_threads;
+    vector<int> batch_nfwd, batch_nadj;
+    for (int offset=0; offset<nfwd; offset+=max_nfwd) {
+      batch_nfwd.push_back(std::min(max_nfwd, nfwd-offset));
+      batch_nadj.push_back(0);
+    }
+
+    // The adjoint directions form one additional batch
+    if (nadj>0 || nfwd==0) {
+      batch_nfwd.push_back(0);
+      batch_nadj.push_back(nadj);
+    }
+    const int nbatch = batch_nfwd.size();
+
+    // Derivative function of each batch, only generated once for each batch size
+    map<pair<int, int>, Function> batch_fcn;
+    vector<Function> fcns(nbatch);
+    for (int b=0; b<nbatch; ++b) {
+      Function& f = batch_fcn[make_pair(batch_nfwd[b], batch_nadj[b])];
+      if (f.isNull()) f = getDerivativeBatch(batch_nfwd[b], batch_nadj[b]);
+      fcns[b] = f;
+    }
+
+    // Evaluate the batches in parallel, functions used more than once are copied if needed
+    Parallelizer par(fcns);
+    par.setOption("parallelization", "threadpool");
+    par.setOption("num_threads", num_threads);
+    par.init();
+
+    // Nondifferentiated inputs and the seeds
+    vector<MX> arg = symbolicInput();
+    vector<MX> fseed, aseed;
+    stringstream ss;
+    for (int dir=0; dir<nfwd; ++dir) {
+      for (int i=0; i<n_in; ++i) {
+        ss.str("");
+        ss << "fwd" << dir << "_" << arg[i];
+        fseed.push_back(MX::sym(ss.str(), arg[i].sparsity()));
+      }
+    }
+    for (int dir=0; dir<nadj; ++dir) {
+      for (int i=0; i<n_out; ++i) {
+        ss.str("");
+        ss << "adj" << dir << "_" << i;
+        aseed.push_back(MX::sym(ss.str(), output(i).sparsity()));
+      }
+    }
+
+    // Arguments of the batches
+    vector<MX> par_arg;
+    vector<MX>::const_iterator fseed_it = fseed.begin(), aseed_it = aseed.begin();
+    for (int b=0; b<nbatch; ++b) {
+      par_arg.insert(par_arg.end(), arg.begin(), arg.end());
+      par_arg.insert(par_arg.end(), fseed_it, fseed_it+n_in*batch_nfwd[b]);
+      fseed_it += n_in*batch_nfwd[b];
+      par_arg.insert(par_arg.end(), aseed_it, aseed_it+n_out*batch_nadj[b]);
+      aseed_it += n_out*batch_nadj[b];
+    }
+    vector<MX> par_res = par.call(par_arg);
+
+    // Nondifferentiated outputs are taken from the first batch
+    vector<MX> res(par_res.begin(), par_res.begin()+n_out);
+    res.reserve(n_out*(1+nfwd)+n_in*nadj);
+
+    // Collect the forward sensitivities, then the adjoint sensitivities
+    vector<MX> asens;
+    vector<MX>::const_iterator res_it = par_res.begin();
+    for (int b=0; b<nbatch; ++b) {
+      res_it += n_out;
+      res.insert(res.end(), res_it, res_it+n_out*batch_nfwd[b]);
+      res_it += n_out*batch_nfwd[b];
+      asens.insert(asens.end(), res_it, res_it+n_in*batch_nadj[b]);
+      res_it += n_in*batch_nadj[b];
+    }
+    res.insert(res.end(), asens.begin(), asens.end());
+
+    // Inputs of the derivative function
+    arg.insert(arg.end(), fseed.begin(), fseed.end());
+    arg.insert(arg.end(), aseed.begin(), aseed.end());
+
+    // Assemble the derivative function
+    MXFunction ret(arg, res);
+    return ret;
+  }
+
   int FunctionInternal::getNumInputNonzeros() const {
     int ret=0;
     for (int iind=0; iind<getNumInputs(); ++iind) {
@@ -2113,28 +2531,10 @@ namespace casadi {
     gen.flush(cfile);
 
     // Define wrapper function
-    cfile << "int evaluateWrap(const d** x, d** r) {" << std::endl;
-    cfile << "  evaluate(";
-
-    // Number of inputs/outputs
-    int n_i = input_.data.size();
-    int n_o = output_.data.size();
+    generateEvaluateWrap(cfile);
 
-    // Pass inputs
-    for (int i=0; i<n_i; ++i) {
-      if (i!=0) cfile << ", ";
-      cfile << "x[" << i << "]";
-    }
-
-    // Pass outputs
-    for (int i=0; i<n_o; ++i) {
-      if (i+n_i!= 0) cfile << ", ";
-      cfile << "r[" << i << "]";
-    }
-
-    cfile << "); " << std::endl;
-    cfile << "  return 0;" << std::endl;
-    cfile << "}" << std::endl << std::endl;
+    // Entry point evaluating several instances
+    if (getOption("codegen_batch")) generateEvaluateBatch(cfile, gen);
 
     // Create a main for debugging and profiling: TODO: Cleanup and expose to user, see #617
     if (generate_main) {
@@ -2198,6 +2598,292 @@ namespace casadi {
     }
   }
 
+  void FunctionInternal::generateLibrary(std::ostream &cfile, const std::vector<Function>& f,
+                                         const std::vector<std::string>& names,
+                                         const std::string& fused) {
+    casadi_assert_message(f.size()==names.size(), "FunctionInternal::generateLibrary: "
+                          "Got " << f.size() << " functions but " << names.size() << " names");
+
+    // Functions to be generated and the prefixes of their entry points
+    vector<Function> fcns = f;
+    vector<string> all_names = names;
+    if (!fused.empty()) all_names.push_back(fused);
+    for (vector<string>::const_iterator it=all_names.begin(); it!=all_names.end(); ++it) {
+      bool valid = !it->empty() && !isdigit(static_cast<unsigned char>((*it)[0]));
+      for (string::const_iterator c=it->begin(); c!=it->end(); ++c) {
+        valid = valid && (isalnum(static_cast<unsigned char>(*c)) || *c=='_');
+      }
+      casadi_assert_message(valid, "FunctionInternal::generateLibrary: \"" << *it
+                            << "\" is not a valid C identifier");
+      casadi_assert_message(std::count(all_names.begin(), all_names.end(), *it)==1,
+                            "FunctionInternal::generateLibrary: Duplicate name \"" << *it << "\"");
+    }
+    for (int k=0; k<f.size(); ++k) f[k].assertInit();
+
+    // Combine the SXFunctions into one, inputs that are the same expression are merged
+    if (!fused.empty()) {
+      vector<SX> fused_in, fused_out;
+      for (int k=0; k<f.size(); ++k) {
+        casadi_assert_message(SXFunction::testCast(f[k].get()),
+                              "FunctionInternal::generateLibrary: Only SXFunctions can be fused, "
+                              "but \"" << names[k] << "\" is not");
+        SXFunction fk = shared_cast<SXFunction>(f[k]);
+        for (int i=0; i<fk.getNumInputs(); ++i) {
+          const SX& in = fk.inputExpr(i);
+          bool found = false;
+          for (vector<SX>::const_iterator it=fused_in.begin(); !found && it!=fused_in.end(); ++it) {
+            found = it->sparsity()==in.sparsity();
+            for (int el=0; found && el<in.size(); ++el) {
+              found = it->at(el).get()==in.at(el).get();
+            }
+          }
+          if (!found) fused_in.push_back(in);
+        }
+        fused_out.insert(fused_out.end(), fk.outputExpr().begin(), fk.outputExpr().end());
+      }
+      SXFunction fused_fcn(fused_in, fused_out);
+      fused_fcn.setOption("name", fused);
+      fused_fcn.init();
+      fcns.push_back(fused_fcn);
+    }
+
+    // set stream parameters
+    cfile.precision(std::numeric_limits<double>::digits10+2);
+    cfile << std::scientific;
+    cfile << "/* This function was automatically generated by CasADi */" << std::endl;
+
+    // All functions share the auxiliaries, sparsity patterns, constants and dependencies
+    CodeGenerator gen;
+    gen.addInclude("math.h");
+    for (int k=0; k<fcns.size(); ++k) {
+      string prefix = all_names[k] + "_";
+      fcns[k]->generateIO(gen, prefix);
+      fcns[k]->generateFunction(gen.function_, prefix + "evaluate", "const d*", "d*", "d", gen);
+    }
+    gen.flush(cfile);
+
+    // Entry points
+    for (int k=0; k<fcns.size(); ++k) {
+      string prefix = all_names[k] + "_";
+      fcns[k]->generateEvaluateWrap(cfile, prefix);
+      if (fcns[k].getOption("codegen_batch")) {
+        fcns[k]->generateEvaluateBatch(cfile, gen, prefix);
+      }
+    }
+  }
+
+  void FunctionInternal::generateEvaluateWrap(std::ostream &cfile,
+                                              const std::string& prefix) const {
+    cfile << "int " << prefix << "evaluateWrap(const d** x, d** r) {" << std::endl;
+    cfile << "  " << prefix << "evaluate(";
+
+    // Number of inputs/outputs
+    int n_i = input_.data.size();
+    int n_o = output_.data.size();
+
+    // Pass inputs
+    for (int i=0; i<n_i; ++i) {
+      if (i!=0) cfile << ", ";
+      cfile << "x[" << i << "]";
+    }
+
+    // Pass outputs
+    for (int i=0; i<n_o; ++i) {
+      if (i+n_i!= 0) cfile << ", ";
+      cfile << "r[" << i << "]";
+    }
+
+    cfile << "); " << std::endl;
+    cfile << "  return 0;" << std::endl;
+    cfile << "}" << std::endl << std::endl;
+  }
+
+  void FunctionInternal::generateEvaluateBatch(std::ostream &cfile, CodeGenerator& gen,
+                                               const std::string& prefix) const {
+    cfile << "/* Nonzero k of instance j of x[i] and r[i] at position k*n+j */" << std::endl;
+    cfile << "int " << prefix << "evaluateBatch(int n, const d** x, d** r) {" << std::endl;
+    generateBatchLoop(cfile, "  ", prefix);
+    cfile << "  return 0;" << std::endl;
+    cfile << "}" << std::endl << std::endl;
+  }
+
+  void FunctionInternal::generateBatchLoop(std::ostream &cfile, const std::string& indent,
+                                           const std::string& prefix) const {
+    int n_in = getNumInputs();
+    int n_out = getNumOutputs();
+
+    // Evaluate the instances one by one, transposing the data to and from buffers
+    cfile << indent << "int i, j;" << std::endl;
+    for (int i=0; i<n_in; ++i) {
+      cfile << indent << "d t_x" << i << "[" << std::max(input(i).size(), 1) << "];"
+            << std::endl;
+    }
+    for (int i=0; i<n_out; ++i) {
+      cfile << indent << "d t_r" << i << "[" << std::max(output(i).size(), 1) << "];"
+            << std::endl;
+    }
+    cfile << indent << "for (j=0; j<n; ++j) {" << std::endl;
+    for (int i=0; i<n_in; ++i) {
+      cfile << indent << "  for (i=0; i<" << input(i).size() << "; ++i) t_x" << i
+            << "[i] = x[" << i << "][i*n+j];" << std::endl;
+    }
+    cfile << indent << "  " << prefix << "evaluate(";
+    for (int i=0; i<n_in; ++i) {
+      cfile << "t_x" << i;
+      if (i+1<n_in+n_out) cfile << ", ";
+    }
+    for (int i=0; i<n_out; ++i) {
+      cfile << "r[" << i << "] ? t_r" << i << " : 0";
+      if (i+1<n_out) cfile << ", ";
+    }
+    cfile << ");" << std::endl;
+    for (int i=0; i<n_out; ++i) {
+      cfile << indent << "  if (r[" << i << "]) for (i=0; i<" << output(i).size()
+            << "; ++i) r[" << i << "][i*n+j] = t_r" << i << "[i];" << std::endl;
+    }
+    cfile << indent << "}" << std::endl;
+  }
+
+  void FunctionInternal::generateCodeSplit(const std::string& dirname,
+                                           const std::string& basename, int chunk_size) {
+    assertInit();
+    casadi_assert_message(chunk_size>0, "FunctionInternal::generateCodeSplit: "
+                          "chunk_size must be positive, got " << chunk_size);
+
+    // Files to be compiled
+    string prefix = dirname.empty() ? basename : dirname + "/" + basename;
+    vector<string> sources(1, basename + ".c");
+
+    // Create a code generator object, the auxiliaries will be shared by all files
+    CodeGenerator gen;
+    gen.static_auxiliaries_ = true;
+    gen.addInclude("math.h");
+
+    // Try to split the function body into chunks
+    vector<string> chunks;
+    int worksize = 0;
+    if (!generateChunks(chunks, worksize, chunk_size, "d", gen)) {
+      // Not supported, generate a single file
+      std::ofstream cfile((prefix + ".c").c_str());
+      casadi_assert_message(cfile.good(), "FunctionInternal::generateCodeSplit: "
+                            "Cannot open \"" << prefix << ".c\" for writing");
+      generateCode(cfile, false);
+    } else {
+      int n_in = getNumInputs();
+      int n_out = getNumOutputs();
+      bool heap_work = worksize > 4096;
+      if (heap_work) gen.addInclude("stdlib.h");
+
+      // Signature of the chunk functions
+      stringstream args;
+      args << "(d* w";
+      for (int i=0; i<n_in; ++i) args << ", const d* x" << i;
+      for (int i=0; i<n_out; ++i) args << ", d* r" << i;
+      args << ")";
+
+      // Arguments when calling the chunk functions
+      stringstream call;
+      call << "(w";
+      for (int i=0; i<n_in; ++i) call << ", x" << i;
+      for (int i=0; i<n_out; ++i) call << ", r" << i;
+      call << ");";
+
+      // Names of the chunk functions
+      vector<string> chunk_names(chunks.size());
+      for (int k=0; k<chunks.size(); ++k) {
+        chunk_names[k] = basename + "_chunk" + CodeGenerator::numToString(k);
+      }
+
+      // Header shared by all files
+      std::ofstream hfile((prefix + ".h").c_str());
+      casadi_assert_message(hfile.good(), "FunctionInternal::generateCodeSplit: "
+                            "Cannot open \"" << prefix << ".h\" for writing");
+      hfile.precision(std::numeric_limits<double>::digits10+2);
+      hfile << std::scientific;
+      hfile << "/* This function was automatically generated by CasADi */" << std::endl;
+      gen.flushHeader(hfile);
+      for (int k=0; k<chunks.size(); ++k) {
+        hfile << "void " << chunk_names[k] << args.str() << ";" << std::endl;
+      }
+      hfile << std::endl;
+      hfile.close();
+
+      // One file for each chunk
+      for (int k=0; k<chunks.size(); ++k) {
+        sources.push_back(chunk_names[k] + ".c");
+        std::ofstream cfile((dirname.empty() ? sources.back() :
+                             dirname + "/" + sources.back()).c_str());
+        casadi_assert_message(cfile.good(), "FunctionInternal::generateCodeSplit: "
+                              "Cannot open \"" << sources.back() << "\" for writing");
+        cfile << "/* This function was automatically generated by CasADi */" << std::endl;
+        cfile << "#include \"" << basename << ".h\"" << std::endl << std::endl;
+        cfile << "void " << chunk_names[k] << args.str() << " {" << std::endl;
+        cfile << chunks[k];
+        cfile << "}" << std::endl;
+      }
+
+      // Main file with the input/output information and the entry points
+      std::ofstream cfile((prefix + ".c").c_str());
+      casadi_assert_message(cfile.good(), "FunctionInternal::generateCodeSplit: "
+                            "Cannot open \"" << prefix << ".c\" for writing");
+      cfile << "/* This function was automatically generated by CasADi */" << std::endl;
+      cfile << "#include \"" << basename << ".h\"" << std::endl << std::endl;
+      generateIO(gen);
+      gen.flushBody(cfile);
+
+      // Evaluate the chunks in sequence
+      cfile << "/* " << getSanitizedName() << " */" << std::endl;
+      cfile << "void evaluate(";
+      for (int i=0; i<n_in; ++i) {
+        cfile << "const d* x" << i;
+        if (i+1<n_in+n_out) cfile << ", ";
+      }
+      for (int i=0; i<n_out; ++i) {
+        cfile << "d* r" << i;
+        if (i+1<n_out) cfile << ", ";
+      }
+      cfile << ") {" << std::endl;
+      if (heap_work) {
+        cfile << "  d* w = (d*)malloc(" << worksize << "*sizeof(d));" << std::endl;
+      } else {
+        cfile << "  d w[" << std::max(worksize, 1) << "];" << std::endl;
+      }
+      for (int k=0; k<chunks.size(); ++k) {
+        cfile << "  " << chunk_names[k] << call.str() << std::endl;
+      }
+      if (heap_work) cfile << "  free(w);" << std::endl;
+      cfile << "}" << std::endl << std::endl;
+      generateEvaluateWrap(cfile);
+
+      // Entry point evaluating several instances, calling the chunked evaluate
+      if (getOption("codegen_batch")) FunctionInternal::generateEvaluateBatch(cfile, gen);
+    }
+
+    // Makefile compiling the files in parallel with "make -j"
+    std::ofstream mfile((dirname.empty() ? string("Makefile") : dirname + "/Makefile").c_str());
+    casadi_assert_message(mfile.good(), "FunctionInternal::generateCodeSplit: "
+                          "Cannot open Makefile for writing");
+    mfile << "# This file was automatically generated by CasADi" << std::endl;
+    mfile << "CFLAGS = -fPIC -O2" << std::endl;
+#ifdef __APPLE__
+    mfile << "LDFLAGS = -dynamiclib" << std::endl;
+#else // __APPLE__
+    mfile << "LDFLAGS = -shared" << std::endl;
+#endif // __APPLE__
+    mfile << "OBJECTS =";
+    for (int k=0; k<sources.size(); ++k) {
+      mfile << " " << sources[k].substr(0, sources[k].size()-2) << ".o";
+    }
+    mfile << std::endl << std::endl;
+    mfile << basename << ".so: $(OBJECTS)" << std::endl;
+    mfile << "\t$(CC) $(LDFLAGS) -o $@ $(OBJECTS) -lm" << std::endl << std::endl;
+    mfile << "%.o: %.c " << (sources.size()>1 ? basename + ".h" : string()) << std::endl;
+    mfile << "\t$(CC) $(CFLAGS) -c -o $@ $<" << std::endl << std::endl;
+    mfile << "clean:" << std::endl;
+    mfile << "\trm -f " << basename << ".so $(OBJECTS)" << std::endl << std::endl;
+    mfile << ".PHONY: clean" << std::endl;
+  }
+
   void FunctionInternal::generateFunction(
       std::ostream &stream, const std::string& fname, const std::string& input_type,
       const std::string& output_type, const std::string& type, CodeGenerator& gen) const {
@@ -2247,7 +2933,13 @@ namespace casadi {
                  << typeid(*this).name());
   }
 
-  void FunctionInternal::generateIO(CodeGenerator& gen) {
+  bool FunctionInternal::generateChunks(std::vector<std::string>& chunks, int& worksize,
+                                        int chunk_size, const std::string& type,
+                                        CodeGenerator& gen) const {
+    return false;
+  }
+
+  void FunctionInternal::generateIO(CodeGenerator& gen, const std::string& prefix) {
     // Short-hands
     int n_i = input_.data.size();
     int n_o = output_.data.size();
@@ -2255,7 +2947,7 @@ namespace casadi {
     stringstream &s = gen.function_;
 
     // Function that returns the number of inputs and outputs
-    s << "int init(int *n_in, int *n_out) {" << endl;
+    s << "int " << prefix << "init(int *n_in, int *n_out) {" << endl;
     s << "  *n_in = " << n_i << ";" << endl;
     s << "  *n_out = " << n_o << ";" << endl;
     s << "  return 0;" << endl;
@@ -2282,7 +2974,8 @@ namespace casadi {
     }
 
     // Function that returns the sparsity pattern
-    s << "int getSparsity(int i, int *nrow, int *ncol, int **colind, int **row) {" << endl;
+    s << "int " << prefix << "getSparsity(int i, int *nrow, int *ncol, int **colind, int **row) {"
+      << endl;
 
     // Get the sparsity index using a switch
     s << "  int* sp;" << endl;
@@ -2320,50 +3013,22 @@ namespace casadi {
   Function FunctionInternal::dynamicCompilation(Function f, std::string fname, std::string fdescr,
                                                 std::string compiler) {
 #ifdef WITH_DL
-
-    // Flag to get a DLL
-#ifdef __APPLE__
-    string dlflag = " -dynamiclib";
-#else // __APPLE__
-    string dlflag = " -shared";
-#endif // __APPLE__
-
     // Check if f is initialized
     bool f_is_init = f.isInit();
     if (!f_is_init) f.init();
 
-    // Filenames
-    string cname = fname + ".c";
-    string dlname = fname + ".so";
-
-    // Remove existing files, if any
-    string rm_command = "rm -rf " + cname + " " + dlname;
-    int flag = system(rm_command.c_str());
-    casadi_assert_message(flag==0, "Failed to remove old source");
-
     // Codegen it
-    f.generateCode(cname);
+    stringstream cfile;
+    f.generateCode(cfile);
     if (verbose_) {
-      cout << "Generated c-code for " << fdescr << " (" << cname << ")" << endl;
+      cout << "Generated c-code for " << fdescr << endl;
     }
 
-    // Compile it
-    string compile_command = compiler + " " + dlflag + " " + cname + " -o " + dlname;
-    if (verbose_) {
-      cout << "Compiling " << fdescr <<  " using \"" << compile_command << "\"" << endl;
-    }
-
-    time_t time1 = time(0);
-    flag = system(compile_command.c_str());
-    time_t time2 = time(0);
-    double comp_time = difftime(time2, time1);
-    casadi_assert_message(flag==0, "Compilation failed");
-    if (verbose_) {
-      cout << "Compiled " << fdescr << " (" << dlname << ") in " << comp_time << " s."  << endl;
-    }
+    // Compile it, unless it is in the cache
+    string dlname = JitCache::compile(cfile.str(), compiler, jit_cache_, verbose_);
 
     // Load it
-    ExternalFunction f_gen("./" + dlname);
+    ExternalFunction f_gen(dlname);
     f_gen.setOption("name", fname + "_gen");
 
     // Initialize it if f was initialized
@@ -2380,6 +3045,42 @@ namespace casadi {
 #endif // WITH_DL
   }
 
+  Function& FunctionInternal::jitFunction() {
+    if (jit_fcn_.isNull()) {
+#ifdef WITH_DL
+      // Generate code
+      stringstream cfile;
+      generateCode(cfile, false);
+
+      // Compile it, unless it is in the cache, and load it
+      string dlname = JitCache::compile(cfile.str(), jit_compiler_, jit_cache_, verbose());
+      ExternalFunction f(dlname);
+      f.setOption("name", getOption("name").toString() + "_jit");
+      f.init();
+      jit_fcn_ = f;
+#else // WITH_DL
+      casadi_error("Just-in-time compilation requires CasADi to be compiled "
+                   "with option \"WITH_DL\" enabled");
+#endif // WITH_DL
+    }
+    return jit_fcn_;
+  }
+
+  void FunctionInternal::evaluateJit() {
+    if (!jit_) {
+      evaluate();
+      return;
+    }
+
+    // Evaluate the compiled code directly on the inputs and outputs
+    Function& f = jitFunction();
+    jit_arg_.resize(getNumInputs());
+    for (int ind=0; ind<jit_arg_.size(); ++ind) jit_arg_[ind] = getPtr(input(ind).data());
+    jit_res_.resize(getNumOutputs());
+    for (int ind=0; ind<jit_res_.size(); ++ind) jit_res_[ind] = getPtr(output(ind).data());
+    f.evaluate(getPtr(jit_arg_), getPtr(jit_res_), jit_mem_);
+  }
+
   void FunctionInternal::createCall(const std::vector<MX> &arg,
                           std::vector<MX> &res, const std::vector<std::vector<MX> > &fseed,
                           std::vector<std::vector<MX> > &fsens,
@@ -2699,7 +3400,7 @@ namespace casadi {
     }
 
     // Evaluate
-    evaluate();
+    evaluateJit();
     if (CasadiOptions::profiling) {
       time_offset += getRealTime() - time_zero;
     }
@@ -68,6 +68,19 @@ namespace casadi {
     /** \brief  Evaluate */
     virtual void evaluate() = 0;
 
+    /** \brief  Evaluate with caller-owned arguments, results and memory
+     *
+     * The default implementation passes through the inputs and outputs of the class
+     * and is therefore not re-entrant.
+     */
+    virtual void evalD(const double** arg, double** res, FunctionMemory& mem);
+
+    /** \brief  Allocate memory for evalD */
+    virtual void allocMemory(FunctionMemory& mem) const {}
+
+    /** \brief  Can evalD be called concurrently with different memory objects? */
+    virtual bool isReentrant() const { return false;}
+
     /** \brief  Obtain solver name from Adaptor */
     virtual std::string getAdaptorSolverName() const { return ""; }
 
@@ -92,6 +105,15 @@ namespace casadi {
     /** \brief  Reset the sparsity propagation */
     virtual void spInit(bool fwd) {}
 
+    /** \brief  Propagate the sparsity pattern through nw*bvec_size directional derivatives
+        at once. arg[i] and res[i] hold nw consecutive bit vectors for each nonzero of input
+        and output i. Forward mode assigns res, adjoint mode adds (bitwise or) to arg.
+        The default implementation calls spEvaluate once for each of the nw bit vectors. */
+    virtual void spEvaluateWide(bool fwd, int nw, bvec_t** arg, bvec_t** res);
+
+    /** \brief  Is spEvaluateWide faster than calling spEvaluate repeatedly? */
+    virtual bool spCanEvaluateWide(bool fwd) { return false;}
+
     /** \brief  Evaluate symbolically, SXElement type, possibly nonmatching sparsity patterns */
     virtual void evalSX(const std::vector<SX>& arg, std::vector<SX>& res,
                         const std::vector<std::vector<SX> >& fseed,
@@ -200,6 +222,16 @@ namespace casadi {
      *  by creating the Jacobian then multiplying */
     virtual Function getDerivativeViaJac(int nfwd, int nadj);
 
+    /** \brief Constructs and returns a function that calculates directional derivatives
+     *
+     *  by splitting the forward directions into (at most) \a num_threads batches and the
+     *  adjoint directions into one more batch, and evaluating the batches in parallel */
+    Function getParallelDerivative(int nfwd, int nadj, int num_threads);
+
+    /** \brief Constructs and returns a function that calculates one batch of directional
+     *  derivatives for getParallelDerivative */
+    virtual Function getDerivativeBatch(int nfwd, int nadj);
+
     ///@}
 
 
@@ -217,8 +249,33 @@ namespace casadi {
     /** \brief  Print to a stream */
     virtual void generateCode(std::ostream &cfile, bool generate_main);
 
+    /** \brief Generate C code split into several files and a Makefile */
+    virtual void generateCodeSplit(const std::string& dirname, const std::string& basename,
+                                   int chunk_size);
+
+    /** \brief Generate code for several functions in one file
+     * The entry points of f[k] are prefixed by names[k] + "_". If fused is not empty, an
+     * additional function with this name evaluates all outputs of the SXFunctions f together,
+     * computing the shared subexpressions only once.
+     */
+    static void generateLibrary(std::ostream &cfile, const std::vector<Function>& f,
+                                const std::vector<std::string>& names, const std::string& fused);
+
     /** \brief Generate code for function inputs and outputs */
-    void generateIO(CodeGenerator& gen);
+    void generateIO(CodeGenerator& gen, const std::string& prefix="");
+
+    /** \brief Generate the evaluateWrap entry point, calling evaluate */
+    void generateEvaluateWrap(std::ostream &cfile, const std::string& prefix="") const;
+
+    /** \brief Generate the evaluateBatch entry point, see the option "codegen_batch"
+     * The default implementation calls evaluate for each instance.
+     */
+    virtual void generateEvaluateBatch(std::ostream &cfile, CodeGenerator& gen,
+                                       const std::string& prefix="") const;
+
+    /** \brief Generate a loop calling evaluate for each of the n instances in x and r */
+    void generateBatchLoop(std::ostream &cfile, const std::string& indent,
+                           const std::string& prefix="") const;
 
     /** \brief Generate code the function */
     virtual void generateFunction(std::ostream &stream, const std::string& fname,
@@ -233,6 +290,14 @@ namespace casadi {
     virtual void generateBody(std::ostream &stream, const std::string& type,
                               CodeGenerator& gen) const;
 
+    /** \brief Generate the function body as a sequence of chunks
+     * Each chunk holds at most chunk_size operations and becomes the body of a separate C
+     * function. State is passed between the chunks in a work vector "w" of length worksize.
+     * Returns false if the class cannot split its body, the default.
+     */
+    virtual bool generateChunks(std::vector<std::string>& chunks, int& worksize, int chunk_size,
+                                const std::string& type, CodeGenerator& gen) const;
+
     /** \brief  Print */
     virtual void print(std::ostream &stream) const;
 
@@ -275,6 +340,9 @@ namespace casadi {
     /// A flavor of getJacSparsity without any magic
     Sparsity getJacSparsityPlain(int iind, int oind);
 
+    /// A flavor of getJacSparsity propagating nw bit vectors per sweep with spEvaluateWide
+    Sparsity getJacSparsityWide(int iind, int oind, int nw);
+
     /// A flavor of getJacSparsity that does hierarchical block structure recognition
     Sparsity getJacSparsityHierarchical(int iind, int oind);
 
@@ -289,6 +357,17 @@ namespace casadi {
     /// Get, if necessary generate, the sparsity of a Jacobian block
     Sparsity& jacSparsity(int iind, int oind, bool compact, bool symmetric);
 
+    /** \brief Hash of the structure of the algorithm, used as a key for the sparsity cache
+        Combines into seed everything the dependency propagation of spEvaluate depends on,
+        except the input and output sparsities. Returns false if not supported. */
+    virtual bool structuralHash(std::size_t& seed) const { return false;}
+
+    /** \brief Key of a Jacobian block (coloring=false) or its seed matrices (coloring=true)
+        in the on-disk sparsity cache, along with the check value and reference patterns
+        verified on loading. Returns false if the cache cannot be used. */
+    bool sparsityCacheKey(std::size_t& key, std::size_t& check, std::vector<Sparsity>& ref,
+                          int iind, int oind, bool compact, bool symmetric, bool coloring);
+
     /// Get a vector of symbolic variables with the same dimensions as the inputs
     virtual std::vector<MX> symbolicInput() const;
 
@@ -329,10 +408,18 @@ namespace casadi {
     /** \brief  Log the status of the solver, function given */
     void log(const std::string& fcn, const std::string& msg) const;
 
-    /// Codegen function
+    /// Codegen function, compiled through the just-in-time compilation cache
     Function dynamicCompilation(Function f, std::string fname, std::string fdescr,
                                 std::string compiler);
 
+    /** \brief  Get the just-in-time compiled function, generating and compiling it if needed
+     * The compiled library is taken from the cache if the same code was compiled before.
+     */
+    Function& jitFunction();
+
+    /** \brief  Evaluate numerically, with the just-in-time compiled code if "jit" is set */
+    void evaluateJit();
+
     /// The following functions are called internally from EvaluateMX.
     /// For documentation, see the MXNode class
     ///@{
@@ -399,6 +486,23 @@ namespace casadi {
     /// Cache for sparsities of the Jacobian blocks
     SparseStorage<Sparsity> jac_sparsity_, jac_sparsity_compact_;
 
+    /// Directory of the on-disk sparsity cache, empty if disabled
+    std::string sparsity_cache_;
+
+    /// Evaluate with just-in-time compiled code?
+    bool jit_;
+
+    /// Compiler command and cache directory for just-in-time compilation
+    std::string jit_compiler_, jit_cache_;
+
+    /// The just-in-time compiled function, null until it is first needed
+    Function jit_fcn_;
+
+    /// Pointers to the inputs and outputs, and memory, for calling jit_fcn_
+    std::vector<const double*> jit_arg_;
+    std::vector<double*> jit_res_;
+    FunctionMemory jit_mem_;
+
     /// Cache for Jacobians
     SparseStorage<WeakRef> jac_, jac_compact_;
 
@@ -53,6 +53,10 @@ namespace casadi {
     addOption("expand_augmented",         OT_BOOLEAN,     true,
               "If DAE callback functions are SXFunction, have augmented"
               " DAE callback function also be SXFunction.");
+    addOption("num_threads",              OT_INTEGER,     1,
+              "Number of threads used to calculate forward sensitivities. The forward "
+              "directions are split into (at most) this number of batches, each batch "
+              "integrated by its own augmented integrator.");
 
     // Negative number of parameters for consistancy checking
     np_ = -1;
@@ -176,6 +180,8 @@ namespace casadi {
     t0_ = getOption("t0");
     tf_ = getOption("tf");
     print_stats_ = getOption("print_stats");
+    num_threads_ = getOption("num_threads");
+    casadi_assert_message(num_threads_>=1, "Option \"num_threads\" must be positive");
 
     // Form a linear solver for the sparsity propagation
     linsol_f_ = LinearSolver(spJacF());
@@ -685,11 +691,8 @@ namespace casadi {
     return ret;
   }
 
-  Function IntegratorInternal::getDerivative(int nfwd, int nadj) {
-    log("IntegratorInternal::getDerivative", "begin");
-
+  Integrator IntegratorInternal::getAugmentedIntegrator(int nfwd, int nadj, AugOffset& offset) {
     // Form the augmented DAE
-    AugOffset offset;
     std::pair<Function, Function> aug_dae = getAugmented(nfwd, nadj, offset);
 
     // Create integrator for augmented DAE
@@ -703,8 +706,26 @@ namespace casadi {
     if (hasSetOption("augmented_options"))
       integrator.setOption(getOption("augmented_options"));
 
-    // Initialize the integrator since we will call it below
+    // Initialize the integrator since it will be called
     integrator.init();
+    return integrator;
+  }
+
+  Function IntegratorInternal::getDerivative(int nfwd, int nadj) {
+    // Integrate batches of forward directions in parallel if there is more than one batch
+    if (num_threads_>1 && std::min(nfwd, num_threads_) + (nadj>0 ? 1 : 0) > 1) {
+      return getParallelDerivative(nfwd, nadj, num_threads_);
+    } else {
+      return getDerivativeBatch(nfwd, nadj);
+    }
+  }
+
+  Function IntegratorInternal::getDerivativeBatch(int nfwd, int nadj) {
+    log("IntegratorInternal::getDerivativeBatch", "begin");
+
+    // Create integrator for the augmented DAE
+    AugOffset offset;
+    Integrator integrator = getAugmentedIntegrator(nfwd, nadj, offset);
 
     // All inputs of the return function
     vector<MX> ret_in;
@@ -866,7 +887,7 @@ namespace casadi {
       if (nrz_>0) dd[INTEGRATOR_RZ0] = *zf_aug_it++;
       ret_out.insert(ret_out.end(), dd.begin(), dd.end());
     }
-    log("IntegratorInternal::getDerivative", "end");
+    log("IntegratorInternal::getDerivativeBatch", "end");
 
     // Create derivative function and return
     return MXFunction(ret_in, ret_out);
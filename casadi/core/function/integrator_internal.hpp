@@ -92,6 +92,11 @@ namespace casadi {
     */
     virtual Function getDerivative(int nfwd, int nadj);
 
+    /** Generate a function that calculates \a nfwd forward derivatives
+     * and \a nadj adjoint derivatives with a single augmented integrator
+    */
+    virtual Function getDerivativeBatch(int nfwd, int nadj);
+
     /** \brief Calculate the jacobian of output \a oind with respect to input \a iind */
     virtual Function getJacobian(int iind, int oind, bool compact, bool symmetric);
 
@@ -113,6 +118,10 @@ namespace casadi {
     /// Get offsets in augmented problem
     AugOffset getAugOffset(int nfwd, int nadj);
 
+    /** \brief Create and initialize an integrator for the augmented DAE with \a nfwd forward
+    * sensitivities and \a nadj adjoint sensitivities */
+    Integrator getAugmentedIntegrator(int nfwd, int nadj, AugOffset& offset);
+
     /// Create sparsity pattern of the extended Jacobian (forward problem)
     Sparsity spJacF();
 
@@ -161,6 +170,7 @@ namespace casadi {
 
     /// Options
     bool print_stats_;
+    int num_threads_;
 
     // Creator function for internal class
     typedef IntegratorInternal* (*Creator)(const Function& f, const Function& g);
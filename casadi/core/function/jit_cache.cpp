@@ -0,0 +1,177 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "jit_cache.hpp"
+#include "../casadi_exception.hpp"
+#include "../profiling.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <iterator>
+#include <iostream>
+#include <sys/stat.h>
+#ifndef _WIN32
+#include <unistd.h>
+#else
+#include <process.h>
+#include <direct.h>
+#endif
+
+using namespace std;
+
+namespace casadi {
+
+  unsigned long long JitCache::hash(const std::string& s, unsigned long long seed) {
+    unsigned long long h = seed;
+    for (string::const_iterator c=s.begin(); c!=s.end(); ++c) {
+      h ^= static_cast<unsigned char>(*c);
+      h *= 1099511628211ULL;
+    }
+    return h;
+  }
+
+  std::string JitCache::fileName(const std::string& dir, unsigned long long key) {
+    stringstream ss;
+    ss << dir;
+    if (!dir.empty() && dir[dir.size()-1]!='/') ss << "/";
+    ss << "casadi_jit_" << hex << setw(16) << setfill('0') << key << ".so";
+    return ss.str();
+  }
+
+  std::string JitCache::defaultDirectory() {
+#ifdef _WIN32
+    const char* base = getenv("LOCALAPPDATA");
+    if (base!=0 && *base!=0) return string(base) + "/casadi/jit";
+#else // _WIN32
+    const char* base = getenv("XDG_CACHE_HOME");
+    if (base!=0 && *base!=0) return string(base) + "/casadi/jit";
+    base = getenv("HOME");
+    if (base!=0 && *base!=0) return string(base) + "/.cache/casadi/jit";
+#endif // _WIN32
+    return "casadi_jit";
+  }
+
+  void JitCache::makeDirectory(const std::string& dir) {
+    // Create the parents first
+    for (string::size_type pos = dir.find('/', 1); pos!=string::npos; pos = dir.find('/', pos+1)) {
+#ifdef _WIN32
+      _mkdir(dir.substr(0, pos).c_str());
+#else // _WIN32
+      mkdir(dir.substr(0, pos).c_str(), 0700);
+#endif // _WIN32
+    }
+#ifdef _WIN32
+    int flag = _mkdir(dir.c_str());
+#else // _WIN32
+    int flag = mkdir(dir.c_str(), 0700);
+#endif // _WIN32
+    casadi_assert_message(flag==0 || errno==EEXIST,
+                          "JitCache: Cannot create the cache directory \"" << dir << "\"");
+  }
+
+  std::string JitCache::compile(const std::string& source, const std::string& compiler,
+                                const std::string& dir, bool verbose) {
+    // Flag to get a shared library
+#ifdef __APPLE__
+    string dlflag = "-dynamiclib";
+#else // __APPLE__
+    string dlflag = "-shared";
+#endif // __APPLE__
+
+    // The key depends on everything that determines the contents of the library
+    string command = compiler + " " + dlflag;
+    unsigned long long key = hash(source, hash(command));
+    string dlname = fileName(dir, key);
+    string cname = dlname.substr(0, dlname.size()-3) + ".c";
+
+    // What is compiled and kept next to the library: the source, preceded by the command
+    string cmd_comment = command;
+    for (string::size_type pos=cmd_comment.find("*/"); pos!=string::npos;
+         pos=cmd_comment.find("*/", pos)) {
+      cmd_comment.replace(pos, 2, "* /");
+    }
+    string contents = "/* JitCache: " + cmd_comment + " */\n" + source;
+
+    // Cache hit, if the kept source is identical, since the key alone does not rule out a
+    // hash collision or a stale library
+    if (ifstream(dlname.c_str()).good()) {
+      ifstream cfile(cname.c_str(), ios::binary);
+      string stored((istreambuf_iterator<char>(cfile)), istreambuf_iterator<char>());
+      if (!cfile.bad() && stored==contents) {
+        if (verbose) cout << "JitCache: using " << dlname << endl;
+        return dlname;
+      }
+      if (verbose) cout << "JitCache: the source of " << dlname << " differs" << endl;
+    }
+
+    // Names unique to the process, and to the thread through the address of a local
+    stringstream tmpname;
+#ifndef _WIN32
+    tmpname << dlname << "." << getpid();
+#else // _WIN32
+    tmpname << dlname << "." << _getpid();
+#endif // _WIN32
+    tmpname << "." << hex << reinterpret_cast<size_t>(&tmpname);
+    string tmp_c = tmpname.str() + ".c";
+    string tmp_dl = tmpname.str() + ".tmp";
+
+    // Write the source
+    makeDirectory(dir);
+    {
+      ofstream file(tmp_c.c_str(), ios::binary | ios::trunc);
+      file << contents;
+      casadi_assert_message(file.good(), "JitCache: Cannot write \"" << tmp_c << "\"");
+    }
+
+    // Compile it
+    string compile_command = command + " " + tmp_c + " -o " + tmp_dl;
+    if (verbose) cout << "JitCache: compiling using \"" << compile_command << "\"" << endl;
+    double time_start = getRealTime();
+    int flag = system(compile_command.c_str());
+    if (flag!=0) {
+      remove(tmp_dl.c_str());
+      casadi_error("JitCache: Compilation failed: \"" << compile_command << "\" returned "
+                   << flag << ". The source has been kept in \"" << tmp_c << "\".");
+    }
+    if (verbose) {
+      cout << "JitCache: compiled " << dlname << " in " << (getRealTime()-time_start)
+           << " s" << endl;
+    }
+
+    // Move into place, the source first since a cache hit requires it
+    if (rename(tmp_c.c_str(), cname.c_str())!=0) remove(tmp_c.c_str());
+    if (rename(tmp_dl.c_str(), dlname.c_str())!=0) {
+      // Another process may have moved an identical library into place in the meantime
+      remove(tmp_dl.c_str());
+      casadi_assert_message(ifstream(dlname.c_str()).good(),
+                            "JitCache: Cannot move the library to \"" << dlname << "\"");
+    }
+    return dlname;
+  }
+
+} // namespace casadi
@@ -0,0 +1,75 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_JIT_CACHE_HPP
+#define CASADI_JIT_CACHE_HPP
+
+#include "../casadi_common.hpp"
+#include <string>
+
+/// \cond INTERNAL
+namespace casadi {
+
+  /** \brief Content-addressed cache of just-in-time compiled C code
+
+      Compiles C source into a shared library in a cache directory. The file name is a hash
+      of the source and the compiler command, so a library is compiled once and then reused by
+      every process, also between runs. The source and the library are written to names unique
+      to the process and then renamed into place, so concurrent processes never see partially
+      written files. When two processes compile the same source at the same time, the last
+      rename wins, which is harmless since both libraries are identical.
+
+      The source, preceded by a comment with the compiler command, is kept next to the
+      library and compared on every cache hit. A library whose source differs, because of a
+      hash collision or a stale file, is compiled again and replaced.
+  */
+  class CASADI_EXPORT JitCache {
+  public:
+    /** \brief Get a shared library compiled from the source, compiling it on a cache miss
+        Returns the path of the library. Compilation failure is an error. */
+    static std::string compile(const std::string& source, const std::string& compiler,
+                               const std::string& dir, bool verbose=false);
+
+    /** \brief Default cache directory of the current user
+        $XDG_CACHE_HOME/casadi/jit or $HOME/.cache/casadi/jit (%LOCALAPPDATA%\\casadi\\jit on
+        Windows). */
+    static std::string defaultDirectory();
+
+    /// Hash of a string (64-bit FNV-1a), stable between runs and platforms
+    static unsigned long long hash(const std::string& s,
+                                   unsigned long long seed=14695981039346656037ULL);
+
+    /// Name of the library compiled from a source with a given hash
+    static std::string fileName(const std::string& dir, unsigned long long key);
+
+  private:
+    /// Create a directory and its parents, if they do not exist
+    static void makeDirectory(const std::string& dir);
+  };
+
+} // namespace casadi
+/// \endcond
+
+#endif // CASADI_JIT_CACHE_HPP
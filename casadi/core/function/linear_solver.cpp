@@ -104,6 +104,10 @@ namespace casadi {
     return (*this)->getFactorization(transpose);
   }
 
+  std::vector<int> LinearSolver::getInertia() const {
+    return (*this)->getInertia();
+  }
+
   void LinearSolver::solveL(double* x, int nrhs, bool transpose) {
     return (*this)->solveL(x, nrhs, transpose);
   }
@@ -143,6 +143,12 @@ namespace casadi {
      */
     DMatrix getFactorization(bool transpose=false) const;
 
+    /** \brief Obtain the inertia of the factorized matrix
+        Returns the number of positive, negative and zero eigenvalues.
+        Only for symmetric indefinite solvers
+     */
+    std::vector<int> getInertia() const;
+
     /// Check if a particular cast is allowed
     static bool testCast(const SharedObjectNode* ptr);
 
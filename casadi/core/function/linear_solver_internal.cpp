@@ -408,5 +408,11 @@ namespace casadi {
     return DMatrix();
   }
 
+  std::vector<int> LinearSolverInternal::getInertia() const {
+    casadi_error("LinearSolverInternal::getInertia not defined for class "
+                 << typeid(*this).name());
+    return std::vector<int>();
+  }
+
 } // namespace casadi
 
@@ -99,6 +99,9 @@ namespace casadi {
     /// Obtain a numeric Cholesky factorization
     virtual DMatrix getFactorization(bool transpose) const;
 
+    /// Number of positive, negative and zero eigenvalues of the factorized matrix
+    virtual std::vector<int> getInertia() const;
+
     /// Dulmage-Mendelsohn decomposition
     std::vector<int> rowperm_, colperm_, rowblock_, colblock_;
 
@@ -65,6 +65,10 @@ namespace casadi {
                                          const std::vector<MX>& outputv) :
     XFunctionInternal<MXFunction, MXFunctionInternal, MX, MXNode>(inputv, outputv) {
 
+    addOption("arena", OT_BOOLEAN, false,
+              "Keep all intermediates of the numerical evaluation in a single contiguous "
+              "array with offsets from the live variable analysis. Inputs are read and "
+              "outputs written without copying.");
     setOption("name", "unnamed_mx_function");
 
     // Check for inputs that are not symbolic primitives
@@ -384,6 +388,60 @@ namespace casadi {
       }
     }
 
+    // Offsets of the work vector elements in the arena
+    arena_offset_.resize(worksize+1);
+    arena_offset_[0] = 0;
+    for (int k=0; k<worksize; ++k) {
+      arena_offset_[k+1] = arena_offset_[k] + work_[k].first.size();
+    }
+
+    // Memory of the numerical evaluation, in bytes
+    stats_["memory_work"] = static_cast<double>(sizeof(double)*arena_offset_.back());
+    stats_["memory_tmp"] = static_cast<double>(sizeof(int)*nitmp + sizeof(double)*nrtmp);
+
+    // Lay out the work vector in a single arena
+    use_arena_ = getOption("arena");
+    if (use_arena_) {
+      arena_.resize(arena_offset_.back());
+      arena_ptr_.resize(worksize);
+      arena_nz_.resize(algorithm_.size());
+      arena_output_.resize(algorithm_.size());
+      fill(arena_output_.begin(), arena_output_.end(), -1);
+
+      // Last element of the algorithm writing to each element of the work vector
+      vector<int> last_writer(worksize, -1);
+      size_t max_arg=0, max_res=0;
+      for (int i=0; i<algorithm_.size(); ++i) {
+        const AlgEl& el = algorithm_[i];
+        if (el.op==OP_OUTPUT) {
+          // Write the output directly when computing it, if possible
+          int w = last_writer[el.arg.front()];
+          if (w>=0 && algorithm_[w].op!=OP_INPUT && algorithm_[w].res.size()==1
+              && arena_output_[w]<0) {
+            arena_output_[w] = el.res.front();
+          } else {
+            arena_output_[i] = el.res.front();
+          }
+        } else {
+          if (el.op!=OP_INPUT) {
+            arena_nz_[i] = el.data->hasEvaluateNZ();
+            max_arg = std::max(max_arg, el.arg.size());
+            max_res = std::max(max_res, el.res.size());
+          }
+          for (int c=0; c<el.res.size(); ++c) {
+            if (el.res[c]>=0) last_writer[el.res[c]] = i;
+          }
+        }
+      }
+      arena_arg_.resize(max_arg);
+      arena_res_.resize(max_res);
+    } else {
+      arena_.clear();
+      arena_ptr_.clear();
+      arena_nz_.clear();
+      arena_output_.clear();
+    }
+
     if (CasadiOptions::profiling && CasadiOptions::profilingBinary) {
       profileWriteName(CasadiOptions::profilingLog, this, getOption("name"),
                        ProfilingData_FunctionType_MXFunction, algorithm_.size());
@@ -428,6 +486,18 @@ namespace casadi {
 
   void MXFunctionInternal::evaluate() {
     casadi_log("MXFunctionInternal::evaluate():begin "  << getOption("name"));
+
+    // Latency of the evaluation
+    double time_evaluate = gather_stats_ ? getRealTime() : 0;
+
+    // Evaluate in the arena, unless profiling
+    if (use_arena_ && !CasadiOptions::profiling) {
+      evaluateArena();
+      if (gather_stats_) stats_["t_evaluate"] = getRealTime() - time_evaluate;
+      casadi_log("MXFunctionInternal::evaluate():end "  << getOption("name"));
+      return;
+    }
+
     // Set up timers for profiling
     double time_zero=0;
     double time_start=0;
@@ -507,9 +577,194 @@ namespace casadi {
       }
     }
 
+    if (gather_stats_) stats_["t_evaluate"] = getRealTime() - time_evaluate;
     casadi_log("MXFunctionInternal::evaluate():end "  << getOption("name"));
   }
 
+  void MXFunctionInternal::evaluateArena() {
+    // Make sure that there are no free variables
+    if (!free_vars_.empty()) {
+      std::stringstream ss;
+      repr(ss);
+      casadi_error("Cannot evaluate \"" << ss.str() << "\" since variables "
+                   << free_vars_ << " are free.");
+    }
+
+    // Current locations of the work vector elements
+    double** ptr = getPtr(arena_ptr_);
+    double* arena = getPtr(arena_);
+
+    // Evaluate all of the nodes of the algorithm
+    for (int i=0; i<algorithm_.size(); ++i) {
+      AlgEl& el = algorithm_[i];
+      if (el.op==OP_INPUT) {
+        // Read the input where it is
+        ptr[el.res.front()] = getPtr(input(el.arg.front()).data());
+      } else if (el.op==OP_OUTPUT) {
+        // Copy to the output, unless it was written directly
+        if (arena_output_[i]>=0) {
+          const double* w = ptr[el.arg.front()];
+          vector<double>& r = output(arena_output_[i]).data();
+          if (w!=getPtr(r)) copy(w, w+r.size(), r.begin());
+        }
+      } else {
+        // Locate the arguments
+        for (int c=0; c<el.arg.size(); ++c) {
+          arena_arg_[c] = el.arg[c]>=0 ? ptr[el.arg[c]] : 0;
+        }
+
+        // Place the results in the arena or directly in the output
+        for (int c=0; c<el.res.size(); ++c) {
+          if (el.res[c]>=0) {
+            if (arena_output_[i]>=0) {
+              arena_res_[c] = getPtr(output(arena_output_[i]).data());
+            } else {
+              arena_res_[c] = arena + arena_offset_[el.res[c]];
+            }
+            ptr[el.res[c]] = arena_res_[c];
+          } else {
+            arena_res_[c] = 0;
+          }
+        }
+
+        if (arena_nz_[i]) {
+          // Evaluate directly in the arena
+          el.data->evaluateNZ(getPtr(arena_arg_), getPtr(arena_res_),
+                              getPtr(itmp_), getPtr(rtmp_));
+        } else {
+          // Evaluate with the matrix valued work vector, copying in and out of the arena
+          updatePointers(el);
+          for (int c=0; c<el.arg.size(); ++c) {
+            if (arena_arg_[c]!=0) {
+              vector<double>& w = mx_input_[c]->data();
+              copy(arena_arg_[c], arena_arg_[c]+w.size(), w.begin());
+            }
+          }
+          el.data->evaluateD(mx_input_, mx_output_, itmp_, rtmp_);
+          for (int c=0; c<el.res.size(); ++c) {
+            if (arena_res_[c]!=0) {
+              const vector<double>& w = mx_output_[c]->data();
+              copy(w.begin(), w.end(), arena_res_[c]);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  void MXFunctionInternal::evalD(const double** arg, double** res, FunctionMemory& mem) {
+    // Make sure that there are no free variables
+    if (!free_vars_.empty()) {
+      std::stringstream ss;
+      repr(ss);
+      casadi_error("Cannot evaluate \"" << ss.str() << "\" since variables "
+                   << free_vars_ << " are free.");
+    }
+
+    // Memory for the next embedded function call
+    vector<FunctionMemory>::iterator sub_it = mem.sub.begin();
+
+    // Next buffer for arguments of embedded function calls with a different sparsity pattern
+    vector<DMatrix>::iterator proj_it = mem.work.begin() + work_.size();
+
+    // Evaluate all of the nodes of the algorithm, using the caller-owned work vectors
+    for (vector<AlgEl>::iterator it=algorithm_.begin(); it!=algorithm_.end(); ++it) {
+      if (it->op==OP_INPUT) {
+        // Pass an input
+        vector<double>& w = mem.work[it->res.front()].data();
+        const double* a = arg[it->arg.front()];
+        if (a==0) {
+          fill(w.begin(), w.end(), 0);
+        } else {
+          copy(a, a+w.size(), w.begin());
+        }
+      } else if (it->op==OP_OUTPUT) {
+        // Get an output
+        double* r = res[it->res.front()];
+        if (r!=0) {
+          const vector<double>& w = mem.work[it->arg.front()].data();
+          copy(w.begin(), w.end(), r);
+        }
+      } else if (it->op==OP_CALL) {
+        // Embedded function call, evaluated with its own memory
+        Function& f = it->data->getFunction();
+        mem.arg_nz.resize(it->arg.size());
+        for (int i=0; i<it->arg.size(); ++i) {
+          if (it->arg[i]<0) {
+            mem.arg_nz[i] = 0;
+          } else if (mem.work[it->arg[i]].sparsity()==f.input(i).sparsity()) {
+            mem.arg_nz[i] = getPtr(mem.work[it->arg[i]].data());
+          } else {
+            // Project to the sparsity pattern of the function input
+            proj_it->set(mem.work[it->arg[i]]);
+            mem.arg_nz[i] = getPtr((proj_it++)->data());
+          }
+        }
+        mem.res_nz.resize(it->res.size());
+        for (int i=0; i<it->res.size(); ++i) {
+          mem.res_nz[i] = it->res[i]<0 ? 0 : getPtr(mem.work[it->res[i]].data());
+        }
+        f.evaluate(getPtr(mem.arg_nz), getPtr(mem.res_nz), *sub_it++);
+      } else {
+        // Point pointers to the data corresponding to the element
+        mem.arg.resize(it->arg.size());
+        for (int i=0; i<it->arg.size(); ++i) {
+          mem.arg[i] = it->arg[i]<0 ? 0 : &mem.work[it->arg[i]];
+        }
+        mem.res.resize(it->res.size());
+        for (int i=0; i<it->res.size(); ++i) {
+          mem.res[i] = it->res[i]<0 ? 0 : &mem.work[it->res[i]];
+        }
+
+        // Evaluate
+        it->data->evaluateD(mem.arg, mem.res, mem.iw, mem.w);
+      }
+    }
+  }
+
+  void MXFunctionInternal::allocMemory(FunctionMemory& mem) const {
+    // Work vector with the same sparsity patterns as work_
+    mem.work.clear();
+    mem.work.reserve(work_.size());
+    for (vector<pair<DMatrix, int> >::const_iterator it=work_.begin(); it!=work_.end(); ++it) {
+      mem.work.push_back(DMatrix(it->first.sparsity()));
+    }
+
+    // Temporary vectors of the nodes
+    mem.iw.resize(itmp_.size());
+    mem.w.resize(rtmp_.size());
+
+    // Memory for embedded function calls, followed by buffers for projected arguments
+    mem.sub.clear();
+    for (vector<AlgEl>::const_iterator it=algorithm_.begin(); it!=algorithm_.end(); ++it) {
+      if (it->op==OP_CALL) {
+        const Function& f = it->data->getFunction();
+        mem.sub.push_back(f.allocMemory());
+        for (int i=0; i<it->arg.size(); ++i) {
+          if (it->arg[i]>=0 && work_[it->arg[i]].first.sparsity()!=f.input(i).sparsity()) {
+            mem.work.push_back(DMatrix(f.input(i).sparsity()));
+          }
+        }
+      }
+    }
+  }
+
+  bool MXFunctionInternal::isReentrant() const {
+    for (vector<AlgEl>::const_iterator it=algorithm_.begin(); it!=algorithm_.end(); ++it) {
+      switch (it->op) {
+      case OP_SOLVE:
+        // Linear solvers keep their factorization in the solver object
+        return false;
+      case OP_CALL:
+        if (!it->data->getFunction().isReentrant()) return false;
+        break;
+      default:
+        break;
+      }
+    }
+    return true;
+  }
+
   void MXFunctionInternal::print(ostream &stream, const AlgEl& el) const {
     if (el.op==OP_OUTPUT) {
       stream << "output[" << el.res.front() << "] = @" << el.arg.at(0);
@@ -660,6 +915,16 @@ namespace casadi {
     return ret;
   }
 
+  Function MXFunctionInternal::getJacobian(int iind, int oind, bool compact, bool symmetric) {
+    // Inlining the derivatives would prevent evaluating the color groups in parallel
+    if (static_cast<int>(getOption("jacobian_num_threads"))>1) {
+      return getNumericJacobian(iind, oind, compact, symmetric);
+    } else {
+      return XFunctionInternal<MXFunction, MXFunctionInternal, MX, MXNode>::getJacobian(
+        iind, oind, compact, symmetric);
+    }
+  }
+
   std::vector<MX> MXFunctionInternal::symbolicOutput(const std::vector<MX>& arg) {
     // Check if input is given
     const int checking_depth = 2;
@@ -65,6 +65,20 @@ namespace casadi {
     /** \brief  Evaluate the algorithm */
     virtual void evaluate();
 
+    /** \brief  Evaluate the algorithm with all intermediates in a single arena */
+    void evaluateArena();
+
+    /** \brief  Evaluate with caller-owned arguments, results and memory */
+    virtual void evalD(const double** arg, double** res, FunctionMemory& mem);
+
+    /** \brief  Allocate memory for evalD */
+    virtual void allocMemory(FunctionMemory& mem) const;
+
+    /** \brief  Can evalD be called concurrently with different memory objects?
+     * True unless the algorithm contains linear solves or calls to functions that aren't
+     */
+    virtual bool isReentrant() const;
+
     /** \brief  Print description */
     virtual void print(std::ostream &stream) const;
 
@@ -86,6 +100,9 @@ namespace casadi {
     /** \brief Generate a function that calculates a Jacobian function by operator overloading */
     virtual Function getNumericJacobian(int iind, int oind, bool compact, bool symmetric);
 
+    /** \brief Return Jacobian function, calling derivative functions in parallel if requested */
+    virtual Function getJacobian(int iind, int oind, bool compact, bool symmetric);
+
     /** \brief  An element of the algorithm, namely an MX node */
     typedef MXAlgEl AlgEl;
 
@@ -107,6 +124,35 @@ namespace casadi {
     /// Free variables
     std::vector<MX> free_vars_;
 
+    /// Keep all intermediates in a single arena during evaluate
+    bool use_arena_;
+
+    /// Arena holding the nonzeros of all elements of the work vector
+    std::vector<double> arena_;
+
+    /// Offset in the arena of each element of the work vector
+    std::vector<int> arena_offset_;
+
+    /** \brief  Current location of the nonzeros of each element of the work vector
+     * Points into the arena, or to an input or output of the function that was passed
+     * without copying.
+     */
+    std::vector<double*> arena_ptr_;
+
+    /// Is evaluateNZ available for each element of the algorithm?
+    std::vector<bool> arena_nz_;
+
+    /** \brief  Direct writing of outputs, for each element of the algorithm
+     * For an operation, the index of the function output that the result is written into
+     * directly (or -1). For an output instruction, the index of the output to copy to, or -1
+     * if the output was already written directly by the operation computing it.
+     */
+    std::vector<int> arena_output_;
+
+    /// Pointers to the arguments and results of an operation during arena evaluation
+    std::vector<const double*> arena_arg_;
+    std::vector<double*> arena_res_;
+
     /** \brief Evaluate symbolically, SXElement type*/
     virtual void evalSXsparse(const std::vector<SX>& input, std::vector<SX>& output,
                               const std::vector<std::vector<SX> >& fwdSeed,
@@ -28,6 +28,9 @@
 #include "sx_function.hpp"
 #include "../sx/sx_tools.hpp"
 #include "../mx/mx_tools.hpp"
+#include "../profiling.hpp"
+#include <ctime>
+#include <iomanip>
 
 INPUTSCHEME(NlpSolverInput)
 OUTPUTSCHEME(NlpSolverOutput)
@@ -35,7 +38,8 @@ OUTPUTSCHEME(NlpSolverOutput)
 using namespace std;
 namespace casadi {
 
-  NlpSolverInternal::NlpSolverInternal(const Function& nlp) : nlp_(nlp) {
+  NlpSolverInternal::NlpSolverInternal(const Function& nlp) : nlp_(nlp),
+      t0_wall_(0), t0_proc_(0), iter_start_wall_(0), iter_start_proc_(0) {
 
     // Set default options
     setOption("name", "unnamed NLP solver"); // name of the function
@@ -87,6 +91,9 @@ namespace casadi {
   }
 
   void NlpSolverInternal::init() {
+    // Phases are registered by the solver
+    timers_.clear();
+
     // Initialize the NLP
     nlp_.init(false);
     casadi_assert_message(nlp_.getNumInputs()==NL_NUM_IN,
@@ -389,4 +396,99 @@ namespace casadi {
                  << typeid(*this).name());
   }
 
+  /// Process CPU time in seconds
+  static double getProcTime() {
+    return static_cast<double>(clock())/CLOCKS_PER_SEC;
+  }
+
+  int NlpSolverInternal::addTimer(const std::string& name) {
+    timers_.push_back(Timer(name));
+    return timers_.size()-1;
+  }
+
+  void NlpSolverInternal::resetTimers() {
+    for (vector<Timer>::iterator t=timers_.begin(); t!=timers_.end(); ++t) {
+      t->n = 0;
+      t->t_wall = t->t_proc = t->mark_wall = t->mark_proc = 0;
+      t->start_wall = t->start_proc = -1;
+      t->iter_wall.clear();
+      t->iter_proc.clear();
+    }
+    iter_wall_.clear();
+    iter_proc_.clear();
+    t0_wall_ = iter_start_wall_ = getRealTime();
+    t0_proc_ = iter_start_proc_ = getProcTime();
+  }
+
+  void NlpSolverInternal::startTimer(int phase) {
+    Timer& t = timers_.at(phase);
+    t.start_wall = getRealTime();
+    t.start_proc = getProcTime();
+  }
+
+  void NlpSolverInternal::stopTimer(int phase) {
+    Timer& t = timers_.at(phase);
+    if (t.start_wall<0) return;
+    t.t_wall += getRealTime() - t.start_wall;
+    t.t_proc += getProcTime() - t.start_proc;
+    t.start_wall = t.start_proc = -1;
+    t.n++;
+  }
+
+  void NlpSolverInternal::timerIteration() {
+    for (vector<Timer>::iterator t=timers_.begin(); t!=timers_.end(); ++t) {
+      t->iter_wall.push_back(t->t_wall - t->mark_wall);
+      t->iter_proc.push_back(t->t_proc - t->mark_proc);
+      t->mark_wall = t->t_wall;
+      t->mark_proc = t->t_proc;
+    }
+    double now_wall = getRealTime(), now_proc = getProcTime();
+    iter_wall_.push_back(now_wall - iter_start_wall_);
+    iter_proc_.push_back(now_proc - iter_start_proc_);
+    iter_start_wall_ = now_wall;
+    iter_start_proc_ = now_proc;
+  }
+
+  double NlpSolverInternal::timerElapsed() const {
+    return getRealTime() - t0_wall_;
+  }
+
+  void NlpSolverInternal::timersToStats() {
+    stats_["t_mainloop"] = getRealTime() - t0_wall_;
+    stats_["t_proc_mainloop"] = getProcTime() - t0_proc_;
+    for (vector<Timer>::const_iterator t=timers_.begin(); t!=timers_.end(); ++t) {
+      stats_["t_" + t->name] = t->t_wall;
+      stats_["t_proc_" + t->name] = t->t_proc;
+      stats_["n_" + t->name] = t->n;
+    }
+    if (gather_stats_) {
+      if (stats_.find("iterations")==stats_.end()) stats_["iterations"] = Dictionary();
+      Dictionary& iterations = stats_["iterations"];
+      iterations["t_iter"] = iter_wall_;
+      iterations["t_proc_iter"] = iter_proc_;
+      for (vector<Timer>::const_iterator t=timers_.begin(); t!=timers_.end(); ++t) {
+        iterations["t_" + t->name] = t->iter_wall;
+        iterations["t_proc_" + t->name] = t->iter_proc;
+      }
+    }
+  }
+
+  void NlpSolverInternal::printTimers(std::ostream &stream) const {
+    std::ios_base::fmtflags flags = stream.flags();
+    std::streamsize precision = stream.precision();
+    stream << scientific << setprecision(3);
+    stream << setw(20) << left << "phase" << right << setw(12) << "wall [s]" << setw(12)
+           << "CPU [s]" << setw(8) << "calls" << setw(16) << "wall/call [s]" << endl;
+    for (vector<Timer>::const_iterator t=timers_.begin(); t!=timers_.end(); ++t) {
+      stream << setw(20) << left << t->name << right << setw(12) << t->t_wall << setw(12)
+             << t->t_proc << setw(8) << t->n;
+      if (t->n>0) stream << setw(16) << t->t_wall/t->n;
+      stream << endl;
+    }
+    stream << setw(20) << left << "main loop" << right << setw(12) << getRealTime() - t0_wall_
+           << setw(12) << getProcTime() - t0_proc_ << endl;
+    stream.flags(flags);
+    stream.precision(precision);
+  }
+
 } // namespace casadi
@@ -165,6 +165,77 @@ namespace casadi {
     /// Read options from parameter xml
     virtual void setOptionsFromFile(const std::string & file);
 
+    /// \name Timing of the phases of a solver, wall-clock and CPU
+    /// @{
+    /// Register a phase to be timed (in init), returns its index
+    int addTimer(const std::string& name);
+
+    /// Zero all timers and start the clock of the solve
+    void resetTimers();
+
+    /// Start timing a phase
+    void startTimer(int phase);
+
+    /// Stop timing a phase
+    void stopTimer(int phase);
+
+    /// Close an iteration: record the time spent in each phase since the previous call
+    void timerIteration();
+
+    /// Wall-clock time since resetTimers
+    double timerElapsed() const;
+
+    /** \brief Write the timings to stats_
+
+        Totals go to "t_<phase>" (wall-clock), "t_proc_<phase>" (CPU) and "n_<phase>" (calls),
+        the complete solve to "t_mainloop" and "t_proc_mainloop". With gather_stats, the
+        per-iteration times are added to stats_["iterations"] under the same names.
+    */
+    void timersToStats();
+
+    /// Print a summary of the timings
+    void printTimers(std::ostream &stream=std::cout) const;
+
+    /// Time spent in a phase
+    struct Timer {
+      /// Constructor, the phase has not been called yet
+      explicit Timer(const std::string& name="") : name(name), n(0), t_wall(0), t_proc(0),
+        start_wall(-1), start_proc(-1), mark_wall(0), mark_proc(0) {}
+      /// Name of the phase
+      std::string name;
+      /// Number of calls
+      int n;
+      /// Accumulated wall-clock and CPU time
+      double t_wall, t_proc;
+      /// Start of the running call, negative if not running
+      double start_wall, start_proc;
+      /// Accumulated times at the end of the previous iteration
+      double mark_wall, mark_proc;
+      /// Wall-clock and CPU time per iteration
+      std::vector<double> iter_wall, iter_proc;
+    };
+
+    /// Times a phase for as long as it is in scope
+    class ScopedTimer {
+    public:
+      ScopedTimer(NlpSolverInternal* solver, int phase) : solver_(solver), phase_(phase) {
+        solver_->startTimer(phase_);
+      }
+      ~ScopedTimer() { solver_->stopTimer(phase_);}
+    private:
+      NlpSolverInternal* solver_;
+      int phase_;
+    };
+
+    /// Timed phases
+    std::vector<Timer> timers_;
+
+    /// Start of the solve and of the current iteration
+    double t0_wall_, t0_proc_, iter_start_wall_, iter_start_proc_;
+
+    /// Wall-clock and CPU time of each iteration
+    std::vector<double> iter_wall_, iter_proc_;
+    /// @}
   };
 
 } // namespace casadi
@@ -25,7 +25,20 @@
 
 #include "parallelizer_internal.hpp"
 #include "mx_function.hpp"
+#include "thread_pool.hpp"
 #include <algorithm>
+#ifdef USE_CXX11
+#include <chrono>
+#endif // USE_CXX11
+#ifndef _WIN32
+#include <unistd.h>
+#include <poll.h>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <signal.h>
+#include <cerrno>
+#endif // _WIN32
 #ifdef WITH_OPENMP
 #include <omp.h>
 #endif //WITH_OPENMP
@@ -34,11 +47,19 @@ using namespace std;
 
 namespace casadi {
 
-  ParallelizerInternal::ParallelizerInternal(const std::vector<Function>& funcs) : funcs_(funcs) {
-    addOption("parallelization", OT_STRING, "serial", "", "serial|openmp|mpi");
+  ParallelizerInternal::ParallelizerInternal(const std::vector<Function>& funcs)
+      : funcs_(funcs), pool_(0) {
+    addOption("parallelization", OT_STRING, "serial", "", "serial|openmp|threadpool|process|mpi");
+    addOption("num_threads", OT_INTEGER, 0,
+              "Number of threads (threadpool) or worker processes (process) to use, "
+              "0 means the number of hardware threads");
   }
 
   ParallelizerInternal::~ParallelizerInternal() {
+#ifdef USE_CXX11
+    delete pool_;
+#endif // USE_CXX11
+    stopWorkers();
   }
 
   void ParallelizerInternal::init() {
@@ -47,6 +68,10 @@ namespace casadi {
       mode_ = SERIAL;
     } else if (getOption("parallelization")=="openmp") {
       mode_ = OPENMP;
+    } else if (getOption("parallelization")=="threadpool") {
+      mode_ = THREADPOOL;
+    } else if (getOption("parallelization")=="process") {
+      mode_ = PROCESS;
     } else if (getOption("parallelization")=="mpi") {
       mode_ = MPI;
     } else {
@@ -62,6 +87,41 @@ namespace casadi {
     }
 #endif // WITH_OPENMP
 
+    // Switch to serial mode if C++11 threads are not supported
+#ifndef USE_CXX11
+    if (mode_ == THREADPOOL) {
+      casadi_warning("Thread pool parallelization is not available, switching to serial mode. "
+                     "Recompile CasADi with a compiler supporting C++11.");
+      mode_ = SERIAL;
+    }
+#endif // USE_CXX11
+
+    // Worker processes require POSIX
+#ifdef _WIN32
+    if (mode_ == PROCESS) {
+      casadi_warning("Process parallelization is not available on Windows, "
+                     "switching to serial mode.");
+      mode_ = SERIAL;
+    }
+#endif // _WIN32
+
+    // Number of threads or processes, these are created when first needed
+    num_threads_ = getOption("num_threads");
+    casadi_assert_message(num_threads_>=0, "Option \"num_threads\" must be nonnegative");
+    if (num_threads_==0) {
+#ifdef USE_CXX11
+      num_threads_ = thread::hardware_concurrency();
+#elif !defined(_WIN32)
+      num_threads_ = sysconf(_SC_NPROCESSORS_ONLN);
+#endif // USE_CXX11
+    }
+    num_threads_ = max(1, min(num_threads_, static_cast<int>(funcs_.size())));
+#ifdef USE_CXX11
+    delete pool_;
+    pool_ = 0;
+#endif // USE_CXX11
+    stopWorkers();
+
     // Check if a node is a copy of another
     copy_of_.resize(funcs_.size(), -1);
     map<void*, int> is_copy_of;
@@ -80,12 +140,21 @@ namespace casadi {
       // Initialize
       it->init(false);
 
-      // Make sure that the functions are unique if we are using OpenMP
-      if (mode_==OPENMP && it!=funcs_.begin())
+      // Make sure that the functions are unique if evaluated in parallel,
+      // unless they can be evaluated re-entrantly with a separate memory object
+      if ((mode_==OPENMP || mode_==THREADPOOL) && it!=funcs_.begin() && !it->isReentrant())
         it->makeUnique();
 
     }
 
+    // Allocate memory for the re-entrant evaluation
+    reentrant_.resize(funcs_.size());
+    mem_.resize(funcs_.size());
+    for (int i=0; i<funcs_.size(); ++i) {
+      reentrant_[i] = funcs_[i].isReentrant();
+      if (reentrant_[i]) mem_[i] = funcs_[i].allocMemory();
+    }
+
     // Clear the indices
     inind_.clear();   inind_.push_back(0);
     outind_.clear();  outind_.push_back(0);
@@ -164,16 +233,259 @@ namespace casadi {
       casadi_error("ParallelizerInternal::evaluate: OPENMP support was not available "
                    "during CasADi compilation");
 #endif //WITH_OPENMP
+    } else if (mode_== THREADPOOL) {
+#ifdef USE_CXX11
+      // Create the thread pool, the threads are kept alive between calls
+      if (pool_==0) pool_ = new ThreadPool(num_threads_);
+
+      // Collect statistics for each task
+      int ntask = funcs_.size();
+      std::vector<int> task_allocation(ntask), task_order(ntask);
+      std::vector<double> task_starttime(ntask), task_endtime(ntask), task_cputime(ntask);
+      std::vector<int> cnt(pool_->size(), 0);
+      typedef chrono::steady_clock Clock;
+      Clock::time_point start = Clock::now();
+      pool_->run(ntask, [&](int task, int thread) {
+          task_allocation[task] = thread;
+          task_order[task] = cnt[thread]++;
+          task_starttime[task] = chrono::duration<double>(Clock::now()-start).count();
+
+          // Do the actual work
+          evaluateTask(task);
+
+          task_endtime[task] = chrono::duration<double>(Clock::now()-start).count();
+          task_cputime[task] = task_endtime[task] - task_starttime[task];
+        });
+      if (gather_stats_) {
+        stats_["num_threads"] = pool_->size();
+        stats_["task_allocation"] = task_allocation;
+        stats_["task_order"] = task_order;
+        stats_["task_cputime"] = task_cputime;
+        stats_["task_starttime"] = task_starttime;
+        stats_["task_endtime"] = task_endtime;
+      }
+#endif // USE_CXX11
+    } else if (mode_ == PROCESS) {
+      evaluateProcess();
     } else if (mode_ == MPI) {
       casadi_error("ParallelizerInternal::evaluate: MPI not implemented");
     }
   }
 
+#ifndef _WIN32
+  /// Write to a socket, returns false on failure
+  static bool sendAll(int fd, const void* buf, size_t n) {
+    const char* p = static_cast<const char*>(buf);
+    while (n>0) {
+#ifdef MSG_NOSIGNAL
+      ssize_t k = send(fd, p, n, MSG_NOSIGNAL);
+#else // MSG_NOSIGNAL
+      ssize_t k = send(fd, p, n, 0);
+#endif // MSG_NOSIGNAL
+      if (k<0 && errno==EINTR) continue;
+      if (k<=0) return false;
+      p += k;
+      n -= k;
+    }
+    return true;
+  }
+
+  /// Read from a socket, returns false on failure or if the other end was closed
+  static bool recvAll(int fd, void* buf, size_t n) {
+    char* p = static_cast<char*>(buf);
+    while (n>0) {
+      ssize_t k = recv(fd, p, n, 0);
+      if (k<0 && errno==EINTR) continue;
+      if (k<=0) return false;
+      p += k;
+      n -= k;
+    }
+    return true;
+  }
+#endif // _WIN32
+
+  void ParallelizerInternal::startWorkers() {
+#ifndef _WIN32
+    for (int w=0; w<num_threads_; ++w) {
+      // Create a pair of connected local sockets
+      int sv[2];
+      casadi_assert_message(socketpair(AF_UNIX, SOCK_STREAM, 0, sv)==0,
+                            "ParallelizerInternal: socketpair failed: " << strerror(errno));
+
+      // Spawn the worker, which gets a copy of the initialized functions
+      pid_t pid = fork();
+      casadi_assert_message(pid>=0, "ParallelizerInternal: fork failed: " << strerror(errno));
+      if (pid==0) {
+        // Child: close the sockets of the parent
+        close(sv[0]);
+        for (int k=0; k<worker_fd_.size(); ++k) close(worker_fd_[k]);
+        workerLoop(sv[1]);
+        _exit(0);
+      }
+
+      // Parent
+      close(sv[1]);
+      worker_pid_.push_back(pid);
+      worker_fd_.push_back(sv[0]);
+    }
+#endif // _WIN32
+  }
+
+  void ParallelizerInternal::stopWorkers() {
+#ifndef _WIN32
+    for (int w=0; w<worker_fd_.size(); ++w) {
+      // Request the worker to terminate
+      int task = -1;
+      sendAll(worker_fd_[w], &task, sizeof(task));
+      close(worker_fd_[w]);
+    }
+    for (int w=0; w<worker_pid_.size(); ++w) {
+      waitpid(worker_pid_[w], 0, 0);
+    }
+#endif // _WIN32
+    worker_fd_.clear();
+    worker_pid_.clear();
+  }
+
+  void ParallelizerInternal::workerLoop(int fd) {
+#ifndef _WIN32
+    while (true) {
+      // Get the next task, negative means terminate
+      int task;
+      if (!recvAll(fd, &task, sizeof(task)) || task<0) return;
+
+      // Receive the input nonzeros
+      for (int j=inind_[task]; j<inind_[task+1]; ++j) {
+        if (!recvAll(fd, getPtr(input(j).data()), input(j).size()*sizeof(double))) return;
+      }
+
+      // Evaluate, catching any errors
+      string msg;
+      try {
+        evaluateTask(task);
+      } catch(exception& e) {
+        msg = e.what();
+        if (msg.empty()) msg = "Unknown error";
+      }
+
+      // Send the status (length of the error message) and the results or error message
+      int status = msg.size();
+      if (!sendAll(fd, &status, sizeof(status))) return;
+      if (status==0) {
+        for (int j=outind_[task]; j<outind_[task+1]; ++j) {
+          if (!sendAll(fd, getPtr(output(j).data()), output(j).size()*sizeof(double))) return;
+        }
+      } else {
+        if (!sendAll(fd, msg.c_str(), msg.size())) return;
+      }
+    }
+#endif // _WIN32
+  }
+
+  void ParallelizerInternal::sendTask(int w, int task) {
+#ifndef _WIN32
+    bool ok = sendAll(worker_fd_[w], &task, sizeof(task));
+    for (int j=inind_[task]; ok && j<inind_[task+1]; ++j) {
+      ok = sendAll(worker_fd_[w], getPtr(input(j).data()), input(j).size()*sizeof(double));
+    }
+    casadi_assert_message(ok, "ParallelizerInternal: Lost connection to worker process "
+                          << worker_pid_[w]);
+#endif // _WIN32
+  }
+
+  std::string ParallelizerInternal::receiveResult(int w, int task) {
+#ifndef _WIN32
+    int status;
+    bool ok = recvAll(worker_fd_[w], &status, sizeof(status));
+    if (ok && status==0) {
+      for (int j=outind_[task]; ok && j<outind_[task+1]; ++j) {
+        ok = recvAll(worker_fd_[w], getPtr(output(j).data()), output(j).size()*sizeof(double));
+      }
+    } else if (ok) {
+      string msg(status, ' ');
+      ok = recvAll(worker_fd_[w], &msg[0], status);
+      if (ok) return msg;
+    }
+    casadi_assert_message(ok, "ParallelizerInternal: Lost connection to worker process "
+                          << worker_pid_[w]);
+#endif // _WIN32
+    return string();
+  }
+
+  void ParallelizerInternal::evaluateProcess() {
+#ifndef _WIN32
+    // Spawn the workers at the first evaluation
+    if (worker_fd_.empty()) startWorkers();
+    int nworkers = worker_fd_.size();
+    int ntask = funcs_.size();
+
+    // A failure in the communication leaves tasks with the workers and the sockets out of
+    // sync: terminate the workers, they are spawned again at the next evaluation
+    string error;
+    try {
+      // Task assigned to each worker, -1 if idle
+      vector<int> worker_task(nworkers, -1);
+
+      // Hand out one task to each worker
+      int next_task = 0;
+      for (int w=0; w<nworkers && next_task<ntask; ++w) {
+        sendTask(w, next_task);
+        worker_task[w] = next_task++;
+      }
+
+      // Collect results, handing out the remaining tasks to the workers that finish first
+      int nfinished = 0;
+      vector<pollfd> fds(nworkers);
+      while (nfinished<ntask) {
+        for (int w=0; w<nworkers; ++w) {
+          fds[w].fd = worker_task[w]>=0 ? worker_fd_[w] : -1; // negative fd: ignored
+          fds[w].events = POLLIN;
+          fds[w].revents = 0;
+        }
+        int r = poll(getPtr(fds), nworkers, -1);
+        if (r<0 && errno==EINTR) continue;
+        casadi_assert_message(r>0, "ParallelizerInternal: poll failed: " << strerror(errno));
+        for (int w=0; w<nworkers; ++w) {
+          if (worker_task[w]<0 || fds[w].revents==0) continue;
+          string msg = receiveResult(w, worker_task[w]);
+          if (!msg.empty() && error.empty()) {
+            stringstream ss;
+            ss << "Task " << worker_task[w] << " failed in worker process " << worker_pid_[w]
+               << ":" << endl << msg;
+            error = ss.str();
+          }
+          nfinished++;
+          worker_task[w] = -1;
+          if (next_task<ntask) {
+            sendTask(w, next_task);
+            worker_task[w] = next_task++;
+          }
+        }
+      }
+    } catch(...) {
+      for (int w=0; w<worker_pid_.size(); ++w) kill(worker_pid_[w], SIGKILL);
+      stopWorkers();
+      throw;
+    }
+    casadi_assert_message(error.empty(), error);
+#endif // _WIN32
+  }
+
   void ParallelizerInternal::evaluateTask(int task) {
 
     // Get a reference to the function
     Function& fcn = funcs_[task];
 
+    // Evaluate directly from and to the parallelizer inputs and outputs if possible
+    if (reentrant_[task]) {
+      vector<const double*> arg(inind_[task+1]-inind_[task]);
+      for (int j=0; j<arg.size(); ++j) arg[j] = getPtr(input(inind_[task]+j).data());
+      vector<double*> res(outind_[task+1]-outind_[task]);
+      for (int j=0; j<res.size(); ++j) res[j] = getPtr(output(outind_[task]+j).data());
+      fcn.evaluate(getPtr(arg), getPtr(res), mem_[task]);
+      return;
+    }
+
     // Copy inputs to functions
     for (int j=inind_[task]; j<inind_[task+1]; ++j) {
       fcn.input(j-inind_[task]).set(input(j));
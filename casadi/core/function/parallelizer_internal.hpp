@@ -34,6 +34,9 @@
 
 namespace casadi {
 
+  // Forward declaration
+  class ThreadPool;
+
   /** \brief  Internal node class for Parallelizer
       \author Joel Andersson
       \date 2010
@@ -49,6 +52,9 @@ namespace casadi {
     /// clone
     virtual ParallelizerInternal* clone() const {
       ParallelizerInternal* ret = new ParallelizerInternal(*this);
+      ret->pool_ = 0; // Threads are not shared, a new pool is created when needed
+      ret->worker_pid_.clear(); // Neither are worker processes
+      ret->worker_fd_.clear();
       for (std::vector<Function>::iterator it=ret->funcs_.begin(); it!=ret->funcs_.end(); ++it) {
         it->makeUnique();
       }
@@ -75,6 +81,24 @@ namespace casadi {
      */
     void spEvaluateTask(bool use_fwd, int task);
 
+    /// Evaluate all tasks in worker processes
+    void evaluateProcess();
+
+    /// Spawn the worker processes
+    void startWorkers();
+
+    /// Terminate the worker processes
+    void stopWorkers();
+
+    /// Main loop of a worker process, communicating through a socket
+    void workerLoop(int fd);
+
+    /// Send a task and its input nonzeros to a worker process
+    void sendTask(int w, int task);
+
+    /// Receive the output nonzeros of a task from a worker, returns an error message, if any
+    std::string receiveResult(int w, int task);
+
     /// Is the class able to propagate seeds through the algorithm?
     virtual bool spCanEvaluate(bool fwd) { return true;}
 
@@ -105,11 +129,29 @@ namespace casadi {
     /// Is a function a copy of another
     std::vector<int> copy_of_;
 
+    /// Can a function be evaluated re-entrantly
+    std::vector<bool> reentrant_;
+
+    /// Memory for the re-entrant evaluation, one per task
+    std::vector<FunctionMemory> mem_;
+
     /// Parallelization modes
-    enum Mode {SERIAL, OPENMP, MPI};
+    enum Mode {SERIAL, OPENMP, THREADPOOL, PROCESS, MPI};
 
     /// Mode
     Mode mode_;
+
+    /// Number of threads in the thread pool
+    int num_threads_;
+
+    /// Thread pool, created at the first evaluation
+    ThreadPool* pool_;
+
+    /// Process ids of the worker processes, spawned at the first evaluation
+    std::vector<int> worker_pid_;
+
+    /// Sockets connected to the worker processes
+    std::vector<int> worker_fd_;
   };
 
 
@@ -27,7 +27,10 @@
 #include "integrator_internal.hpp"
 #include "../std_vector_tools.hpp"
 #include "sx_function.hpp"
+#include "mx_function.hpp"
+#include "parallelizer.hpp"
 #include "../sx/sx_tools.hpp"
+#include "../mx/mx_tools.hpp"
 
 INPUTSCHEME(IntegratorInput)
 
@@ -41,6 +44,25 @@ namespace casadi {
       integrator_(integrator), output_fcn_(output_fcn), grid_(grid) {
     setOption("name", "unnamed simulator");
     addOption("monitor",      OT_STRINGVECTOR, GenericType(),  "", "initial|step", true);
+    addOption("num_threads",  OT_INTEGER,      1,
+              "Number of threads used to calculate forward sensitivities, and to integrate "
+              "the time slices of the Parareal iteration. The forward directions are split "
+              "into (at most) this number of batches, each batch simulated by its own "
+              "augmented integrator.");
+    addOption("parareal",     OT_BOOLEAN,      false,
+              "Integrate the time slices of the grid in parallel with the Parareal iteration");
+    addOption("parareal_slices", OT_INTEGER,   0,
+              "Number of time slices in the Parareal iteration (0: one slice per thread)");
+    addOption("parareal_tol", OT_REAL,         1e-8,
+              "Stop the Parareal iteration when the relative change of the states at the "
+              "start of the time slices is below this tolerance");
+    addOption("parareal_max_iter", OT_INTEGER, 0,
+              "Maximum number of Parareal iterations (0: the number of time slices, after which "
+              "the iteration has reproduced the sequential integration)");
+    addOption("coarse_integrator", OT_STRING,  "rk",
+              "Integrator plugin used for the coarse propagation in the Parareal iteration");
+    addOption("coarse_integrator_options", OT_DICTIONARY, GenericType(),
+              "Options to be passed to the coarse integrator");
 
     input_.scheme = SCHEME_IntegratorInput;
   }
@@ -53,6 +75,8 @@ namespace casadi {
     FunctionInternal::deepCopyMembers(already_copied);
     integrator_ = deepcopy(integrator_, already_copied);
     output_fcn_ = deepcopy(output_fcn_, already_copied);
+    fine_ = deepcopy(fine_, already_copied);
+    coarse_ = deepcopy(coarse_, already_copied);
   }
 
   void SimulatorInternal::init() {
@@ -133,9 +157,83 @@ namespace casadi {
 
     // Output iterators
     output_its_.resize(getNumOutputs());
+
+    // Read options
+    num_threads_ = getOption("num_threads");
+    casadi_assert_message(num_threads_>=1, "Option \"num_threads\" must be positive");
+    parareal_ = getOption("parareal");
+
+    // Set up the Parareal iteration
+    slice_.clear();
+    fine_ = Function();
+    coarse_.clear();
+    if (parareal_) {
+      casadi_assert_message(integrator_->nz_==0, "SimulatorInternal::init: The Parareal "
+                            "iteration is only implemented for ODEs, the DAE has "
+                            << integrator_->nz_ << " algebraic states");
+      int nslice = getOption("parareal_slices");
+      if (nslice==0) nslice = num_threads_;
+      nslice = std::min(nslice, static_cast<int>(grid_.size())-1);
+      casadi_assert_message(nslice>=1, "SimulatorInternal::init: The Parareal iteration "
+                            "requires a time grid with at least two points");
+      parareal_tol_ = getOption("parareal_tol");
+      parareal_max_iter_ = getOption("parareal_max_iter");
+      if (parareal_max_iter_==0) parareal_max_iter_ = nslice;
+
+      // Distribute the grid intervals evenly over the time slices
+      for (int s=0; s<=nslice; ++s) {
+        slice_.push_back((s*(static_cast<int>(grid_.size())-1))/nslice);
+      }
+
+      // Arguments of the output function of the time slices
+      vector<MX> arg(DAE_NUM_IN);
+      arg[DAE_T] = MX::sym("t");
+      arg[DAE_X] = MX::sym("x", integrator_.input(INTEGRATOR_X0).sparsity());
+      arg[DAE_Z] = MX::sym("z", integrator_.input(INTEGRATOR_Z0).sparsity());
+      arg[DAE_P] = MX::sym("p", integrator_.input(INTEGRATOR_P).sparsity());
+      vector<MX> output_arg(DAE_NUM_IN);
+      for (int i=0; i<DAE_NUM_IN; ++i) {
+        const Sparsity& sp = output_fcn_.input(i).sparsity();
+        output_arg[i] = sp.isEmpty() ? MX::zeros(sp) : arg[i];
+      }
+
+      // Fine propagator: a simulator for each time slice, with its own integrator and its
+      // own copy of the output function, the state is an additional output
+      vector<Function> fine(nslice);
+      for (int s=0; s<nslice; ++s) {
+        vector<MX> res = deepcopy(output_fcn_).call(output_arg);
+        res.push_back(vec(arg[DAE_X]));
+        MXFunction slice_output_fcn(arg, res);
+        vector<double> slice_grid(grid_.begin()+slice_[s], grid_.begin()+slice_[s+1]+1);
+        fine[s] = Simulator(deepcopy(integrator_), slice_output_fcn, slice_grid);
+      }
+      fine_ = Parallelizer(fine);
+      fine.clear(); // The simulators are already unique
+      fine_.setOption("parallelization", "threadpool");
+      fine_.setOption("num_threads", num_threads_);
+      fine_.init();
+
+      // Coarse propagator: an integrator for each time slice
+      string coarse_integrator = getOption("coarse_integrator").toString();
+      coarse_.resize(nslice);
+      for (int s=0; s<nslice; ++s) {
+        coarse_[s] = Integrator(coarse_integrator, integrator_->f_);
+        if (hasSetOption("coarse_integrator_options")) {
+          coarse_[s].setOption(getOption("coarse_integrator_options"));
+        }
+        coarse_[s].setOption("t0", grid_[slice_[s]]);
+        coarse_[s].setOption("tf", grid_[slice_[s+1]]);
+        coarse_[s].init();
+      }
+    }
   }
 
   void SimulatorInternal::evaluate() {
+    // Integrate the time slices in parallel
+    if (parareal_) {
+      evaluateParareal();
+      return;
+    }
 
     // Pass the parameters and initial state
     integrator_.setInput(input(INTEGRATOR_X0), INTEGRATOR_X0);
@@ -200,4 +298,171 @@ namespace casadi {
     }
   }
 
+  void SimulatorInternal::evaluateParareal() {
+    const int nslice = slice_.size()-1;
+    const int n_out = getNumOutputs();
+    const int nx = input(INTEGRATOR_X0).size();
+
+    // Parameters and the initial guess for the algebraic variables do not change
+    for (int s=0; s<nslice; ++s) {
+      fine_.setInput(input(INTEGRATOR_Z0), s*INTEGRATOR_NUM_IN + INTEGRATOR_Z0);
+      fine_.setInput(input(INTEGRATOR_P), s*INTEGRATOR_NUM_IN + INTEGRATOR_P);
+      coarse_[s].setInput(input(INTEGRATOR_Z0), INTEGRATOR_Z0);
+      coarse_[s].setInput(input(INTEGRATOR_P), INTEGRATOR_P);
+    }
+
+    // State at the start of each time slice, current and next iterate
+    vector<vector<double> > u(nslice, input(INTEGRATOR_X0).data()), u_next(u);
+
+    // Coarse propagation of each time slice in the last iteration
+    vector<vector<double> > g(nslice);
+
+    // Initial guess by a coarse propagation over all time slices
+    for (int s=0; s+1<nslice; ++s) {
+      coarse_[s].setInput(u[s], INTEGRATOR_X0);
+      coarse_[s].evaluate();
+      g[s] = coarse_[s].output(INTEGRATOR_XF).data();
+      u[s+1] = g[s];
+    }
+
+    int iter;
+    for (iter=1; ; ++iter) {
+      // Fine propagation of all time slices in parallel
+      for (int s=0; s<nslice; ++s) {
+        fine_.setInput(u[s], s*INTEGRATOR_NUM_IN + INTEGRATOR_X0);
+      }
+      fine_.evaluate();
+
+      // After as many iterations as time slices, the fine propagation is exact
+      if (iter>=parareal_max_iter_) break;
+
+      // Sequential correction with the coarse propagator
+      double du = 0;
+      for (int s=0; s+1<nslice; ++s) {
+        coarse_[s].setInput(u_next[s], INTEGRATOR_X0);
+        coarse_[s].evaluate();
+        const vector<double>& g_next = coarse_[s].output(INTEGRATOR_XF).data();
+
+        // State at the end of the time slice in the fine propagation
+        const vector<double>& f = fine_.output(s*(n_out+1) + n_out).data();
+        vector<double>::const_iterator f_end = f.end()-nx;
+
+        // Correct the start of the next time slice
+        for (int i=0; i<nx; ++i) {
+          u_next[s+1][i] = g_next[i] + f_end[i] - g[s][i];
+          du = std::max(du, fabs(u_next[s+1][i]-u[s+1][i])/(1+fabs(u_next[s+1][i])));
+        }
+        g[s] = g_next;
+      }
+
+      // The change of the states is small enough for the last fine propagation to be accepted
+      if (du<=parareal_tol_) break;
+      u = u_next;
+    }
+    if (gather_stats_) stats_["parareal_iter"] = iter;
+
+    // Collect the outputs of the time slices, the last slice ends at the last grid point
+    for (int s=0; s<nslice; ++s) {
+      int ncol = slice_[s+1] - slice_[s] + (s+1==nslice ? 1 : 0);
+      for (int i=0; i<n_out; ++i) {
+        const vector<double>& res = fine_.output(s*(n_out+1) + i).data();
+        int nrow = output(i).size1();
+        copy(res.begin(), res.begin()+ncol*nrow, output(i).begin()+slice_[s]*nrow);
+      }
+    }
+  }
+
+  Function SimulatorInternal::getJacobian(int iind, int oind, bool compact, bool symmetric) {
+    vector<MX> arg = symbolicInput();
+    vector<MX> res = shared_from_this<Function>().call(arg);
+    MXFunction f(arg, res);
+    f.setOption("ad_mode", "forward");
+    f.init();
+    return f.jacobian(iind, oind, compact, symmetric);
+  }
+
+  Function SimulatorInternal::getDerivative(int nfwd, int nadj) {
+    casadi_assert_message(nadj==0, "SimulatorInternal::getDerivative: "
+                          "Adjoint sensitivities are not supported");
+
+    // Simulate batches of forward directions in parallel if there is more than one batch
+    if (num_threads_>1 && nfwd>1) {
+      return getParallelDerivative(nfwd, nadj, num_threads_);
+    } else {
+      return getDerivativeBatch(nfwd, nadj);
+    }
+  }
+
+  Function SimulatorInternal::getDerivativeBatch(int nfwd, int nadj) {
+    casadi_assert_message(nadj==0, "SimulatorInternal::getDerivativeBatch: "
+                          "Adjoint sensitivities are not supported");
+
+    // Integrator for the augmented DAE
+    IntegratorInternal::AugOffset offset;
+    Integrator integrator = integrator_->getAugmentedIntegrator(nfwd, 0, offset);
+
+    // Arguments of the augmented output function
+    vector<MX> aug_arg(DAE_NUM_IN);
+    aug_arg[DAE_T] = MX::sym("t", output_fcn_.input(DAE_T).sparsity());
+    aug_arg[DAE_X] = MX::sym("x", integrator.input(INTEGRATOR_X0).sparsity());
+    aug_arg[DAE_Z] = MX::sym("z", integrator.input(INTEGRATOR_Z0).sparsity());
+    aug_arg[DAE_P] = MX::sym("p", integrator.input(INTEGRATOR_P).sparsity());
+
+    // Nondifferentiated arguments and forward seeds of the output function
+    vector<MX> x_dir, z_dir, p_dir;
+    if (integrator_->nx_>0) x_dir = horzsplit(aug_arg[DAE_X], offset.x);
+    if (integrator_->nz_>0) z_dir = horzsplit(aug_arg[DAE_Z], offset.z);
+    if (integrator_->np_>0) p_dir = horzsplit(aug_arg[DAE_P], offset.p);
+    vector<MX> output_arg, dd(DAE_NUM_IN);
+    output_arg.reserve(DAE_NUM_IN*(1+nfwd));
+    for (int dir=-1; dir<nfwd; ++dir) {
+      for (int i=0; i<DAE_NUM_IN; ++i) dd[i] = MX::zeros(output_fcn_.input(i).sparsity());
+      if (dir<0) dd[DAE_T] = aug_arg[DAE_T];
+      if (!x_dir.empty() && !output_fcn_.input(DAE_X).isEmpty()) dd[DAE_X] = x_dir[1+dir];
+      if (!z_dir.empty() && !output_fcn_.input(DAE_Z).isEmpty()) dd[DAE_Z] = z_dir[1+dir];
+      if (!p_dir.empty() && !output_fcn_.input(DAE_P).isEmpty()) dd[DAE_P] = p_dir[1+dir];
+      output_arg.insert(output_arg.end(), dd.begin(), dd.end());
+    }
+
+    // Output function of the augmented DAE: the outputs and their forward sensitivities
+    MXFunction output_fcn(aug_arg, output_fcn_.derivative(nfwd, 0).call(output_arg));
+
+    // Simulator for the augmented DAE
+    Simulator simulator(integrator, output_fcn, grid_);
+    simulator.init();
+
+    // All inputs of the return function: nondifferentiated inputs and forward seeds
+    vector<MX> ret_in = symbolicInput();
+    ret_in.reserve(INTEGRATOR_NUM_IN*(1+nfwd));
+    stringstream ss;
+    for (int dir=0; dir<nfwd; ++dir) {
+      for (int i=0; i<INTEGRATOR_NUM_IN; ++i) {
+        ss.str("");
+        ss << "fwd" << dir << "_" << ret_in[i];
+        ret_in.push_back(MX::sym(ss.str(), input(i).sparsity()));
+      }
+    }
+
+    // Augmented state, parameter and initial guess for the algebraic variables
+    MX x0_aug, p_aug, z0_aug;
+    for (int dir=-1; dir<nfwd; ++dir) {
+      vector<MX>::const_iterator dd_it = ret_in.begin() + INTEGRATOR_NUM_IN*(1+dir);
+      x0_aug.appendColumns(dd_it[INTEGRATOR_X0]);
+      p_aug.appendColumns(dd_it[INTEGRATOR_P]);
+      z0_aug.appendColumns(dd_it[INTEGRATOR_Z0]);
+    }
+
+    // Call the simulator, the backward problem is not simulated
+    vector<MX> simulator_in(INTEGRATOR_NUM_IN);
+    for (int i=0; i<INTEGRATOR_NUM_IN; ++i) {
+      simulator_in[i] = MX::zeros(simulator.input(i).sparsity());
+    }
+    simulator_in[INTEGRATOR_X0] = x0_aug;
+    simulator_in[INTEGRATOR_P] = p_aug;
+    simulator_in[INTEGRATOR_Z0] = z0_aug;
+
+    // Create derivative function and return
+    return MXFunction(ret_in, simulator.call(simulator_in));
+  }
+
 } // namespace casadi
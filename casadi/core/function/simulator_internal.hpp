@@ -59,6 +59,19 @@ namespace casadi {
     /** \brief  Integrate */
     virtual void evaluate();
 
+    /** \brief  Integrate with the Parareal iteration */
+    void evaluateParareal();
+
+    /** \brief Calculate the jacobian of output \a oind with respect to input \a iind */
+    virtual Function getJacobian(int iind, int oind, bool compact, bool symmetric);
+
+    /** \brief Generate a function that calculates \a nfwd forward derivatives */
+    virtual Function getDerivative(int nfwd, int nadj);
+
+    /** \brief Generate a function that calculates \a nfwd forward derivatives
+     *  with a single simulator of the augmented DAE */
+    virtual Function getDerivativeBatch(int nfwd, int nadj);
+
     // Integrator instance
     Integrator integrator_;
 
@@ -70,6 +83,23 @@ namespace casadi {
 
     // Iterators to current outputs
     std::vector<std::vector<double>::iterator> output_its_;
+
+    // Number of threads for the forward sensitivities and the Parareal iteration
+    int num_threads_;
+
+    // Parareal iteration
+    bool parareal_;
+    int parareal_max_iter_;
+    double parareal_tol_;
+
+    // Parareal: index of the first grid point of each time slice, and the last grid point
+    std::vector<int> slice_;
+
+    // Parareal: simulators of all time slices (fine propagator), evaluated in parallel
+    Function fine_;
+
+    // Parareal: integrator of each time slice (coarse propagator)
+    std::vector<Integrator> coarse_;
   };
 
 } // namespace casadi
@@ -0,0 +1,230 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "sparsity_cache.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#else
+#include <process.h>
+#endif
+
+using namespace std;
+
+namespace casadi {
+
+  namespace {
+    /// Identifies a sparsity cache file
+    const char sparsity_cache_magic[8] = {'C', 'A', 'S', 'A', 'D', 'I', 'S', 'P'};
+
+    /// Increase when the file format changes
+    const int sparsity_cache_version = 2;
+
+    /// Read a value from a memory block, advancing the position
+    template<typename T>
+    bool readValue(const char*& p, const char* end, T& v) {
+      if (end-p < static_cast<ptrdiff_t>(sizeof(T))) return false;
+      memcpy(&v, p, sizeof(T));
+      p += sizeof(T);
+      return true;
+    }
+
+    /// Read a vector of ints from a memory block, advancing the position
+    bool readInts(const char*& p, const char* end, int n, vector<int>& v) {
+      if (n<0 || (end-p)/static_cast<ptrdiff_t>(sizeof(int)) < n) return false;
+      v.resize(n);
+      if (n>0) memcpy(&v.front(), p, n*sizeof(int));
+      p += n*sizeof(int);
+      return true;
+    }
+
+    /// Read a list of patterns from a memory block, advancing the position
+    bool readPatterns(const char*& p, const char* end, vector<Sparsity>& sp) {
+      int n;
+      if (!readValue(p, end, n) || n<0) return false;
+      sp.resize(n);
+      vector<int> colind, row;
+      for (int k=0; k<n; ++k) {
+        int nrow, ncol;
+        if (!readValue(p, end, nrow)) return false;
+        if (nrow==-1) {
+          sp[k] = Sparsity();
+          continue;
+        }
+        if (!readValue(p, end, ncol) || nrow<0 || ncol<0) return false;
+        if (!readInts(p, end, ncol+1, colind)) return false;
+        if (colind.front()!=0) return false;
+        for (int c=0; c<ncol; ++c) if (colind[c]>colind[c+1]) return false;
+        if (!readInts(p, end, colind.back(), row)) return false;
+        for (vector<int>::const_iterator r=row.begin(); r!=row.end(); ++r) {
+          if (*r<0 || *r>=nrow) return false;
+        }
+        sp[k] = Sparsity(nrow, ncol, colind, row);
+      }
+      return true;
+    }
+
+    /// Write a value to a stream
+    template<typename T>
+    void writeValue(ostream& s, const T& v) {
+      s.write(reinterpret_cast<const char*>(&v), sizeof(T));
+    }
+
+    /// Write a list of patterns to a stream
+    void writePatterns(ostream& s, const vector<Sparsity>& sp) {
+      writeValue(s, static_cast<int>(sp.size()));
+      for (vector<Sparsity>::const_iterator k=sp.begin(); k!=sp.end(); ++k) {
+        if (k->isNull()) {
+          writeValue(s, -1);
+          continue;
+        }
+        writeValue(s, k->size1());
+        writeValue(s, k->size2());
+        const vector<int>& colind = k->colind();
+        const vector<int>& row = k->row();
+        s.write(reinterpret_cast<const char*>(&colind.front()), colind.size()*sizeof(int));
+        if (!row.empty()) {
+          s.write(reinterpret_cast<const char*>(&row.front()), row.size()*sizeof(int));
+        }
+      }
+    }
+
+    /// Check if two lists of patterns are identical
+    bool samePatterns(const vector<Sparsity>& a, const vector<Sparsity>& b) {
+      if (a.size()!=b.size()) return false;
+      for (int k=0; k<a.size(); ++k) {
+        if (a[k].isNull() || b[k].isNull()) {
+          if (a[k].isNull()!=b[k].isNull()) return false;
+        } else if (!a[k].isEqual(b[k])) {
+          return false;
+        }
+      }
+      return true;
+    }
+  } // namespace
+
+  std::string SparsityCache::fileName(const std::string& dir, std::size_t key) {
+    stringstream ss;
+    ss << dir;
+    if (!dir.empty() && dir[dir.size()-1]!='/') ss << "/";
+    ss << "casadi_sparsity_" << hex << setw(2*sizeof(size_t)) << setfill('0') << key << ".bin";
+    return ss.str();
+  }
+
+  bool SparsityCache::decode(const char* data, std::size_t size, std::size_t key,
+                             std::size_t check, const std::vector<Sparsity>& ref,
+                             std::vector<Sparsity>& sp) {
+    const char* p = data;
+    const char* end = data + size;
+
+    // Check the header
+    char magic[sizeof(sparsity_cache_magic)];
+    int version, int_size;
+    size_t stored_key, stored_check;
+    if (!readValue(p, end, magic)) return false;
+    if (memcmp(magic, sparsity_cache_magic, sizeof(magic))!=0) return false;
+    if (!readValue(p, end, version) || version!=sparsity_cache_version) return false;
+    if (!readValue(p, end, int_size) || int_size!=sizeof(int)) return false;
+    if (!readValue(p, end, stored_key) || stored_key!=key) return false;
+    if (!readValue(p, end, stored_check) || stored_check!=check) return false;
+
+    // The reference patterns must match exactly
+    vector<Sparsity> stored_ref;
+    if (!readPatterns(p, end, stored_ref) || !samePatterns(stored_ref, ref)) return false;
+
+    // Read the patterns
+    return readPatterns(p, end, sp) && p==end;
+  }
+
+  bool SparsityCache::load(const std::string& dir, std::size_t key, std::size_t check,
+                           const std::vector<Sparsity>& ref, std::vector<Sparsity>& sp) {
+    string fname = fileName(dir, key);
+#ifndef _WIN32
+    // Map the file into memory
+    int fd = open(fname.c_str(), O_RDONLY);
+    if (fd<0) return false;
+    struct stat st;
+    if (fstat(fd, &st)!=0 || st.st_size==0) {
+      close(fd);
+      return false;
+    }
+    size_t size = st.st_size;
+    void* data = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data==MAP_FAILED) return false;
+    bool ret = decode(static_cast<const char*>(data), size, key, check, ref, sp);
+    munmap(data, size);
+    return ret;
+#else // _WIN32
+    // Read the whole file into memory
+    ifstream file(fname.c_str(), ios::binary);
+    if (!file.good()) return false;
+    string data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    return decode(data.data(), data.size(), key, check, ref, sp);
+#endif // _WIN32
+  }
+
+  void SparsityCache::save(const std::string& dir, std::size_t key, std::size_t check,
+                           const std::vector<Sparsity>& ref, const std::vector<Sparsity>& sp) {
+    string fname = fileName(dir, key);
+
+    // Write to a temporary file, unique for the process
+    stringstream tmpname;
+#ifndef _WIN32
+    tmpname << fname << "." << getpid() << ".tmp";
+#else // _WIN32
+    tmpname << fname << "." << _getpid() << ".tmp";
+#endif // _WIN32
+    {
+      ofstream file(tmpname.str().c_str(), ios::binary | ios::trunc);
+      if (!file.good()) return;
+      file.write(sparsity_cache_magic, sizeof(sparsity_cache_magic));
+      writeValue(file, sparsity_cache_version);
+      writeValue(file, static_cast<int>(sizeof(int)));
+      writeValue(file, key);
+      writeValue(file, check);
+      writePatterns(file, ref);
+      writePatterns(file, sp);
+      if (!file.good()) {
+        file.close();
+        remove(tmpname.str().c_str());
+        return;
+      }
+    }
+
+    // Move into place, replacing an entry written concurrently by another process
+    if (rename(tmpname.str().c_str(), fname.c_str())!=0) {
+      remove(tmpname.str().c_str());
+    }
+  }
+
+} // namespace casadi
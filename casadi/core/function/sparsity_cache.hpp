@@ -0,0 +1,79 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_SPARSITY_CACHE_HPP
+#define CASADI_SPARSITY_CACHE_HPP
+
+#include "../matrix/sparsity.hpp"
+#include <string>
+#include <vector>
+
+/// \cond INTERNAL
+namespace casadi {
+
+  /** \brief Persistent on-disk cache of sparsity patterns
+
+      Stores lists of sparsity patterns (e.g. a Jacobian block and its seed matrices) in a
+      directory, one compact binary file per key. The key is a content hash calculated by the
+      caller, so files can be shared between processes and reused between runs. Files are
+      written to a temporary name and then renamed, so a concurrent reader never sees a
+      partially written file. Reading memory-maps the file where supported.
+
+      Since the key alone does not identify the entry, each file also holds a second hash
+      (check) and a list of reference patterns (e.g. the input and output sparsities of the
+      function), both of which must match on loading. A hash collision or a stale file then
+      reads as a cache miss instead of returning wrong patterns.
+
+      The file consists of a header (magic number, format version, sizeof(int), key and
+      check) followed by the reference patterns and the stored patterns. Each list is the
+      number of patterns followed by, for each pattern, nrow, ncol, colind and row as
+      native ints. A null pattern is stored with nrow=-1 and no further data.
+  */
+  class CASADI_EXPORT SparsityCache {
+  public:
+    /** \brief Read the patterns stored under a key
+        Returns false if there is no valid entry for the key or if the stored check value or
+        reference patterns differ from check and ref, the contents of sp are then undefined. */
+    static bool load(const std::string& dir, std::size_t key, std::size_t check,
+                     const std::vector<Sparsity>& ref, std::vector<Sparsity>& sp);
+
+    /** \brief Store patterns under a key, together with the values verified by load
+        Failing to write the file is not an error, since the cache is only an optimization. */
+    static void save(const std::string& dir, std::size_t key, std::size_t check,
+                     const std::vector<Sparsity>& ref, const std::vector<Sparsity>& sp);
+
+    /// Name of the file holding the patterns of a key
+    static std::string fileName(const std::string& dir, std::size_t key);
+
+  private:
+    /// Decode a memory block, returns false if it is not a valid entry for the key
+    static bool decode(const char* data, std::size_t size, std::size_t key, std::size_t check,
+                       const std::vector<Sparsity>& ref, std::vector<Sparsity>& sp);
+  };
+
+} // namespace casadi
+/// \endcond
+
+#endif // CASADI_SPARSITY_CACHE_HPP
@@ -140,6 +140,7 @@ const std::vector<SX> & SXFunction::outputExpr() const {
 }
 
 const vector<ScalarAtomic>& SXFunction::algorithm() const {
+  (*this)->assertAlgorithm();
   return (*this)->algorithm_;
 }
 
@@ -177,5 +178,47 @@ int SXFunction::getWorkSize() const {
   return (*this)->work_.size();
 }
 
+/// Sparsity pattern of n horizontally concatenated copies of sp
+static Sparsity repmatBatch(const Sparsity& sp, int n) {
+  const vector<int>& colind = sp.colind();
+  const vector<int>& row = sp.row();
+  vector<int> colind_n(1, 0), row_n;
+  colind_n.reserve(n*sp.size2()+1);
+  row_n.reserve(n*row.size());
+  for (int k=0; k<n; ++k) {
+    for (int c=0; c<sp.size2(); ++c) colind_n.push_back(k*row.size() + colind[c+1]);
+    row_n.insert(row_n.end(), row.begin(), row.end());
+  }
+  return Sparsity(sp.size1(), n*sp.size2(), colind_n, row_n);
+}
+
+std::vector<DMatrix> SXFunction::evaluateBatch(int n, const std::vector<DMatrix>& arg) {
+  assertInit();
+  casadi_assert_message(n>=0, "SXFunction::evaluateBatch: number of points must be nonnegative");
+  casadi_assert_message(arg.size()==getNumInputs(),
+                        "SXFunction::evaluateBatch: expecting " << getNumInputs()
+                        << " inputs, got " << arg.size());
+  vector<const double*> arg_ptr(arg.size());
+  for (int i=0; i<arg.size(); ++i) {
+    casadi_assert_message(arg[i].sparsity()==repmatBatch(input(i).sparsity(), n),
+                          "SXFunction::evaluateBatch: input " << i << " has dimension "
+                          << arg[i].dimString() << ", expecting the sparsity pattern of " << n
+                          << " horizontally concatenated copies of " << input(i).dimString());
+    arg_ptr[i] = getPtr(arg[i].data());
+  }
+  vector<DMatrix> res(getNumOutputs());
+  vector<double*> res_ptr(res.size());
+  for (int i=0; i<res.size(); ++i) {
+    res[i] = DMatrix(repmatBatch(output(i).sparsity(), n), 0);
+    res_ptr[i] = getPtr(res[i].data());
+  }
+  evaluateBatch(n, getPtr(arg_ptr), getPtr(res_ptr));
+  return res;
+}
+
+void SXFunction::evaluateBatch(int n, const double** arg, double** res) {
+  (*this)->evaluateBatch(n, arg, res);
+}
+
 } // namespace casadi
 
@@ -175,6 +175,28 @@ namespace casadi {
     /** \brief Access the algorithm directly */
     const std::vector<ScalarAtomic>& algorithm() const;
 #endif // SWIG
+/// \endcond
+
+    /** \brief Evaluate numerically at n independent points
+     *
+     * Input i is passed as the horizontal concatenation of its value at the n points,
+     * i.e. a matrix with the sparsity pattern repmat(input(i).sparsity(), 1, n).
+     * The outputs are returned in the same format. Each point gives the same result
+     * as a call to evaluate().
+     */
+    std::vector<DMatrix> evaluateBatch(int n, const std::vector<DMatrix>& arg);
+
+/// \cond INTERNAL
+#ifndef SWIG
+    /** \brief Evaluate numerically at n independent points, low-level API
+     *
+     * arg[i] (res[i]) points to the nonzeros of input (output) i at all points, stored
+     * one point after the other. Null pointers are treated as zero inputs or ignored outputs.
+     * Note that the evaluateBatch entry point of generated code (option "codegen_batch")
+     * interleaves the points instead: nonzero k of point j is stored at position k*n+j.
+     */
+    void evaluateBatch(int n, const double** arg, double** res);
+#endif // SWIG
 /// \endcond
 
     /** \brief Get the number of atomic operations */
@@ -201,7 +223,10 @@ namespace casadi {
     int countNodes() const;
 
     /** \brief Clear the function from its symbolic representation, to free up memory,
-     * no symbolic evaluations are possible after this */
+     * no symbolic evaluations are possible after this. With the option "compact_tape",
+     * only the compact tape is kept. The memory footprint is reported in the statistics
+     * (getStats), entries "memory_algorithm", "memory_compact_tape", "memory_symbolic" etc.
+     */
     void clearSymbolic();
 
     /** \brief Get all the free variables of the function */
@@ -24,12 +24,15 @@
 
 
 #include "sx_function_internal.hpp"
+#include <algorithm>
 #include <limits>
 #include <stack>
 #include <deque>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
+#include <cstring>
+#include <map>
 #include "../std_vector_tools.hpp"
 #include "../sx/sx_tools.hpp"
 #include "../sx/sx_node.hpp"
@@ -51,6 +54,20 @@ namespace casadi {
               "compilation to a CPU or GPU using OpenCL");
     addOption("just_in_time_opencl", OT_BOOLEAN, false,
               "Just-in-time compilation for numeric evaluation using OpenCL (experimental)");
+    addOption("evaluator", OT_STRING, "switch",
+              "Engine used for numeric evaluation",
+              "switch: interpret the algorithm with a switch statement|"
+              "threaded: compile the algorithm to a packed bytecode with "
+              "threaded dispatch and fused instructions");
+    addOption("compact_tape", OT_BOOLEAN, false,
+              "Store the algorithm as separate arrays of operations, indices (16 bit "
+              "where possible) and constants for numeric evaluation and sparsity "
+              "propagation. Allows clearSymbolic to release the full algorithm.");
+    addOption("cse", OT_BOOLEAN, false,
+              "Common subexpression elimination: merge constants and operations that are "
+              "structurally equal (up to the order of the arguments of commutative operations) "
+              "when building the algorithm. The node counts before and after are reported in "
+              "the statistics cse_nodes_before and cse_nodes_after.");
 
     // Check for duplicate entries among the input expressions
     bool has_duplicates = false;
@@ -82,6 +99,10 @@ namespace casadi {
 
     casadi_assert(!outputv_.empty()); // NOTE: Remove?
 
+    threaded_evaluator_ = false;
+    compact_tape_ = false;
+    algorithm_released_ = false;
+
     // Reset OpenCL memory
 #ifdef WITH_OPENCL
     kernel_ = 0;
@@ -133,19 +154,38 @@ namespace casadi {
 #endif // WITH_OPENCL
 
     // Evaluate the algorithm
-    for (vector<AlgEl>::iterator it=algorithm_.begin(); it!=algorithm_.end(); ++it) {
-      switch (it->op) {
-        // Start by adding all of the built operations
-        CASADI_MATH_FUN_BUILTIN(work_[it->i1], work_[it->i2], work_[it->i0])
+    if (threaded_evaluator_ || compact_tape_) {
+      // Get pointers to the input and output nonzeros
+      for (int ind=0; ind<bytecode_arg_.size(); ++ind) {
+        bytecode_arg_[ind] = getPtr(inputNoCheck(ind).data());
+      }
+      for (int ind=0; ind<bytecode_res_.size(); ++ind) {
+        bytecode_res_[ind] = getPtr(outputNoCheck(ind).data());
+      }
+      if (threaded_evaluator_) {
+        evaluateBytecode(getPtr(bytecode_arg_), getPtr(bytecode_res_), getPtr(work_));
+      } else if (tape_i32_.empty()) {
+        evaluateCompact(getPtr(tape_i16_), getPtr(bytecode_arg_), getPtr(bytecode_res_),
+                        getPtr(work_));
+      } else {
+        evaluateCompact(getPtr(tape_i32_), getPtr(bytecode_arg_), getPtr(bytecode_res_),
+                        getPtr(work_));
+      }
+    } else {
+      for (vector<AlgEl>::iterator it=algorithm_.begin(); it!=algorithm_.end(); ++it) {
+        switch (it->op) {
+          // Start by adding all of the built operations
+          CASADI_MATH_FUN_BUILTIN(work_[it->i1], work_[it->i2], work_[it->i0])
 
-        // Constant
-        case OP_CONST: work_[it->i0] = it->d; break;
+          // Constant
+          case OP_CONST: work_[it->i0] = it->d; break;
 
-        // Load function input to work vector
-        case OP_INPUT: work_[it->i0] = inputNoCheck(it->i1).data()[it->i2]; break;
+          // Load function input to work vector
+          case OP_INPUT: work_[it->i0] = inputNoCheck(it->i1).data()[it->i2]; break;
 
-        // Get function output from work vector
-        case OP_OUTPUT: outputNoCheck(it->i0).data()[it->i2] = work_[it->i1]; break;
+          // Get function output from work vector
+          case OP_OUTPUT: outputNoCheck(it->i0).data()[it->i2] = work_[it->i1]; break;
+        }
       }
     }
 
@@ -167,6 +207,413 @@ namespace casadi {
   }
 
 
+  void SXFunctionInternal::evalD(const double** arg, double** res, FunctionMemory& mem) {
+    if (!free_vars_.empty()) {
+      std::stringstream ss;
+      repr(ss);
+      casadi_error("Cannot evaluate \"" << ss.str() << "\" since variables "
+                   << free_vars_ << " are free.");
+    }
+
+    // Work vector owned by the caller
+    double* w = getPtr(mem.w);
+
+    // The bytecode interpreter requires all inputs and outputs to be given
+    bool all_given = threaded_evaluator_;
+    for (int ind=0; ind<getNumInputs() && all_given; ++ind) all_given = arg[ind]!=0;
+    for (int ind=0; ind<getNumOutputs() && all_given; ++ind) all_given = res[ind]!=0;
+    if (all_given) {
+      evaluateBytecode(arg, res, w);
+      return;
+    }
+
+    // Evaluate using the compact tape
+    if (compact_tape_) {
+      if (tape_i32_.empty()) {
+        evaluateCompact(getPtr(tape_i16_), arg, res, w);
+      } else {
+        evaluateCompact(getPtr(tape_i32_), arg, res, w);
+      }
+      return;
+    }
+
+    // Evaluate the algorithm
+    for (vector<AlgEl>::const_iterator it=algorithm_.begin(); it!=algorithm_.end(); ++it) {
+      switch (it->op) {
+        // Start by adding all of the built operations
+        CASADI_MATH_FUN_BUILTIN(w[it->i1], w[it->i2], w[it->i0])
+
+        // Constant
+        case OP_CONST: w[it->i0] = it->d; break;
+
+        // Load function input to work vector
+        case OP_INPUT: w[it->i0] = arg[it->i1]==0 ? 0 : arg[it->i1][it->i2]; break;
+
+        // Get function output from work vector
+        case OP_OUTPUT: if (res[it->i0]!=0) res[it->i0][it->i2] = w[it->i1]; break;
+      }
+    }
+  }
+
+  void SXFunctionInternal::allocMemory(FunctionMemory& mem) const {
+    mem.w.resize(work_.size());
+  }
+
+  void SXFunctionInternal::compactTape() {
+    casadi_assert(NUM_BUILT_IN_OPS<=256);
+
+    // Use 16 bit indices if all indices fit
+    bool short_indices = true;
+    for (vector<AlgEl>::const_iterator it=algorithm_.begin(); it!=algorithm_.end(); ++it) {
+      int imax = it->i0;
+      if (it->op!=OP_CONST && it->op!=OP_PARAMETER) imax = std::max(imax, std::max(it->i1, it->i2));
+      if (imax>numeric_limits<unsigned short>::max()) {
+        short_indices = false;
+        break;
+      }
+    }
+
+    // Separate the operations, indices and constants
+    tape_op_.clear();
+    tape_op_.reserve(algorithm_.size());
+    vector<int> idx;
+    idx.reserve(3*algorithm_.size());
+    tape_const_.clear();
+    for (vector<AlgEl>::const_iterator it=algorithm_.begin(); it!=algorithm_.end(); ++it) {
+      tape_op_.push_back(it->op);
+      idx.push_back(it->i0);
+      if (it->op==OP_CONST || it->op==OP_PARAMETER) {
+        if (it->op==OP_CONST) tape_const_.push_back(it->d);
+        idx.push_back(0);
+        idx.push_back(0);
+      } else {
+        idx.push_back(it->i1);
+        idx.push_back(it->i2);
+      }
+    }
+    if (short_indices) {
+      tape_i16_.assign(idx.begin(), idx.end());
+      vector<int>().swap(tape_i32_);
+    } else {
+      tape_i32_.swap(idx);
+      vector<unsigned short>().swap(tape_i16_);
+    }
+
+    // Pointers to the input and output nonzeros, shared with the bytecode interpreter
+    bytecode_arg_.resize(getNumInputs());
+    bytecode_res_.resize(getNumOutputs());
+
+    if (verbose()) {
+      cout << "SXFunctionInternal::compactTape: " << algorithm_.size() << " elements, "
+           << (short_indices ? 16 : 32) << " bit indices" << endl;
+    }
+  }
+
+  template<typename I>
+  void SXFunctionInternal::evaluateCompact(const I* idx, const double** arg, double** res,
+                                           double* w) const {
+    const unsigned char* op = getPtr(tape_op_);
+    const unsigned char* op_end = op + tape_op_.size();
+    const double* c = getPtr(tape_const_);
+    for (; op!=op_end; ++op, idx+=3) {
+      switch (*op) {
+        // Start by adding all of the built operations
+        CASADI_MATH_FUN_BUILTIN(w[idx[1]], w[idx[2]], w[idx[0]])
+
+        // Constant
+        case OP_CONST: w[idx[0]] = *c++; break;
+
+        // Load function input to work vector
+        case OP_INPUT: w[idx[0]] = arg[idx[1]]==0 ? 0 : arg[idx[1]][idx[2]]; break;
+
+        // Get function output from work vector
+        case OP_OUTPUT: if (res[idx[0]]!=0) res[idx[0]][idx[2]] = w[idx[1]]; break;
+      }
+    }
+  }
+
+  void SXFunctionInternal::assertAlgorithm() const {
+    casadi_assert_message(!algorithm_released_,
+                          "The algorithm of \"" << getOption("name") << "\" has been released "
+                          "by clearSymbolic, only numeric evaluation and sparsity propagation "
+                          "are possible.");
+  }
+
+  void SXFunctionInternal::updateMemoryStats() {
+    // Memory footprint in bytes of the different representations
+    stats_["memory_algorithm"] = static_cast<double>(algorithm_.capacity()*sizeof(AlgEl));
+    stats_["memory_compact_tape"] =
+      static_cast<double>(tape_op_.capacity()*sizeof(unsigned char)
+                          + tape_i16_.capacity()*sizeof(unsigned short)
+                          + tape_i32_.capacity()*sizeof(int)
+                          + tape_const_.capacity()*sizeof(double));
+    stats_["memory_bytecode"] =
+      static_cast<double>(bytecode_.capacity()*sizeof(int)
+                          + bytecode_constants_.capacity()*sizeof(double));
+    stats_["memory_work"] = static_cast<double>(work_.capacity()*sizeof(double));
+
+    // References to the expression graph, not counting the nodes themselves
+    size_t n_symbolic = s_work_.capacity() + free_vars_.capacity() + operations_.capacity()
+      + constants_.capacity();
+    for (vector<SX>::const_iterator it=inputv_.begin(); it!=inputv_.end(); ++it) {
+      n_symbolic += it->size();
+    }
+    for (vector<SX>::const_iterator it=outputv_.begin(); it!=outputv_.end(); ++it) {
+      n_symbolic += it->size();
+    }
+    stats_["memory_symbolic"] = static_cast<double>(n_symbolic*sizeof(SXElement));
+  }
+
+  // Elementary operations supported by the bytecode interpreter
+#define CASADI_BYTECODE_BUILTIN(X) \
+  X(ASSIGN) X(ADD) X(SUB) X(MUL) X(DIV) X(NEG) X(EXP) X(LOG) X(POW) X(CONSTPOW) \
+  X(SQRT) X(SQ) X(TWICE) X(SIN) X(COS) X(TAN) X(ASIN) X(ACOS) X(ATAN) \
+  X(LT) X(LE) X(EQ) X(NE) X(NOT) X(AND) X(OR) X(IF_ELSE_ZERO) \
+  X(FLOOR) X(CEIL) X(FMOD) X(FABS) X(SIGN) X(COPYSIGN) X(ERF) X(FMIN) X(FMAX) \
+  X(INV) X(SINH) X(COSH) X(TANH) X(ASINH) X(ACOSH) X(ATANH) X(ATAN2) \
+  X(ERFINV) X(LIFT) X(PRINTME)
+
+  /** \brief Opcodes of the bytecode interpreter
+   * Elementary operations have the layout [op, i0, i1, i2], meaning w[i0] = op(w[i1], w[i2]).
+   * Superinstructions execute two consecutive operations of the algorithm with one dispatch.
+   */
+  enum BytecodeOp {
+    // End of the bytecode: []
+    BC_END,
+    // Constant: [k, i0], w[i0] = c[k]
+    BC_CONST,
+    // Input nonzero: [ind, nz, i0], w[i0] = x[ind][nz]
+    BC_INPUT,
+    // Output nonzero: [ind, nz, i1], r[ind][nz] = w[i1]
+    BC_OUTPUT,
+    // Multiplication followed by addition: [i0, i1, i2, j0, j1, j2]
+    BC_MUL_ADD,
+    // Constant followed by a binary operation: [k, i0, j0, j1, j2]
+    BC_CONST_ADD, BC_CONST_SUB, BC_CONST_MUL, BC_CONST_DIV,
+#define CASADI_BYTECODE_ENUM(OP) BC_##OP,
+    CASADI_BYTECODE_BUILTIN(CASADI_BYTECODE_ENUM)
+#undef CASADI_BYTECODE_ENUM
+    BC_NUM_OPS
+  };
+
+  void SXFunctionInternal::compileBytecode() {
+    bytecode_.clear();
+    bytecode_.reserve(4*algorithm_.size()+1);
+    bytecode_constants_.clear();
+
+    for (vector<AlgEl>::const_iterator it=algorithm_.begin(); it!=algorithm_.end(); ++it) {
+      // Next element of the algorithm, if any
+      vector<AlgEl>::const_iterator next = it+1;
+      bool has_next = next!=algorithm_.end();
+
+      // Multiplication fused with the addition that follows
+      if (it->op==OP_MUL && has_next && next->op==OP_ADD) {
+        bytecode_.push_back(BC_MUL_ADD);
+        bytecode_.push_back(it->i0);
+        bytecode_.push_back(it->i1);
+        bytecode_.push_back(it->i2);
+        bytecode_.push_back(next->i0);
+        bytecode_.push_back(next->i1);
+        bytecode_.push_back(next->i2);
+        ++it;
+        continue;
+      }
+
+      switch (it->op) {
+      case OP_CONST:
+        bytecode_constants_.push_back(it->d);
+        if (has_next && (next->op==OP_ADD || next->op==OP_SUB ||
+                         next->op==OP_MUL || next->op==OP_DIV)) {
+          // Fuse with the binary operation that follows
+          switch (next->op) {
+          case OP_ADD: bytecode_.push_back(BC_CONST_ADD); break;
+          case OP_SUB: bytecode_.push_back(BC_CONST_SUB); break;
+          case OP_MUL: bytecode_.push_back(BC_CONST_MUL); break;
+          case OP_DIV: bytecode_.push_back(BC_CONST_DIV); break;
+          }
+          bytecode_.push_back(bytecode_constants_.size()-1);
+          bytecode_.push_back(it->i0);
+          bytecode_.push_back(next->i0);
+          bytecode_.push_back(next->i1);
+          bytecode_.push_back(next->i2);
+          ++it;
+        } else {
+          bytecode_.push_back(BC_CONST);
+          bytecode_.push_back(bytecode_constants_.size()-1);
+          bytecode_.push_back(it->i0);
+        }
+        break;
+      case OP_INPUT:
+        bytecode_.push_back(BC_INPUT);
+        bytecode_.push_back(it->i1);
+        bytecode_.push_back(it->i2);
+        bytecode_.push_back(it->i0);
+        break;
+      case OP_OUTPUT:
+        bytecode_.push_back(BC_OUTPUT);
+        bytecode_.push_back(it->i0);
+        bytecode_.push_back(it->i2);
+        bytecode_.push_back(it->i1);
+        break;
+      default:
+        switch (it->op) {
+#define CASADI_BYTECODE_COMPILE(OP) \
+        case OP_##OP: bytecode_.push_back(BC_##OP); break;
+        CASADI_BYTECODE_BUILTIN(CASADI_BYTECODE_COMPILE)
+#undef CASADI_BYTECODE_COMPILE
+        default:
+          // Free parameters and other operations are ignored, as in evaluate()
+          continue;
+        }
+        bytecode_.push_back(it->i0);
+        bytecode_.push_back(it->i1);
+        bytecode_.push_back(it->i2);
+      }
+    }
+    bytecode_.push_back(BC_END);
+
+    // Pointers to the input and output nonzeros
+    bytecode_arg_.resize(getNumInputs());
+    bytecode_res_.resize(getNumOutputs());
+
+    if (verbose()) {
+      cout << "SXFunctionInternal::compileBytecode: " << algorithm_.size()
+           << " elementary operations compiled into " << bytecode_.size()
+           << " bytecode words" << endl;
+    }
+  }
+
+  void SXFunctionInternal::evaluateBytecode(const double** x, double** r, double* w) const {
+    const double* c = getPtr(bytecode_constants_);
+
+    // Program counter
+    const int* pc = getPtr(bytecode_);
+
+    // NOTE: The instructions below are built from the same BinaryOperation templates as
+    // CASADI_MATH_FUN_BUILTIN, in the same order, so that results are bit-identical
+#if defined(__GNUC__)
+    // Threaded dispatch using computed goto (labels as values)
+    static const void* const dispatch[BC_NUM_OPS] = {
+      &&bc_END, &&bc_CONST, &&bc_INPUT, &&bc_OUTPUT, &&bc_MUL_ADD,
+      &&bc_CONST_ADD, &&bc_CONST_SUB, &&bc_CONST_MUL, &&bc_CONST_DIV,
+#define CASADI_BYTECODE_LABEL(OP) &&bc_##OP,
+      CASADI_BYTECODE_BUILTIN(CASADI_BYTECODE_LABEL)
+#undef CASADI_BYTECODE_LABEL
+    };
+#define CASADI_BYTECODE_CASE(OP) bc_##OP:
+#define CASADI_BYTECODE_NEXT(N) pc += N; goto *dispatch[*pc]
+    goto *dispatch[*pc];
+#else // defined(__GNUC__)
+    // Portable fallback: switch based dispatch
+#define CASADI_BYTECODE_CASE(OP) case BC_##OP:
+#define CASADI_BYTECODE_NEXT(N) pc += N; continue
+    for (;;) {
+      switch (*pc) {
+#endif // defined(__GNUC__)
+
+    CASADI_BYTECODE_CASE(CONST)
+      w[pc[2]] = c[pc[1]];
+      CASADI_BYTECODE_NEXT(3);
+    CASADI_BYTECODE_CASE(INPUT)
+      w[pc[3]] = x[pc[1]][pc[2]];
+      CASADI_BYTECODE_NEXT(4);
+    CASADI_BYTECODE_CASE(OUTPUT)
+      r[pc[1]][pc[2]] = w[pc[3]];
+      CASADI_BYTECODE_NEXT(4);
+    CASADI_BYTECODE_CASE(MUL_ADD)
+      BinaryOperation<OP_MUL>::fcn(w[pc[2]], w[pc[3]], w[pc[1]]);
+      BinaryOperation<OP_ADD>::fcn(w[pc[5]], w[pc[6]], w[pc[4]]);
+      CASADI_BYTECODE_NEXT(7);
+#define CASADI_BYTECODE_CONST_BINARY(OP) \
+    CASADI_BYTECODE_CASE(CONST_##OP) \
+      w[pc[2]] = c[pc[1]]; \
+      BinaryOperation<OP_##OP>::fcn(w[pc[4]], w[pc[5]], w[pc[3]]); \
+      CASADI_BYTECODE_NEXT(6);
+    CASADI_BYTECODE_CONST_BINARY(ADD)
+    CASADI_BYTECODE_CONST_BINARY(SUB)
+    CASADI_BYTECODE_CONST_BINARY(MUL)
+    CASADI_BYTECODE_CONST_BINARY(DIV)
+#undef CASADI_BYTECODE_CONST_BINARY
+#define CASADI_BYTECODE_ELEMENTARY(OP) \
+    CASADI_BYTECODE_CASE(OP) \
+      BinaryOperationSS<OP_##OP>::fcn(w[pc[2]], w[pc[3]], w[pc[1]], 1); \
+      CASADI_BYTECODE_NEXT(4);
+    CASADI_BYTECODE_BUILTIN(CASADI_BYTECODE_ELEMENTARY)
+#undef CASADI_BYTECODE_ELEMENTARY
+    CASADI_BYTECODE_CASE(END)
+      ;
+
+#if !defined(__GNUC__)
+      }
+      break;
+    }
+#endif // !defined(__GNUC__)
+#undef CASADI_BYTECODE_CASE
+#undef CASADI_BYTECODE_NEXT
+  }
+
+  void SXFunctionInternal::evaluateBatch(int n, const double** arg, double** res) {
+    assertAlgorithm();
+    if (!free_vars_.empty()) {
+      std::stringstream ss;
+      repr(ss);
+      casadi_error("Cannot evaluate \"" << ss.str() << "\" since variables "
+                   << free_vars_ << " are free.");
+    }
+
+    // Structure-of-arrays work vector: the values of work_[i] for all points in a block
+    // are stored contiguously, so that each operation becomes a loop over the points
+    // that the compiler can vectorize
+    const int nl = batch_lanes_;
+    batch_work_.resize(work_.size()*nl);
+    double* w = getPtr(batch_work_);
+
+    // Number of nonzeros of each input and output
+    vector<int> nnz_in(getNumInputs()), nnz_out(getNumOutputs());
+    for (int ind=0; ind<nnz_in.size(); ++ind) nnz_in[ind] = input(ind).size();
+    for (int ind=0; ind<nnz_out.size(); ++ind) nnz_out[ind] = output(ind).size();
+
+    // Evaluate the algorithm for one block of points at a time
+    for (int offset=0; offset<n; offset+=nl) {
+      int nb = std::min(nl, n-offset);
+      for (vector<AlgEl>::const_iterator it=algorithm_.begin(); it!=algorithm_.end(); ++it) {
+        switch (it->op) {
+          // All built-in operations, elementwise over the points in the block
+          CASADI_MATH_FUN_BUILTIN_GEN(BinaryOperationVV, w+it->i1*nl, w+it->i2*nl,
+                                      w+it->i0*nl, nb)
+
+        case OP_CONST:
+          std::fill_n(w+it->i0*nl, nb, it->d);
+          break;
+        case OP_INPUT:
+          {
+            double* wi = w+it->i0*nl;
+            const double* x = arg[it->i1];
+            if (x==0) {
+              std::fill_n(wi, nb, 0);
+            } else {
+              int nnz = nnz_in[it->i1];
+              x += offset*nnz + it->i2;
+              for (int k=0; k<nb; ++k, x+=nnz) wi[k] = *x;
+            }
+          }
+          break;
+        case OP_OUTPUT:
+          {
+            const double* wi = w+it->i1*nl;
+            double* r = res[it->i0];
+            if (r!=0) {
+              int nnz = nnz_out[it->i0];
+              r += offset*nnz + it->i2;
+              for (int k=0; k<nb; ++k, r+=nnz) *r = wi[k];
+            }
+          }
+          break;
+        }
+      }
+    }
+  }
+
   SX SXFunctionInternal::hess(int iind, int oind) {
     casadi_assert_message(output(oind).numel() == 1, "Function must be scalar");
     SX g = grad(iind, oind);
@@ -193,6 +640,7 @@ namespace casadi {
 
   bool SXFunctionInternal::isSmooth() const {
     assertInit();
+    assertAlgorithm();
 
     // Go through all nodes and check if any node is non-smooth
     for (vector<AlgEl>::const_iterator it = algorithm_.begin(); it!=algorithm_.end(); ++it) {
@@ -203,6 +651,22 @@ namespace casadi {
     return true;
   }
 
+  bool SXFunctionInternal::structuralHash(std::size_t& seed) const {
+    if (algorithm_released_) return false;
+    hash_combine(seed, algorithm_.size());
+    hash_combine(seed, work_.size());
+    for (vector<AlgEl>::const_iterator it = algorithm_.begin(); it!=algorithm_.end(); ++it) {
+      hash_combine(seed, it->op);
+      hash_combine(seed, it->i0);
+      // The values of constants do not affect the dependencies
+      if (it->op!=OP_CONST && it->op!=OP_PARAMETER) {
+        hash_combine(seed, it->i1);
+        hash_combine(seed, it->i2);
+      }
+    }
+    return true;
+  }
+
   void SXFunctionInternal::print(ostream &stream) const {
     FunctionInternal::print(stream);
 
@@ -212,6 +676,13 @@ namespace casadi {
       return;
     }
 
+    // Quick return if only the compact tape remains
+    if (algorithm_released_) {
+      stream << "Algorithm released by clearSymbolic (" << tape_op_.size()
+             << " elementary operations)" << endl;
+      return;
+    }
+
     // Iterator to free variables
     vector<SXElement>::const_iterator p_it = free_vars_.begin();
 
@@ -250,6 +721,7 @@ namespace casadi {
 
   void SXFunctionInternal::generateDeclarations(std::ostream &stream, const std::string& type,
                                                 CodeGenerator& gen) const {
+    assertAlgorithm();
 
     // Make sure that there are no free variables
     if (!free_vars_.empty()) {
@@ -291,23 +763,182 @@ namespace casadi {
         } else if (it->op==OP_INPUT) {
           stream << "x" << it->i1 << "[" << it->i2 << "]";
         } else {
-          int ndep = casadi_math<double>::ndeps(it->op);
-          casadi_math<double>::printPre(it->op, stream);
-          for (int c=0; c<ndep; ++c) {
-            if (c==0) {
-              stream << "a" << it->i1;
-            } else {
-              casadi_math<double>::printSep(it->op, stream);
-              stream << "a" << it->i2;
-            }
-          }
-          casadi_math<double>::printPost(it->op, stream);
+          printOperation(stream, it->op, "a" + CodeGenerator::numToString(it->i1),
+                         "a" + CodeGenerator::numToString(it->i2));
         }
       }
       stream  << ";" << endl;
     }
   }
 
+  bool SXFunctionInternal::generateChunks(std::vector<std::string>& chunks, int& worksize,
+                                          int chunk_size, const std::string& type,
+                                          CodeGenerator& gen) const {
+    // Checks and auxiliary functions, nothing is declared outside of the function body
+    stringstream decl;
+    generateDeclarations(decl, type, gen);
+
+    // Instruction defining the current value of each work vector element
+    vector<int> def(work_.size(), -1);
+
+    // Values that are used by a later chunk must be stored in the work vector
+    int n = algorithm_.size();
+    vector<bool> escapes(n, false);
+    for (int k=0; k<n; ++k) {
+      const AlgEl& e = algorithm_[k];
+      int ndep = e.op==OP_OUTPUT ? 1 : casadi_math<double>::ndeps(e.op);
+      for (int c=0; c<ndep; ++c) {
+        int d = def[c==0 ? e.i1 : e.i2];
+        if (d/chunk_size != k/chunk_size) escapes[d] = true;
+      }
+      if (e.op!=OP_OUTPUT) def[e.i0] = k;
+    }
+
+    // Generate the chunks
+    chunks.clear();
+    worksize = work_.size();
+    stringstream s;
+    s.precision(std::numeric_limits<double>::digits10+2);
+    s << std::scientific;
+    vector<bool> declared;
+    fill(def.begin(), def.end(), -1);
+    for (int k=0; k<n; ++k) {
+      // Start a new chunk
+      if (k % chunk_size == 0) {
+        declared.assign(work_.size(), false);
+        s.str(string());
+      }
+
+      // Name of the current value of each operand
+      const AlgEl& e = algorithm_[k];
+      string a1, a2;
+      int ndep = e.op==OP_OUTPUT ? 1 : casadi_math<double>::ndeps(e.op);
+      for (int c=0; c<ndep; ++c) {
+        int el = c==0 ? e.i1 : e.i2;
+        string& a = c==0 ? a1 : a2;
+        a = (escapes[def[el]] ? "w[" : "a") + CodeGenerator::numToString(el)
+          + (escapes[def[el]] ? "]" : "");
+      }
+
+      s << "  ";
+      if (e.op==OP_OUTPUT) {
+        s << "if (r" << e.i0 << "!=0) r" << e.i0 << "[" << e.i2 << "]=" << a1;
+      } else {
+        // Where to store the result
+        def[e.i0] = k;
+        if (escapes[k]) {
+          s << "w[" << e.i0 << "]=";
+        } else {
+          if (!declared[e.i0]) {
+            s << type << " ";
+            declared[e.i0] = true;
+          }
+          s << "a" << e.i0 << "=";
+        }
+
+        // What to store
+        if (e.op==OP_CONST) {
+          gen.printConstant(s, e.d);
+        } else if (e.op==OP_INPUT) {
+          s << "x" << e.i1 << "[" << e.i2 << "]";
+        } else {
+          printOperation(s, e.op, a1, a2);
+        }
+      }
+      s << ";" << endl;
+
+      // Finish the chunk
+      if (k+1==n || (k+1) % chunk_size == 0) chunks.push_back(s.str());
+    }
+    return true;
+  }
+
+  void SXFunctionInternal::printOperation(std::ostream &stream, int op, const std::string& a1,
+                                          const std::string& a2) {
+    casadi_math<double>::printPre(op, stream);
+    stream << a1;
+    if (casadi_math<double>::ndeps(op)==2) {
+      casadi_math<double>::printSep(op, stream);
+      stream << a2;
+    }
+    casadi_math<double>::printPost(op, stream);
+  }
+
+  void SXFunctionInternal::generateEvaluateBatch(std::ostream &cfile, CodeGenerator& gen,
+                                                 const std::string& prefix) const {
+    // Checks and auxiliary functions
+    stringstream decl;
+    generateDeclarations(decl, "d", gen);
+
+    int n_in = getNumInputs();
+    int n_out = getNumOutputs();
+
+    // Restrict-qualified pointers to the data, with a fallback for C89 compilers
+    cfile << "#ifndef CASADI_RESTRICT" << endl;
+    cfile << "#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L" << endl;
+    cfile << "#define CASADI_RESTRICT restrict" << endl;
+    cfile << "#else" << endl;
+    cfile << "#define CASADI_RESTRICT" << endl;
+    cfile << "#endif" << endl;
+    cfile << "#endif" << endl << endl;
+
+    // Kernel looping over the instances. The iterations are independent and access memory with
+    // unit stride. The pointers are passed as restrict-qualified arguments, which compilers
+    // take into account more reliably than restrict-qualified local variables.
+    cfile << "static void " << prefix << "evaluateBatchKernel(int n";
+    for (int i=0; i<n_in; ++i) cfile << ", const d* CASADI_RESTRICT x" << i;
+    for (int i=0; i<n_out; ++i) cfile << ", d* CASADI_RESTRICT r" << i;
+    cfile << ") {" << endl;
+    cfile << "  int k;" << endl;
+    cfile << "  for (k=0; k<n; ++k) {" << endl;
+    vector<bool> declared(work_.size(), false);
+    for (vector<AlgEl>::const_iterator it = algorithm_.begin(); it!=algorithm_.end(); ++it) {
+      cfile << "    ";
+      if (it->op==OP_OUTPUT) {
+        cfile << "r" << it->i0 << "[" << it->i2 << "*n+k]=a" << it->i1;
+      } else {
+        if (!declared[it->i0]) {
+          cfile << "d ";
+          declared[it->i0]=true;
+        }
+        cfile << "a" << it->i0 << "=";
+        if (it->op==OP_CONST) {
+          gen.printConstant(cfile, it->d);
+        } else if (it->op==OP_INPUT) {
+          cfile << "x" << it->i1 << "[" << it->i2 << "*n+k]";
+        } else {
+          printOperation(cfile, it->op, "a" + CodeGenerator::numToString(it->i1),
+                         "a" + CodeGenerator::numToString(it->i2));
+        }
+      }
+      cfile << ";" << endl;
+    }
+    cfile << "  }" << endl;
+    cfile << "}" << endl << endl;
+
+    cfile << "/* Nonzero k of instance j of x[i] and r[i] at position k*n+j */" << endl;
+    cfile << "int " << prefix << "evaluateBatch(int n, const d** x, d** r) {" << endl;
+
+    // Conditional stores would prevent vectorization, evaluate one by one if outputs are missing
+    if (n_out>0) {
+      cfile << "  if (";
+      for (int i=0; i<n_out; ++i) {
+        if (i>0) cfile << " || ";
+        cfile << "r[" << i << "]==0";
+      }
+      cfile << ") {" << endl;
+      generateBatchLoop(cfile, "    ", prefix);
+      cfile << "    return 0;" << endl;
+      cfile << "  }" << endl;
+    }
+    cfile << "  " << prefix << "evaluateBatchKernel(n";
+    for (int i=0; i<n_in; ++i) cfile << ", x[" << i << "]";
+    for (int i=0; i<n_out; ++i) cfile << ", r[" << i << "]";
+    cfile << ");" << endl;
+    cfile << "  return 0;" << endl;
+    cfile << "}" << endl << endl;
+  }
+
   void SXFunctionInternal::init() {
 
     // Call the init function of the base class
@@ -349,18 +980,16 @@ namespace casadi {
       }
     }
 
-    // Sort the nodes by type
+    // Constants and operations, in the order of the algorithm
     constants_.clear();
     operations_.clear();
-    for (vector<SXNode*>::iterator it = nodes.begin(); it != nodes.end(); ++it) {
-      SXNode* t = *it;
-      if (t) {
-        if (t->isConstant())
-          constants_.push_back(SXElement::create(t));
-        else if (!t->isSymbolic())
-          operations_.push_back(SXElement::create(t));
-      }
-    }
+
+    // Common subexpression elimination: the node that each node has been merged into
+    bool cse = getOption("cse");
+    vector<int> canon = range(nodes.size());
+    map<pair<double, bool>, int> cse_constants;
+    map<pair<int, pair<int, int> >, int> cse_operations;
+    int n_nodes_before = 0;
 
     // Use live variables?
     bool live_variables = getOption("live_variables");
@@ -428,6 +1057,55 @@ namespace casadi {
       // Number of dependencies
       int ndeps = casadi_math<double>::ndeps(ae.op);
 
+      if (cse) {
+        // Refer to the nodes that the arguments have been merged into
+        if (ae.op==OP_OUTPUT) {
+          ae.i1 = canon[ae.i1];
+        } else if (ndeps>0) {
+          ae.i1 = canon[ae.i1];
+          if (ndeps==2) ae.i2 = canon[ae.i2];
+        }
+
+        // Look for an identical node encountered before
+        int prev = -1;
+        if (ae.op==OP_CONST) {
+          n_nodes_before++;
+          // NaN is never merged, 0 and -0 are kept apart
+          if (ae.d==ae.d) {
+            pair<double, bool> key(ae.d, ae.d==0 && 1/ae.d<0);
+            map<pair<double, bool>, int>::const_iterator m = cse_constants.find(key);
+            if (m==cse_constants.end()) {
+              cse_constants[key] = ae.i0;
+            } else {
+              prev = m->second;
+            }
+          }
+        } else if (ndeps>0 && ae.op!=OP_OUTPUT && ae.op!=OP_PARAMETER) {
+          // Outputs and parameters are never merged, only their argument is remapped above
+          n_nodes_before++;
+          int a = ae.i1, b = ndeps==2 ? ae.i2 : -1;
+          if (ndeps==2 && a>b && operation_checker<CommChecker>(ae.op)) swap(a, b);
+          pair<int, pair<int, int> > key(ae.op, make_pair(a, b));
+          map<pair<int, pair<int, int> >, int>::const_iterator m = cse_operations.find(key);
+          if (m==cse_operations.end()) {
+            cse_operations[key] = ae.i0;
+          } else {
+            prev = m->second;
+          }
+        }
+        if (prev>=0) {
+          canon[ae.i0] = prev;
+          continue;
+        }
+      }
+
+      // Expression corresponding to the instruction
+      if (ae.op==OP_CONST) {
+        constants_.push_back(SXElement::create(n));
+      } else if (ae.op!=OP_PARAMETER && ae.op!=OP_OUTPUT) {
+        operations_.push_back(SXElement::create(n));
+      }
+
       // Increase count of dependencies
       for (int c=0; c<ndeps; ++c) {
         refcount.at(c==0 ? ae.i1 : ae.i2)++;
@@ -436,6 +1114,16 @@ namespace casadi {
       algorithm_.push_back(ae);
     }
 
+    if (cse) {
+      int n_nodes_after = constants_.size() + operations_.size();
+      stats_["cse_nodes_before"] = n_nodes_before;
+      stats_["cse_nodes_after"] = n_nodes_after;
+      if (verbose()) {
+        cout << "Common subexpression elimination: " << n_nodes_before << " nodes reduced to "
+             << n_nodes_after << endl;
+      }
+    }
+
     // Place in the work vector for each of the nodes in the tree (overwrites the reference counter)
     vector<int> place(nodes.size());
 
@@ -547,6 +1235,27 @@ namespace casadi {
       }
     }
 
+    // Separate arrays for the operations, indices and constants
+    algorithm_released_ = false;
+    compact_tape_ = getOption("compact_tape");
+    if (compact_tape_) {
+      compactTape();
+    } else {
+      tape_op_.clear();
+      tape_i16_.clear();
+      tape_i32_.clear();
+      tape_const_.clear();
+    }
+
+    // Compile the algorithm for the threaded interpreter
+    threaded_evaluator_ = getOption("evaluator")=="threaded";
+    if (threaded_evaluator_) {
+      compileBytecode();
+    } else {
+      bytecode_.clear();
+      bytecode_constants_.clear();
+    }
+
     // Initialize just-in-time compilation for numeric evaluation using OpenCL
     just_in_time_opencl_ = getOption("just_in_time_opencl");
     if (just_in_time_opencl_) {
@@ -616,6 +1325,9 @@ namespace casadi {
       }
     }
 
+    // Memory footprint
+    updateMemoryStats();
+
     // Print
     if (verbose()) {
       cout << "SXFunctionInternal::init Initialized " << getOption("name") << " ("
@@ -627,6 +1339,8 @@ namespace casadi {
                                   const vector<vector<SX> >& fseed, vector<vector<SX> >& fsens,
                                   const vector<vector<SX> >& aseed, vector<vector<SX> >& asens) {
     if (verbose()) cout << "SXFunctionInternal::evalSXsparse begin" << endl;
+    casadi_assert_message(s_work_.size()==work_.size(),
+                          "Symbolic evaluation is not possible after clearSymbolic");
 
     // Check if arguments matches the input expressions, in which case the output is known
     // to be the output expressions
@@ -797,7 +1511,18 @@ namespace casadi {
   void SXFunctionInternal::clearSymbolic() {
     inputv_.clear();
     outputv_.clear();
-    s_work_.clear();
+    vector<SXElement>().swap(s_work_);
+    vector<SXElement>().swap(operations_);
+    vector<SXElement>().swap(constants_);
+
+    // Only the compact tape is needed for numeric evaluation and sparsity propagation
+    if (compact_tape_) {
+      vector<AlgEl>().swap(algorithm_);
+      algorithm_released_ = true;
+    }
+
+    // Memory footprint
+    updateMemoryStats();
   }
 
   void SXFunctionInternal::spInit(bool fwd) {
@@ -825,6 +1550,16 @@ namespace casadi {
     }
 #endif // WITH_OPENCL
 
+    // Propagate using the compact tape
+    if (compact_tape_) {
+      if (tape_i32_.empty()) {
+        spEvaluateCompact(getPtr(tape_i16_), fwd);
+      } else {
+        spEvaluateCompact(getPtr(tape_i32_), fwd);
+      }
+      return;
+    }
+
     // Get work array
     bvec_t *iwork = get_bvec_t(work_);
 
@@ -874,6 +1609,167 @@ namespace casadi {
     }
   }
 
+  /// \cond INTERNAL
+  /** \brief Operations on blocks of NW bit vectors, NW==0 for a size given at runtime
+      For blocks of four bit vectors or multiples thereof, the GCC vector extensions are used
+      to perform the bitwise or with SIMD instructions. */
+  template<int NW>
+  struct BvecBlock {
+    // Number of bit vectors
+    static inline int size(int nw) { return NW>0 ? NW : nw;}
+
+    // r = 0
+    static inline void clear(bvec_t* r, int nw) {
+      for (int w=0; w<size(nw); ++w) r[w] = 0;
+    }
+
+    // r = a
+    static inline void assign(bvec_t* r, const bvec_t* a, int nw) {
+      for (int w=0; w<size(nw); ++w) r[w] = a[w];
+    }
+
+    // r |= a
+    static inline void accumulate(bvec_t* r, const bvec_t* a, int nw) {
+      for (int w=0; w<size(nw); ++w) r[w] |= a[w];
+    }
+
+    // r = a | b
+    static inline void bor(bvec_t* r, const bvec_t* a, const bvec_t* b, int nw) {
+#ifdef __GNUC__
+      if (NW>0 && NW%4==0) {
+        typedef bvec_t simd_t __attribute__((vector_size(4*sizeof(bvec_t))));
+        for (int w=0; w<NW; w+=4) {
+          simd_t x, y;
+          memcpy(&x, a+w, sizeof(simd_t));
+          memcpy(&y, b+w, sizeof(simd_t));
+          x |= y;
+          memcpy(r+w, &x, sizeof(simd_t));
+        }
+        return;
+      }
+#endif // __GNUC__
+      for (int w=0; w<size(nw); ++w) r[w] = a[w] | b[w];
+    }
+  };
+  /// \endcond
+
+  template<typename I>
+  void SXFunctionInternal::spEvaluateCompact(const I* idx, bool fwd) {
+    // Get work array
+    bvec_t *iwork = get_bvec_t(work_);
+    int n = tape_op_.size();
+    const unsigned char* op = getPtr(tape_op_);
+
+    if (fwd) {
+      // Propagate sparsity forward
+      for (int k=0; k<n; ++k, idx+=3) {
+        switch (op[k]) {
+        case OP_CONST:
+        case OP_PARAMETER:
+          iwork[idx[0]] = bvec_t(0); break;
+        case OP_INPUT:
+          iwork[idx[0]] = get_bvec_t(inputNoCheck(idx[1]).data())[idx[2]]; break;
+        case OP_OUTPUT:
+          get_bvec_t(outputNoCheck(idx[0]).data())[idx[2]] = iwork[idx[1]]; break;
+        default: // Unary or binary operation
+          iwork[idx[0]] = iwork[idx[1]] | iwork[idx[2]]; break;
+        }
+      }
+
+    } else { // Backward propagation
+      idx += 3*n;
+      for (int k=n-1; k>=0; --k) {
+        idx -= 3;
+        bvec_t seed;
+        switch (op[k]) {
+        case OP_CONST:
+        case OP_PARAMETER:
+          iwork[idx[0]] = 0;
+          break;
+        case OP_INPUT:
+          get_bvec_t(inputNoCheck(idx[1]).data())[idx[2]] = iwork[idx[0]];
+          iwork[idx[0]] = 0;
+          break;
+        case OP_OUTPUT:
+          iwork[idx[1]] |= get_bvec_t(outputNoCheck(idx[0]).data())[idx[2]];
+          break;
+        default: // Unary or binary operation
+          seed = iwork[idx[0]];
+          iwork[idx[0]] = 0;
+          iwork[idx[1]] |= seed;
+          iwork[idx[2]] |= seed;
+        }
+      }
+    }
+  }
+
+  void SXFunctionInternal::spEvaluateWide(bool fwd, int nw, bvec_t** arg, bvec_t** res) {
+    assertAlgorithm();
+    switch (nw) {
+    case 4: return spEvaluateWideGen<4>(fwd, nw, arg, res);
+    case 8: return spEvaluateWideGen<8>(fwd, nw, arg, res);
+    case 16: return spEvaluateWideGen<16>(fwd, nw, arg, res);
+    default: return spEvaluateWideGen<0>(fwd, nw, arg, res);
+    }
+  }
+
+  template<int NW>
+  void SXFunctionInternal::spEvaluateWideGen(bool fwd, int nw, bvec_t** arg, bvec_t** res) {
+    typedef BvecBlock<NW> B;
+    nw = B::size(nw);
+
+    // Work vector, nw bit vectors per element
+    sp_wide_work_.resize(work_.size()*nw);
+    bvec_t* w = getPtr(sp_wide_work_);
+
+    if (fwd) {
+      // Propagate sparsity forward
+      for (vector<AlgEl>::const_iterator it=algorithm_.begin(); it!=algorithm_.end(); ++it) {
+        switch (it->op) {
+        case OP_CONST:
+        case OP_PARAMETER:
+          B::clear(w + it->i0*nw, nw); break;
+        case OP_INPUT:
+          B::assign(w + it->i0*nw, arg[it->i1] + it->i2*nw, nw); break;
+        case OP_OUTPUT:
+          B::assign(res[it->i0] + it->i2*nw, w + it->i1*nw, nw); break;
+        default: // Unary or binary operation
+          B::bor(w + it->i0*nw, w + it->i1*nw, w + it->i2*nw, nw); break;
+        }
+      }
+
+    } else { // Backward propagation
+      fill(sp_wide_work_.begin(), sp_wide_work_.end(), bvec_t(0));
+
+      // Temp seed
+      vector<bvec_t> seed_v(nw);
+      bvec_t* seed = getPtr(seed_v);
+
+      // Propagate sparsity backward
+      for (vector<AlgEl>::const_reverse_iterator it=algorithm_.rbegin();
+           it!=algorithm_.rend(); ++it) {
+        switch (it->op) {
+        case OP_CONST:
+        case OP_PARAMETER:
+          B::clear(w + it->i0*nw, nw);
+          break;
+        case OP_INPUT:
+          B::accumulate(arg[it->i1] + it->i2*nw, w + it->i0*nw, nw);
+          B::clear(w + it->i0*nw, nw);
+          break;
+        case OP_OUTPUT:
+          B::accumulate(w + it->i1*nw, res[it->i0] + it->i2*nw, nw);
+          break;
+        default: // Unary or binary operation
+          B::assign(seed, w + it->i0*nw, nw);
+          B::clear(w + it->i0*nw, nw);
+          B::accumulate(w + it->i1*nw, seed, nw);
+          B::accumulate(w + it->i2*nw, seed, nw);
+        }
+      }
+    }
+  }
+
   Function SXFunctionInternal::getFullJacobian() {
     // Get all the inputs
     SX arg = SX::sparse(1, 0);
@@ -94,6 +94,27 @@ class CASADI_EXPORT SXFunctionInternal :
   /** \brief  Evaluate the function numerically */
   virtual void evaluate();
 
+  /** \brief  Evaluate with caller-owned arguments, results and memory */
+  virtual void evalD(const double** arg, double** res, FunctionMemory& mem);
+
+  /** \brief  Allocate memory for evalD */
+  virtual void allocMemory(FunctionMemory& mem) const;
+
+  /** \brief  Can evalD be called concurrently with different memory objects? */
+  virtual bool isReentrant() const { return true;}
+
+  /** \brief  Evaluate the function numerically using the threaded bytecode interpreter */
+  void evaluateBytecode(const double** x, double** r, double* w) const;
+
+  /** \brief  Compile the algorithm into a packed bytecode for the threaded interpreter */
+  void compileBytecode();
+
+  /** \brief  Evaluate the function numerically for n independent points
+   * arg[i] (res[i]) holds the nonzeros of input (output) i for all points, one point
+   * after the other. A null pointer is treated as zeros (inputs) or skipped (outputs).
+   */
+  void evaluateBatch(int n, const double** arg, double** res);
+
   /** \brief  Helper class to be plugged into evaluateGen when working
    * with a value known only at runtime */
   struct int_runtime {
@@ -151,6 +172,58 @@ class CASADI_EXPORT SXFunctionInternal :
   /// The expressions corresponding to each constant
   std::vector<SXElement> constants_;
 
+  /// Use the threaded bytecode interpreter for numeric evaluation
+  bool threaded_evaluator_;
+
+  /// Packed bytecode for the threaded interpreter: opcode followed by its operands
+  std::vector<int> bytecode_;
+
+  /// Constants referenced by the bytecode
+  std::vector<double> bytecode_constants_;
+
+  /// Pointers to the input and output nonzeros, updated for each evaluation
+  std::vector<const double*> bytecode_arg_;
+  std::vector<double*> bytecode_res_;
+
+  /// Number of points evaluated simultaneously in evaluateBatch
+  static const int batch_lanes_ = 128;
+
+  /// Work vector for batched evaluation, batch_lanes_ entries per element of work_
+  std::vector<double> batch_work_;
+
+  /// Use the compact tape for numeric evaluation and sparsity propagation
+  bool compact_tape_;
+
+  /// The algorithm has been released by clearSymbolic, only the compact tape remains
+  bool algorithm_released_;
+
+  /// Compact tape: operation of each element of the algorithm
+  std::vector<unsigned char> tape_op_;
+
+  /// Compact tape: i0, i1, i2 of each element, 16 bit if all indices fit, otherwise 32 bit
+  std::vector<unsigned short> tape_i16_;
+  std::vector<int> tape_i32_;
+
+  /// Compact tape: the constants, in the order of appearance
+  std::vector<double> tape_const_;
+
+  /// Create the compact tape from the algorithm
+  void compactTape();
+
+  /// Evaluate numerically using the compact tape
+  template<typename I>
+  void evaluateCompact(const I* idx, const double** arg, double** res, double* w) const;
+
+  /// Propagate sparsity using the compact tape
+  template<typename I>
+  void spEvaluateCompact(const I* idx, bool fwd);
+
+  /// Throw an error if the algorithm has been released by clearSymbolic
+  void assertAlgorithm() const;
+
+  /// Update the statistics of the memory footprint
+  void updateMemoryStats();
+
   /** \brief  Initialize */
   virtual void init();
 
@@ -162,8 +235,21 @@ class CASADI_EXPORT SXFunctionInternal :
   virtual void generateBody(std::ostream &stream, const std::string& type,
                             CodeGenerator& gen) const;
 
+  /** \brief Generate the function body as a sequence of chunks */
+  virtual bool generateChunks(std::vector<std::string>& chunks, int& worksize, int chunk_size,
+                              const std::string& type, CodeGenerator& gen) const;
+
+  /** \brief Generate the evaluateBatch entry point as a loop that can be vectorized */
+  virtual void generateEvaluateBatch(std::ostream &cfile, CodeGenerator& gen,
+                                     const std::string& prefix="") const;
+
+  /** \brief Print a unary or binary operation acting on the variables a1 and a2 */
+  static void printOperation(std::ostream &stream, int op, const std::string& a1,
+                             const std::string& a2);
+
   /** \brief Clear the function from its symbolic representation, to free up memory,
-   * no symbolic evaluations are possible after this */
+   * no symbolic evaluations are possible after this. With the option "compact_tape",
+   * the full algorithm is released too, leaving only the compact tape. */
   void clearSymbolic();
 
   /// Propagate a sparsity pattern through the algorithm
@@ -172,6 +258,22 @@ class CASADI_EXPORT SXFunctionInternal :
   /// Is the class able to propagate seeds through the algorithm?
   virtual bool spCanEvaluate(bool fwd) { return true;}
 
+  /** \brief  Propagate the sparsity pattern, nw bit vectors per nonzero at once */
+  virtual void spEvaluateWide(bool fwd, int nw, bvec_t** arg, bvec_t** res);
+
+  /// Propagation of several bit vectors at once is supported
+  virtual bool spCanEvaluateWide(bool fwd) { return !algorithm_released_;}
+
+  /// Implementation of spEvaluateWide for NW bit vectors, NW==0 for nw given at runtime
+  template<int NW>
+  void spEvaluateWideGen(bool fwd, int nw, bvec_t** arg, bvec_t** res);
+
+  /// Work vector for spEvaluateWide
+  std::vector<bvec_t> sp_wide_work_;
+
+  /** \brief Hash of the structure of the algorithm */
+  virtual bool structuralHash(std::size_t& seed) const;
+
   /// Reset the sparsity propagation
   virtual void spInit(bool fwd);
 
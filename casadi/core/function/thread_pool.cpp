@@ -0,0 +1,162 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#include "thread_pool.hpp"
+#ifdef USE_CXX11
+
+using namespace std;
+
+namespace casadi {
+
+  ThreadPool::ThreadPool(int num_threads) : task_(0), generation_(0), remaining_(0),
+                                            active_(0), busy_(false), stop_(false) {
+    casadi_assert_message(num_threads>=1, "ThreadPool: Number of threads must be positive");
+    for (int t=0; t<num_threads; ++t) {
+      queues_.push_back(unique_ptr<Queue>(new Queue()));
+    }
+    for (int t=1; t<num_threads; ++t) {
+      threads_.push_back(thread(&ThreadPool::work, this, t));
+    }
+  }
+
+  ThreadPool::~ThreadPool() {
+    {
+      lock_guard<mutex> lock(mtx_);
+      stop_ = true;
+    }
+    cv_start_.notify_all();
+    for (int t=0; t<threads_.size(); ++t) threads_[t].join();
+  }
+
+  void ThreadPool::run(int ntask, const Task& task) {
+    casadi_assert_message(!busy_, "ThreadPool::run: Recursive calls are not allowed");
+    busy_ = true;
+
+    // Distribute the tasks over the queues
+    for (int i=0; i<ntask; ++i) {
+      Queue& q = *queues_[i % size()];
+      lock_guard<mutex> lock(q.mtx);
+      q.tasks.push_back(i);
+    }
+
+    // Wake up the workers
+    {
+      lock_guard<mutex> lock(mtx_);
+      task_ = &task;
+      remaining_ = ntask;
+      error_ = exception_ptr();
+      generation_++;
+    }
+    cv_start_.notify_all();
+
+    // The calling thread participates as thread 0
+    drain(0, task);
+
+    // Wait until all tasks have finished and all workers have left the batch
+    exception_ptr error;
+    {
+      unique_lock<mutex> lock(mtx_);
+      while (remaining_>0 || active_>0) cv_done_.wait(lock);
+      task_ = 0;
+      error = error_;
+      error_ = exception_ptr();
+    }
+    busy_ = false;
+    if (error) rethrow_exception(error);
+  }
+
+  void ThreadPool::work(int thread) {
+    int generation = 0;
+    while (true) {
+      // Wait for a new batch of tasks
+      const Task* task;
+      {
+        unique_lock<mutex> lock(mtx_);
+        while (!stop_ && generation==generation_) cv_start_.wait(lock);
+        if (stop_) return;
+        generation = generation_;
+        task = task_;
+        if (task==0) continue; // The batch has already been completed
+        active_++;
+      }
+
+      // Execute tasks
+      drain(thread, *task);
+
+      // Leave the batch
+      {
+        lock_guard<mutex> lock(mtx_);
+        active_--;
+      }
+      cv_done_.notify_all();
+    }
+  }
+
+  void ThreadPool::drain(int thread, const Task& task) {
+    int i;
+    while (pop(thread, i)) {
+      try {
+        task(i, thread);
+      } catch(...) {
+        lock_guard<mutex> lock(mtx_);
+        if (!error_) error_ = current_exception();
+      }
+      bool done;
+      {
+        lock_guard<mutex> lock(mtx_);
+        done = --remaining_ == 0;
+      }
+      if (done) cv_done_.notify_all();
+    }
+  }
+
+  bool ThreadPool::pop(int thread, int& task) {
+    // Take the next task from the front of the own queue
+    {
+      Queue& q = *queues_[thread];
+      lock_guard<mutex> lock(q.mtx);
+      if (!q.tasks.empty()) {
+        task = q.tasks.front();
+        q.tasks.pop_front();
+        return true;
+      }
+    }
+
+    // Steal from the back of the other queues
+    for (int k=1; k<size(); ++k) {
+      Queue& q = *queues_[(thread+k) % size()];
+      lock_guard<mutex> lock(q.mtx);
+      if (!q.tasks.empty()) {
+        task = q.tasks.back();
+        q.tasks.pop_back();
+        return true;
+      }
+    }
+    return false;
+  }
+
+} // namespace casadi
+#endif // USE_CXX11
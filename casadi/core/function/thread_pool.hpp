@@ -0,0 +1,127 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#ifndef CASADI_THREAD_POOL_HPP
+#define CASADI_THREAD_POOL_HPP
+
+#include "../casadi_exception.hpp"
+#ifdef USE_CXX11
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <exception>
+#endif // USE_CXX11
+
+/// \cond INTERNAL
+#ifdef USE_CXX11
+namespace casadi {
+
+  /** \brief Persistent pool of worker threads with work stealing
+
+      Each call to run() distributes a set of independent tasks round-robin over one queue
+      per thread. A thread takes tasks from the front of its own queue and, when that is
+      empty, steals from the back of the queues of the other threads, so that tasks of
+      uneven cost are balanced dynamically. The calling thread acts as thread 0 and the
+      worker threads are kept alive between calls.
+  */
+  class CASADI_EXPORT ThreadPool {
+  public:
+    /// Type of a task: called with the task index and the index of the executing thread
+    typedef std::function<void(int task, int thread)> Task;
+
+    /// Create a pool with a given number of threads, including the calling thread
+    explicit ThreadPool(int num_threads);
+
+    /// Destructor, stops and joins the worker threads
+    ~ThreadPool();
+
+    /// Number of threads, including the calling thread
+    int size() const { return queues_.size();}
+
+    /** \brief Execute task(i, thread) for i=0,...,ntask-1 and wait until all have finished
+        The first exception thrown by a task is rethrown in the calling thread.
+        Not reentrant: tasks may not call run() on the same pool. */
+    void run(int ntask, const Task& task);
+
+  private:
+    /// Main loop of the worker threads
+    void work(int thread);
+
+    /// Execute tasks until all queues are empty
+    void drain(int thread, const Task& task);
+
+    /// Get a task from the own queue or steal one from another queue
+    bool pop(int thread, int& task);
+
+    /// Task queue of a thread
+    struct Queue {
+      std::mutex mtx;
+      std::deque<int> tasks;
+    };
+
+    /// Task queues, one per thread
+    std::vector<std::unique_ptr<Queue> > queues_;
+
+    /// Worker threads (thread 0 is the calling thread)
+    std::vector<std::thread> threads_;
+
+    /// Mutex protecting the shared state below
+    std::mutex mtx_;
+
+    /// Signal a new batch of tasks to the workers and completion to the caller
+    std::condition_variable cv_start_, cv_done_;
+
+    /// Task being executed, null if none
+    const Task* task_;
+
+    /// Counter that is increased for each call to run()
+    int generation_;
+
+    /// Number of unfinished tasks
+    int remaining_;
+
+    /// Number of worker threads that have joined the current call to run()
+    int active_;
+
+    /// First exception thrown by a task
+    std::exception_ptr error_;
+
+    /// Is run() being executed?
+    bool busy_;
+
+    /// Stop the worker threads
+    bool stop_;
+  };
+
+} // namespace casadi
+#endif // USE_CXX11
+/// \endcond
+
+#endif // CASADI_THREAD_POOL_HPP
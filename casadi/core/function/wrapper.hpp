@@ -45,6 +45,12 @@ namespace casadi {
       void checkDimensions();
       /// Evaluate the internal function and make it external
       void evaluate();
+      /// Evaluate the internal function with caller-owned arguments, results and memory
+      void evalD(const double** arg, double** res, FunctionMemory& mem);
+      /// Allocate memory for evalD
+      void allocMemory(FunctionMemory& mem) const;
+      /// Can evalD be called concurrently with different memory objects?
+      bool isReentrant() const;
     protected:
       /// The internal function that is being wrapped
       Function f_;
@@ -91,6 +97,22 @@ void Wrapper<Derived>::evaluate() {
     std::copy(f_.output(i).begin(), f_.output(i).end(), d->output(i).begin());
   }
 }
+
+template< class Derived>
+void Wrapper<Derived>::evalD(const double** arg, double** res, FunctionMemory& mem) {
+  // The sparsity patterns match (see checkDimensions), so the call can be forwarded
+  f_.evaluate(arg, res, mem);
+}
+
+template< class Derived>
+void Wrapper<Derived>::allocMemory(FunctionMemory& mem) const {
+  mem = f_.allocMemory();
+}
+
+template< class Derived>
+bool Wrapper<Derived>::isReentrant() const {
+  return f_.isReentrant();
+}
 #endif
 } // namespace casadi
 
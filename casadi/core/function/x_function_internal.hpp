@@ -28,6 +28,7 @@
 
 #include <stack>
 #include "function_internal.hpp"
+#include "parallelizer.hpp"
 
 // To reuse variables we need to be able to sort by sparsity pattern (preferably using a hash map)
 #ifdef USE_CXX11
@@ -631,15 +632,22 @@ namespace casadi {
     int max_nfdir = optimized_num_dir;
     int max_nadir = optimized_num_dir;
 
+    // Number of threads for evaluating the sweeps, only possible when calling derivative functions
+    int num_threads = never_inline ? static_cast<int>(getOption("jacobian_num_threads")) : 1;
+    casadi_assert_message(num_threads>=1, "Option \"jacobian_num_threads\" must be positive");
+
+    // Make sure that there are at least as many sweeps as threads
+    if (num_threads>1) {
+      max_nfdir = std::max(1, std::min(max_nfdir, (nfdir+num_threads-1)/num_threads));
+      max_nadir = std::max(1, std::min(max_nadir, (nadir+num_threads-1)/num_threads));
+    }
+
     // Current forward and adjoint direction
     int offset_nfdir = 0, offset_nadir = 0;
 
     // Evaluation result (known)
     std::vector<MatType> res(outputv_);
 
-    // Forward and adjoint seeds and sensitivities
-    std::vector<std::vector<MatType> > fseed, aseed, fsens, asens;
-
     // Get the sparsity of the Jacobian block
     Sparsity jsp = jacSparsity(iind, oind, true, symmetric).T();
     const std::vector<int>& jsp_colind = jsp.colind();
@@ -686,8 +694,15 @@ namespace casadi {
     // Sparsity of the seeds
     vector<int> seed_col, seed_row;
 
-    // Evaluate until everything has been determined
+    // Forward and adjoint seeds and sensitivities for each sweep
+    std::vector<std::vector<std::vector<MatType> > > fseed_s(nsweep), aseed_s(nsweep),
+        fsens_s(nsweep), asens_s(nsweep);
+
+    // Create the seeds for all sweeps
     for (int s=0; s<nsweep; ++s) {
+      std::vector<std::vector<MatType> > &fseed = fseed_s[s], &aseed = aseed_s[s],
+          &fsens = fsens_s[s], &asens = asens_s[s];
+
       // Print progress
       if (verbose()) {
         int progress_new = (s*100)/nsweep;
@@ -782,9 +797,60 @@ namespace casadi {
         }
       }
 
-      // Evaluate symbolically
+      // Update direction offsets
+      offset_nfdir += nfdir_batch;
+      offset_nadir += nadir_batch;
+    }
+
+    // Evaluate symbolically
+    if (num_threads>1 && nsweep>1) {
+      // Call the derivative functions of all sweeps in parallel
+      if (verbose()) std::cout << "XFunctionInternal::jac making parallel function call"
+                               << std::endl;
+      std::vector<Function> dfcn(nsweep);
+      std::vector<MatType> darg;
+      for (int s=0; s<nsweep; ++s) {
+        dfcn[s] = derivative(fseed_s[s].size(), aseed_s[s].size());
+        darg.insert(darg.end(), inputv_.begin(), inputv_.end());
+        for (int d=0; d<fseed_s[s].size(); ++d) {
+          darg.insert(darg.end(), fseed_s[s][d].begin(), fseed_s[s][d].end());
+        }
+        for (int d=0; d<aseed_s[s].size(); ++d) {
+          darg.insert(darg.end(), aseed_s[s][d].begin(), aseed_s[s][d].end());
+        }
+      }
+      Parallelizer par(dfcn);
+      par.setOption("parallelization", "threadpool");
+      par.setOption("num_threads", num_threads);
+      par.init();
+      std::vector<MatType> dres = par.call(darg);
+
+      // Collect the sensitivities
+      typename std::vector<MatType>::const_iterator dres_it = dres.begin();
+      for (int s=0; s<nsweep; ++s) {
+        dres_it += getNumOutputs(); // Nondifferentiated outputs
+        for (int d=0; d<fsens_s[s].size(); ++d) {
+          for (int i=0; i<getNumOutputs(); ++i) fsens_s[s][d][i] = *dres_it++;
+        }
+        for (int d=0; d<asens_s[s].size(); ++d) {
+          for (int i=0; i<getNumInputs(); ++i) asens_s[s][d][i] = *dres_it++;
+        }
+      }
+    } else {
       if (verbose()) std::cout << "XFunctionInternal::jac making function call" << std::endl;
-      call(inputv_, res, fseed, fsens, aseed, asens, always_inline, never_inline);
+      for (int s=0; s<nsweep; ++s) {
+        call(inputv_, res, fseed_s[s], fsens_s[s], aseed_s[s], asens_s[s],
+             always_inline, never_inline);
+      }
+    }
+
+    // Add the contributions of the sweeps to the Jacobian, in a fixed order
+    offset_nfdir = 0;
+    offset_nadir = 0;
+    for (int s=0; s<nsweep; ++s) {
+      std::vector<std::vector<MatType> > &fsens = fsens_s[s], &asens = asens_s[s];
+      int nfdir_batch = fsens.size();
+      int nadir_batch = asens.size();
 
       // Carry out the forward sweeps
       for (int d=0; d<nfdir_batch; ++d) {
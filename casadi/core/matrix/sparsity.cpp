@@ -436,6 +436,14 @@ namespace casadi {
     return ret;
   }
 
+#ifdef WITH_THREADSAFE_SYMBOLICS
+  /// Mutex protecting the sparsity pattern cache
+  static std::mutex& getCacheMutex() {
+    static std::mutex m;
+    return m;
+  }
+#endif // WITH_THREADSAFE_SYMBOLICS
+
   const Sparsity& Sparsity::getScalar() {
     static ScalarSparsity ret;
     return ret;
@@ -609,6 +617,9 @@ namespace casadi {
 
     // Get a reference to the cache
     CachingMap& cache = getCache();
+#ifdef WITH_THREADSAFE_SYMBOLICS
+    std::lock_guard<std::mutex> lock(getCacheMutex());
+#endif // WITH_THREADSAFE_SYMBOLICS
 
     // Record the current number of buckets (for garbage collection below)
 #ifdef USE_CXX11
@@ -629,11 +640,11 @@ namespace casadi {
         // Get a weak reference to the cached sparsity pattern
         WeakRef& wref = i->second;
 
-        // Check if the pattern still exists
-        if (wref.alive()) {
+        // Get an owning reference to the cached pattern, null if it no longer exists
+        Sparsity ref = shared_cast<Sparsity>(wref.shared());
 
-          // Get an owning reference to the cached pattern
-          Sparsity ref = shared_cast<Sparsity>(wref.shared());
+        // Check if the pattern still exists
+        if (!ref.isNull()) {
 
           // Check if the pattern matches
           if (ref.isEqual(nrow, ncol, colind, row)) {
@@ -669,10 +680,9 @@ namespace casadi {
           CachingMap::iterator j=i;
           j++; // Start at the next matching key
           for (; j!=eq.second; ++j) {
-            if (j->second.alive()) {
-
-              // Recover cached sparsity
-              Sparsity ref = shared_cast<Sparsity>(j->second.shared());
+            // Recover cached sparsity
+            Sparsity ref = shared_cast<Sparsity>(j->second.shared());
+            if (!ref.isNull()) {
 
               // Match found if sparsity matches
               if (ref.isEqual(nrow, ncol, colind, row)) {
@@ -724,6 +734,9 @@ namespace casadi {
   }
 
   void Sparsity::clearCache() {
+#ifdef WITH_THREADSAFE_SYMBOLICS
+    std::lock_guard<std::mutex> lock(getCacheMutex());
+#endif // WITH_THREADSAFE_SYMBOLICS
     getCache().clear();
   }
 
@@ -158,6 +158,18 @@ namespace casadi {
     evaluateGen<double, DMatrixPtrV, DMatrixPtrVV>(input, output, itmp, rtmp);
   }
 
+  template<bool ScX, bool ScY>
+  void BinaryMX<ScX, ScY>::evaluateNZ(const double** input, double** output, int* itmp,
+                                     double* rtmp) {
+    if (!ScX && !ScY) {
+      casadi_math<double>::fun(op_, input[0], input[1], output[0], size());
+    } else if (ScX) {
+      casadi_math<double>::fun(op_, input[0][0], input[1],    output[0], size());
+    } else {
+      casadi_math<double>::fun(op_, input[0],    input[1][0], output[0], size());
+    }
+  }
+
   template<bool ScX, bool ScY>
   void BinaryMX<ScX, ScY>::evaluateSX(const SXPtrV& input, SXPtrV& output, std::vector<int>& itmp,
                                      std::vector<SXElement>& rtmp) {
@@ -46,6 +46,15 @@ namespace casadi {
     evaluateGen<double, DMatrixPtrV, DMatrixPtrVV>(input, output, itmp, rtmp);
   }
 
+  void Concat::evaluateNZ(const double** input, double** output, int* itmp, double* rtmp) {
+    double* res_ptr = output[0];
+    for (int i=0; i<ndep(); ++i) {
+      int n = dep(i).size();
+      copy(input[i], input[i]+n, res_ptr);
+      res_ptr += n;
+    }
+  }
+
   void Concat::evaluateSX(const SXPtrV& input, SXPtrV& output, std::vector<int>& itmp,
                           std::vector<SXElement>& rtmp) {
     evaluateGen<SXElement, SXPtrV, SXPtrVV>(input, output, itmp, rtmp);
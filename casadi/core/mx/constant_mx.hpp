@@ -122,6 +122,14 @@ namespace casadi {
       ConstantMX::evaluateD(input, output, itmp, rtmp);
     }
 
+    /** \brief  Evaluate the function numerically, nonzeros passed as raw pointers */
+    virtual void evaluateNZ(const double** input, double** output, int* itmp, double* rtmp) {
+      std::copy(x_.begin(), x_.end(), output[0]);
+    }
+
+    /** \brief  Is evaluateNZ implemented? */
+    virtual bool hasEvaluateNZ() const { return true;}
+
     /** \brief  Evaluate the function symbolically (SX) */
     virtual void evaluateSX(const SXPtrV& input, SXPtrV& output, std::vector<int>& itmp,
                             std::vector<SXElement>& rtmp) {
@@ -182,6 +190,12 @@ namespace casadi {
     virtual void evaluateD(const DMatrixPtrV& input, DMatrixPtrV& output, std::vector<int>& itmp,
                            std::vector<double>& rtmp) {}
 
+    /** \brief  Evaluate the function numerically, nonzeros passed as raw pointers */
+    virtual void evaluateNZ(const double** input, double** output, int* itmp, double* rtmp) {}
+
+    /** \brief  Is evaluateNZ implemented? */
+    virtual bool hasEvaluateNZ() const { return true;}
+
     /** \brief  Evaluate the function symbolically (SX) */
     virtual void evaluateSX(const SXPtrV& input, SXPtrV& output, std::vector<int>& itmp,
                             std::vector<SXElement>& rtmp) {}
@@ -253,6 +267,14 @@ namespace casadi {
     virtual void evaluateD(const DMatrixPtrV& input, DMatrixPtrV& output, std::vector<int>& itmp,
                            std::vector<double>& rtmp);
 
+    /** \brief  Evaluate the function numerically, nonzeros passed as raw pointers */
+    virtual void evaluateNZ(const double** input, double** output, int* itmp, double* rtmp) {
+      std::fill_n(output[0], size(), static_cast<double>(v_.value));
+    }
+
+    /** \brief  Is evaluateNZ implemented? */
+    virtual bool hasEvaluateNZ() const { return true;}
+
     /** \brief  Evaluate the function symbolically (SX) */
     virtual void evaluateSX(const SXPtrV& input, SXPtrV& output, std::vector<int>& itmp,
                             std::vector<SXElement>& rtmp);
@@ -44,6 +44,15 @@ namespace casadi {
     evaluateGen<double, DMatrixPtrV, DMatrixPtrVV>(input, output, itmp, rtmp);
   }
 
+  void GetNonzerosVector::evaluateNZ(const double** input, double** output, int* itmp,
+                                     double* rtmp) {
+    const double* idata = input[0];
+    double* odata = output[0];
+    for (vector<int>::const_iterator k=nz_.begin(); k!=nz_.end(); ++k) {
+      *odata++ = *k>=0 ? idata[*k] : 0;
+    }
+  }
+
   void GetNonzerosVector::evaluateSX(const SXPtrV& input, SXPtrV& output, std::vector<int>& itmp,
                                      std::vector<SXElement>& rtmp) {
     evaluateGen<SXElement, SXPtrV, SXPtrVV>(input, output, itmp, rtmp);
@@ -64,6 +73,16 @@ namespace casadi {
     evaluateGen<double, DMatrixPtrV, DMatrixPtrVV>(input, output, itmp, rtmp);
   }
 
+  void GetNonzerosSlice::evaluateNZ(const double** input, double** output, int* itmp,
+                                    double* rtmp) {
+    const double* idata_ptr = input[0] + s_.start_;
+    const double* idata_stop = input[0] + s_.stop_;
+    double* odata_ptr = output[0];
+    for (; idata_ptr != idata_stop; idata_ptr += s_.step_) {
+      *odata_ptr++ = *idata_ptr;
+    }
+  }
+
   void GetNonzerosSlice::evaluateSX(const SXPtrV& input, SXPtrV& output, std::vector<int>& itmp,
                                     std::vector<SXElement>& rtmp) {
     evaluateGen<SXElement, SXPtrV, SXPtrVV>(input, output, itmp, rtmp);
@@ -87,6 +106,20 @@ namespace casadi {
     evaluateGen<double, DMatrixPtrV, DMatrixPtrVV>(input, output, itmp, rtmp);
   }
 
+  void GetNonzerosSlice2::evaluateNZ(const double** input, double** output, int* itmp,
+                                     double* rtmp) {
+    const double* outer_ptr = input[0] + outer_.start_;
+    const double* outer_stop = input[0] + outer_.stop_;
+    double* odata_ptr = output[0];
+    for (; outer_ptr != outer_stop; outer_ptr += outer_.step_) {
+      for (const double* inner_ptr = outer_ptr+inner_.start_;
+          inner_ptr != outer_ptr+inner_.stop_;
+          inner_ptr += inner_.step_) {
+        *odata_ptr++ = *inner_ptr;
+      }
+    }
+  }
+
   void GetNonzerosSlice2::evaluateSX(const SXPtrV& input, SXPtrV& output, std::vector<int>& itmp,
                                      std::vector<SXElement>& rtmp) {
     evaluateGen<SXElement, SXPtrV, SXPtrVV>(input, output, itmp, rtmp);
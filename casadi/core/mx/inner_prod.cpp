@@ -77,6 +77,10 @@ namespace casadi {
     evaluateGen<double, DMatrixPtrV, DMatrixPtrVV>(input, output, itmp, rtmp);
   }
 
+  void InnerProd::evaluateNZ(const double** input, double** output, int* itmp, double* rtmp) {
+    *output[0] = casadi_dot(dep(0).size(), input[0], 1, input[1], 1);
+  }
+
   void InnerProd::evaluateSX(const SXPtrV& input, SXPtrV& output, std::vector<int>& itmp,
                              std::vector<SXElement>& rtmp) {
     evaluateGen<SXElement, SXPtrV, SXPtrVV>(input, output, itmp, rtmp);
@@ -53,6 +53,12 @@ namespace casadi {
     virtual void evaluateD(const DMatrixPtrV& input, DMatrixPtrV& output, std::vector<int>& itmp,
                            std::vector<double>& rtmp);
 
+    /** \brief  Evaluate the function numerically, nonzeros passed as raw pointers */
+    virtual void evaluateNZ(const double** input, double** output, int* itmp, double* rtmp);
+
+    /** \brief  Is evaluateNZ implemented? */
+    virtual bool hasEvaluateNZ() const { return true;}
+
     /** \brief  Evaluate the function symbolically (SX) */
     virtual void evaluateSX(const SXPtrV& input, SXPtrV& output, std::vector<int>& itmp,
                             std::vector<SXElement>& rtmp);
@@ -64,6 +64,48 @@ namespace casadi {
     evaluateGen<double, DMatrixPtrV, DMatrixPtrVV>(input, output, itmp, rtmp);
   }
 
+  void Multiplication::evaluateNZ(const double** input, double** output, int* itmp,
+                                  double* rtmp) {
+    double* z_data = output[0];
+    if (input[0]!=z_data) {
+      copy(input[0], input[0]+size(), z_data);
+    }
+    const double* x_data = input[1];
+    const double* y_data = input[2];
+
+    // Sparsity patterns
+    const vector<int> &x_colind = dep(1).colind();
+    const vector<int> &x_row = dep(1).row();
+    const vector<int> &y_colind = dep(2).colind();
+    const vector<int> &y_row = dep(2).row();
+    const vector<int> &z_colind = sparsity().colind();
+    const vector<int> &z_row = sparsity().row();
+
+    // Loop over the columns of y and z
+    int ncol = size2();
+    for (int cc=0; cc<ncol; ++cc) {
+      // Get the dense column of z
+      for (int kk=z_colind[cc]; kk<z_colind[cc+1]; ++kk) {
+        rtmp[z_row[kk]] = z_data[kk];
+      }
+
+      // Loop over the nonzeros of y
+      for (int kk=y_colind[cc]; kk<y_colind[cc+1]; ++kk) {
+        int rr = y_row[kk];
+
+        // Loop over corresponding columns of x
+        for (int kk1=x_colind[rr]; kk1<x_colind[rr+1]; ++kk1) {
+          rtmp[x_row[kk1]] += x_data[kk1] * y_data[kk];
+        }
+      }
+
+      // Get the sparse column of z
+      for (int kk=z_colind[cc]; kk<z_colind[cc+1]; ++kk) {
+        z_data[kk] = rtmp[z_row[kk]];
+      }
+    }
+  }
+
   void Multiplication::evaluateSX(const SXPtrV& input, SXPtrV& output,
                                   std::vector<int>& itmp, std::vector<SXElement>& rtmp) {
     evaluateGen<SXElement, SXPtrV, SXPtrVV>(input, output, itmp, rtmp);
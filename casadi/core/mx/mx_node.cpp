@@ -58,6 +58,7 @@ namespace casadi {
 
   MXNode::MXNode() {
     temp = 0;
+    nnz_ = 0;
   }
 
   MXNode::~MXNode() {
@@ -143,6 +144,7 @@ namespace casadi {
 
   void MXNode::setSparsity(const Sparsity& sparsity) {
     sparsity_ = sparsity;
+    nnz_ = sparsity.size();
   }
 
   void MXNode::setDependencies(const MX& dep) {
@@ -238,6 +240,11 @@ namespace casadi {
                           + typeid(*this).name());
   }
 
+  void MXNode::evaluateNZ(const double** input, double** output, int* itmp, double* rtmp) {
+    throw CasadiException(string("MXNode::evaluateNZ not defined for class ")
+                          + typeid(*this).name());
+  }
+
   void MXNode::evaluateSX(const SXPtrV& input, SXPtrV& output, std::vector<int>& itmp,
                           std::vector<SXElement>& rtmp) {
     throw CasadiException(string("MXNode::evaluateSX not defined for class ")
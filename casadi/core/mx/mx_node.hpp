@@ -135,6 +135,18 @@ namespace casadi {
     virtual void evaluateD(const DMatrixPtrV& input, DMatrixPtrV& output, std::vector<int>& itmp,
                            std::vector<double>& rtmp);
 
+    /** \brief  Evaluate numerically, nonzeros passed as raw pointers
+     *
+     * Used by MXFunction when all intermediates live in a single arena. Only called if
+     * hasEvaluateNZ() returns true. The result may alias the first numInplace() arguments,
+     * but it need not, so an inplace operation must copy its argument if the pointers differ.
+     * The temporary vectors are at least as long as requested by nTmp.
+     */
+    virtual void evaluateNZ(const double** input, double** output, int* itmp, double* rtmp);
+
+    /** \brief  Is evaluateNZ implemented? */
+    virtual bool hasEvaluateNZ() const { return false;}
+
     /** \brief  Evaluate symbolically (SX) */
     virtual void evaluateSX(const SXPtrV& input, SXPtrV& output, std::vector<int>& itmp,
                             std::vector<SXElement>& rtmp);
@@ -210,7 +222,7 @@ namespace casadi {
 
     /// Get shape
     int numel() const { return sparsity().numel(); }
-    int size() const { return sparsity().size(); }
+    int size() const { return nnz_; }
     int size1() const { return sparsity().size1(); }
     int size2() const { return sparsity().size2(); }
     std::pair<int, int> shape() const { return sparsity().shape();}
@@ -378,6 +390,9 @@ namespace casadi {
     /** \brief  The sparsity pattern */
     Sparsity sparsity_;
 
+    /** \brief  Number of nonzeros, cached since it is needed in every evaluation */
+    int nnz_;
+
     /** \brief  Propagate sparsity, no work */
     virtual void propagateSparsity(DMatrixPtrV& input, DMatrixPtrV& output, bool fwd);
 
@@ -49,6 +49,13 @@ namespace casadi {
     evaluateGen<double, DMatrixPtrV, DMatrixPtrVV>(input, output, itmp, rtmp);
   }
 
+  void Reshape::evaluateNZ(const double** input, double** output, int* itmp, double* rtmp) {
+    // Quick return if inplace
+    if (input[0]==output[0]) return;
+
+    copy(input[0], input[0]+size(), output[0]);
+  }
+
   void Reshape::evaluateSX(const SXPtrV& input, SXPtrV& output, std::vector<int>& itmp,
                            std::vector<SXElement>& rtmp) {
     evaluateGen<SXElement, SXPtrV, SXPtrVV>(input, output, itmp, rtmp);
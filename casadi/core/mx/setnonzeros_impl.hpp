@@ -277,6 +277,23 @@ namespace casadi {
     evaluateGen<double, DMatrixPtrV, DMatrixPtrVV>(input, output, itmp, rtmp);
   }
 
+  template<bool Add>
+  void SetNonzerosVector<Add>::evaluateNZ(const double** input, double** output, int* itmp,
+                                          double* rtmp) {
+    double* odata = output[0];
+    if (input[0] != odata) {
+      copy(input[0], input[0]+this->dep(0).size(), odata);
+    }
+    const double* idata = input[1];
+    for (vector<int>::const_iterator k=this->nz_.begin(); k!=this->nz_.end(); ++k, ++idata) {
+      if (Add) {
+        if (*k>=0) odata[*k] += *idata;
+      } else {
+        if (*k>=0) odata[*k] = *idata;
+      }
+    }
+  }
+
   template<bool Add>
   void SetNonzerosVector<Add>::evaluateSX(const SXPtrV& input, SXPtrV& output,
                                           std::vector<int>& itmp, std::vector<SXElement>& rtmp) {
@@ -309,6 +326,25 @@ namespace casadi {
     evaluateGen<double, DMatrixPtrV, DMatrixPtrVV>(input, output, itmp, rtmp);
   }
 
+  template<bool Add>
+  void SetNonzerosSlice<Add>::evaluateNZ(const double** input, double** output, int* itmp,
+                                         double* rtmp) {
+    double* odata = output[0];
+    if (input[0] != odata) {
+      copy(input[0], input[0]+this->dep(0).size(), odata);
+    }
+    const double* idata_ptr = input[1];
+    double* odata_ptr = odata + s_.start_;
+    double* odata_stop = odata + s_.stop_;
+    for (; odata_ptr != odata_stop; odata_ptr += s_.step_) {
+      if (Add) {
+        *odata_ptr += *idata_ptr++;
+      } else {
+        *odata_ptr = *idata_ptr++;
+      }
+    }
+  }
+
   template<bool Add>
   void SetNonzerosSlice<Add>::evaluateSX(const SXPtrV& input, SXPtrV& output,
                                          std::vector<int>& itmp, std::vector<SXElement>& rtmp) {
@@ -344,6 +380,29 @@ namespace casadi {
     evaluateGen<double, DMatrixPtrV, DMatrixPtrVV>(input, output, itmp, rtmp);
   }
 
+  template<bool Add>
+  void SetNonzerosSlice2<Add>::evaluateNZ(const double** input, double** output, int* itmp,
+                                          double* rtmp) {
+    double* odata = output[0];
+    if (input[0] != odata) {
+      copy(input[0], input[0]+this->dep(0).size(), odata);
+    }
+    const double* idata_ptr = input[1];
+    double* outer_ptr = odata + outer_.start_;
+    double* outer_stop = odata + outer_.stop_;
+    for (; outer_ptr != outer_stop; outer_ptr += outer_.step_) {
+      for (double* inner_ptr = outer_ptr+inner_.start_;
+          inner_ptr != outer_ptr+inner_.stop_;
+          inner_ptr += inner_.step_) {
+        if (Add) {
+          *inner_ptr += *idata_ptr++;
+        } else {
+          *inner_ptr = *idata_ptr++;
+        }
+      }
+    }
+  }
+
   template<bool Add>
   void SetNonzerosSlice2<Add>::evaluateSX(const SXPtrV& input, SXPtrV& output,
                                           std::vector<int>& itmp, std::vector<SXElement>& rtmp) {
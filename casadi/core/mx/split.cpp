@@ -48,6 +48,15 @@ namespace casadi {
     evaluateGen<double, DMatrixPtrV, DMatrixPtrVV>(input, output, itmp, rtmp);
   }
 
+  void Split::evaluateNZ(const double** input, double** output, int* itmp, double* rtmp) {
+    int nx = offset_.size()-1;
+    for (int i=0; i<nx; ++i) {
+      if (output[i]!=0) {
+        copy(input[0]+offset_[i], input[0]+offset_[i+1], output[i]);
+      }
+    }
+  }
+
   void Split::evaluateSX(const SXPtrV& input, SXPtrV& output, std::vector<int>& itmp,
                          std::vector<SXElement>& rtmp) {
     evaluateGen<SXElement, SXPtrV, SXPtrVV>(input, output, itmp, rtmp);
@@ -47,6 +47,32 @@ namespace casadi {
     evaluateGen<double, DMatrixPtrV, DMatrixPtrVV>(input, output, itmp, rtmp);
   }
 
+  void Transpose::evaluateNZ(const double** input, double** output, int* itmp, double* rtmp) {
+    const vector<int>& x_row = dep().row();
+    const vector<int>& xT_colind = sparsity().colind();
+    const double* x = input[0];
+    double* xT = output[0];
+
+    // Transpose
+    copy(xT_colind.begin(), xT_colind.end(), itmp);
+    for (int el=0; el<x_row.size(); ++el) {
+      xT[itmp[x_row[el]]++] = x[el];
+    }
+  }
+
+  void DenseTranspose::evaluateNZ(const double** input, double** output, int* itmp,
+                                  double* rtmp) {
+    int x_ncol = dep().size2();
+    int x_nrow = dep().size1();
+    const double* x = input[0];
+    double* xT = output[0];
+    for (int i=0; i<x_ncol; ++i) {
+      for (int j=0; j<x_nrow; ++j) {
+        xT[i+j*x_ncol] = x[j+i*x_nrow];
+      }
+    }
+  }
+
   void Transpose::evaluateSX(const SXPtrV& input, SXPtrV& output, std::vector<int>& itmp,
                              std::vector<SXElement>& rtmp) {
     evaluateGen<SXElement, SXPtrV, SXPtrVV>(input, output, itmp, rtmp);
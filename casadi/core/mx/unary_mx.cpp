@@ -67,6 +67,15 @@ namespace casadi {
     }
   }
 
+  void UnaryMX::evaluateNZ(const double** input, double** output, int* itmp, double* rtmp) {
+    double nan = numeric_limits<double>::quiet_NaN();
+    const double* x = input[0];
+    double* r = output[0];
+    for (int i=0; i<size(); ++i) {
+      casadi_math<double>::fun(op_, x[i], nan, r[i]);
+    }
+  }
+
   void UnaryMX::evaluateSX(const SXPtrV& input, SXPtrV& output, std::vector<int>& itmp,
                            std::vector<SXElement>& rtmp) {
     // Do the operation on all non-zero elements
@@ -25,10 +25,6 @@
 
 #include "profiling.hpp"
 
-namespace casadi {
-
-#ifdef WITH_PROFILING
-
 /*
  * Author:  David Robert Nadeau
  * Site:    http://NadeauSoftware.com/
@@ -53,6 +49,8 @@ namespace casadi {
 #error "Unable to define getRealTime( ) for an unknown OS."
 #endif
 
+namespace casadi {
+
 double getRealTime() {
 #if defined(_WIN32)
     FILETIME tm;
@@ -122,8 +120,4 @@ double getRealTime() {
 #endif
 }
 
-#else //WITH_PROFILING
- double getRealTime() { return 0; }
-#endif
-
 } // namespace casadi
@@ -251,6 +251,9 @@ namespace casadi {
   }
 
   WeakRef* SharedObjectNode::weak() {
+#ifdef WITH_THREADSAFE_SYMBOLICS
+    std::lock_guard<std::mutex> lock(WeakRef::getMutex());
+#endif // WITH_THREADSAFE_SYMBOLICS
     if (weak_ref_==0) {
       weak_ref_ = new WeakRef(this);
     }
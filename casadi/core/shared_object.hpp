@@ -26,10 +26,14 @@
 #ifndef CASADI_SHARED_OBJECT_HPP
 #define CASADI_SHARED_OBJECT_HPP
 
+#include <casadi/core/casadi_config.hpp>
 #include "printable_object.hpp"
 #include "casadi_exception.hpp"
 #include <map>
 #include <vector>
+#ifdef WITH_THREADSAFE_SYMBOLICS
+#include <atomic>
+#endif // WITH_THREADSAFE_SYMBOLICS
 
 namespace casadi {
 
@@ -195,6 +199,7 @@ namespace casadi {
   /// Internal class for the reference counting framework, see comments on the public class.
   class CASADI_EXPORT SharedObjectNode {
     friend class SharedObject;
+    friend class WeakRef;
   public:
 
     /// Default constructor
@@ -261,7 +266,11 @@ namespace casadi {
 
   private:
     /// Number of references pointing to the object
+#ifdef WITH_THREADSAFE_SYMBOLICS
+    std::atomic<unsigned int> count;
+#else // WITH_THREADSAFE_SYMBOLICS
     unsigned int count;
+#endif // WITH_THREADSAFE_SYMBOLICS
 
     /// Weak pointer (non-owning) object for the object
     WeakRef* weak_ref_;
@@ -319,6 +319,10 @@ namespace casadi {
   template<typename T>
   std::vector<T> toVector(const T& v0, const T& v1, const T& v2);
 
+  /// Checks if an array of length n does not contain NaN or Inf
+  template<typename T>
+  bool isRegular(const T* v, int n);
+
 #endif // SWIG
 
 
@@ -732,7 +736,12 @@ namespace casadi {
 
   template<typename T>
   bool isRegular(const std::vector<T> &v) {
-    for (int k=0;k<v.size();++k) {
+    return isRegular(v.empty() ? 0 : &v.front(), v.size());
+  }
+
+  template<typename T>
+  bool isRegular(const T* v, int n) {
+    for (int k=0;k<n;++k) {
       if (v[k]!=v[k] || v[k]==std::numeric_limits<T>::infinity() ||
           v[k]==-std::numeric_limits<T>::infinity()) return false;
     }
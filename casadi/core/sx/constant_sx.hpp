@@ -26,6 +26,7 @@
 #ifndef CASADI_CONSTANT_SX_HPP
 #define CASADI_CONSTANT_SX_HPP
 
+#include <casadi/core/casadi_config.hpp>
 #include "sx_node.hpp"
 #include <cassert>
 
@@ -47,6 +48,10 @@
 #define CACHING_MAP std::map
 #endif // USE_CXX11
 
+#ifdef WITH_THREADSAFE_SYMBOLICS
+#include <mutex>
+#endif // WITH_THREADSAFE_SYMBOLICS
+
 namespace casadi {
 
 /** \brief Represents a constant SX
@@ -81,6 +86,12 @@ virtual void print(std::ostream &stream, long& remaining_calls) const {
   stream << getValue();
 }
 
+#ifdef WITH_THREADSAFE_SYMBOLICS
+/** \brief Mutex protecting the caches of constants
+ * (storage is allocated for it in sx_element.cpp) */
+static std::mutex& getCacheMutex();
+#endif // WITH_THREADSAFE_SYMBOLICS
+
 };
 
 /** \brief  DERIVED CLASSES */
@@ -98,13 +109,26 @@ class CASADI_EXPORT RealtypeSX : public ConstantSX {
 
     /// Destructor
     virtual ~RealtypeSX() {
+#ifdef WITH_THREADSAFE_SYMBOLICS
+      std::lock_guard<std::mutex> lock(getCacheMutex());
+
+      // The entry may already have been replaced by create, see below
+      CACHING_MAP<double, RealtypeSX*>::iterator it = cached_constants_.find(value);
+      if (it!=cached_constants_.end() && it->second==this) cached_constants_.erase(it);
+#else // WITH_THREADSAFE_SYMBOLICS
       size_t num_erased = cached_constants_.erase(value);
       assert(num_erased==1);
       (void)num_erased;
+#endif // WITH_THREADSAFE_SYMBOLICS
     }
 
-    /// Static creator function (use instead of constructor)
+    /** \brief Static creator function (use instead of constructor)
+     * The reference count of the returned node has already been increased */
     inline static RealtypeSX* create(double value) {
+#ifdef WITH_THREADSAFE_SYMBOLICS
+      std::lock_guard<std::mutex> lock(getCacheMutex());
+#endif // WITH_THREADSAFE_SYMBOLICS
+
       // Try to find the constant
       CACHING_MAP<double, RealtypeSX*>::iterator it = cached_constants_.find(value);
 
@@ -112,13 +136,21 @@ class CASADI_EXPORT RealtypeSX : public ConstantSX {
       if (it==cached_constants_.end()) {
         // Allocate a new object
         RealtypeSX* n = new RealtypeSX(value);
+        n->count++;
 
         // Add to hash_table
         cached_constants_.insert(it, std::make_pair(value, n));
 
         // Return it to caller
         return n;
+      } else if (it->second->count==0) {
+        // The object is being deleted by another thread, replace it
+        RealtypeSX* n = new RealtypeSX(value);
+        n->count++;
+        it->second = n;
+        return n;
       } else { // Else, returned the object
+        it->second->count++;
         return it->second;
       }
     }
@@ -154,13 +186,26 @@ class CASADI_EXPORT IntegerSX : public ConstantSX {
 
     /// Destructor
     virtual ~IntegerSX() {
+#ifdef WITH_THREADSAFE_SYMBOLICS
+      std::lock_guard<std::mutex> lock(getCacheMutex());
+
+      // The entry may already have been replaced by create, see below
+      CACHING_MAP<int, IntegerSX*>::iterator it = cached_constants_.find(value);
+      if (it!=cached_constants_.end() && it->second==this) cached_constants_.erase(it);
+#else // WITH_THREADSAFE_SYMBOLICS
       size_t num_erased = cached_constants_.erase(value);
       assert(num_erased==1);
       (void)num_erased;
+#endif // WITH_THREADSAFE_SYMBOLICS
     }
 
-    /// Static creator function (use instead of constructor)
+    /** \brief Static creator function (use instead of constructor)
+     * The reference count of the returned node has already been increased */
     inline static IntegerSX* create(int value) {
+#ifdef WITH_THREADSAFE_SYMBOLICS
+      std::lock_guard<std::mutex> lock(getCacheMutex());
+#endif // WITH_THREADSAFE_SYMBOLICS
+
       // Try to find the constant
       CACHING_MAP<int, IntegerSX*>::iterator it = cached_constants_.find(value);
 
@@ -168,13 +213,21 @@ class CASADI_EXPORT IntegerSX : public ConstantSX {
       if (it==cached_constants_.end()) {
         // Allocate a new object
         IntegerSX* n = new IntegerSX(value);
+        n->count++;
 
         // Add to hash_table
         cached_constants_.insert(it, std::make_pair(value, n));
 
         // Return it to caller
         return n;
+      } else if (it->second->count==0) {
+        // The object is being deleted by another thread, replace it
+        IntegerSX* n = new IntegerSX(value);
+        n->count++;
+        it->second = n;
+        return n;
       } else { // Else, returned the object
+        it->second->count++;
         return it->second;
       }
     }
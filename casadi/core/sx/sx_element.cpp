@@ -44,6 +44,13 @@ namespace casadi {
   CACHING_MAP<int, IntegerSX*> IntegerSX::cached_constants_;
   CACHING_MAP<double, RealtypeSX*> RealtypeSX::cached_constants_;
 
+#ifdef WITH_THREADSAFE_SYMBOLICS
+  std::mutex& ConstantSX::getCacheMutex() {
+    static std::mutex m;
+    return m;
+  }
+#endif // WITH_THREADSAFE_SYMBOLICS
+
   SXElement::SXElement() {
     node = casadi_limits<SXElement>::nan.node;
     node->count++;
@@ -69,13 +76,21 @@ namespace casadi {
       else if (intval == 1)        node = casadi_limits<SXElement>::one.node;
       else if (intval == 2)        node = casadi_limits<SXElement>::two.node;
       else if (intval == -1)       node = casadi_limits<SXElement>::minus_one.node;
-      else                        node = IntegerSX::create(intval);
+      else {
+        // The reference count is increased by create
+        node = IntegerSX::create(intval);
+        return;
+      }
       node->count++;
     } else {
       if (isnan(val))              node = casadi_limits<SXElement>::nan.node;
       else if (isinf(val))         node = val > 0 ? casadi_limits<SXElement>::inf.node :
                                       casadi_limits<SXElement>::minus_inf.node;
-      else                        node = RealtypeSX::create(val);
+      else {
+        // The reference count is increased by create
+        node = RealtypeSX::create(val);
+        return;
+      }
       node->count++;
     }
   }
@@ -113,16 +128,16 @@ namespace casadi {
     SXNode* ret = node;
 
     // quick return if the old and new pointers point to the same object
-    if (node == scalar.node) return ret;
+    if (node == scalar.node) return 0;
 
     // decrease the counter but do not delete if this was the last pointer
-    --node->count;
+    if (--node->count != 0) ret = 0;
 
     // save the new pointer
     node = scalar.node;
     node->count++;
 
-    // Return a pointer to the old node
+    // Return a pointer to the old node, if it is no longer referenced
     return ret;
   }
 
@@ -535,7 +550,7 @@ namespace casadi {
   const SXElement casadi_limits<SXElement>::zero(new ZeroSX(), false);
   // node corresponding to a constant 1
   const SXElement casadi_limits<SXElement>::one(new OneSX(), false);
-  // node corresponding to a constant 2
+  // node corresponding to a constant 2 (the reference taken by create is never released)
   const SXElement casadi_limits<SXElement>::two(IntegerSX::create(2), false);
   // node corresponding to a constant -1
   const SXElement casadi_limits<SXElement>::minus_one(new MinusOneSX(), false);
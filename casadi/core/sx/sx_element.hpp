@@ -262,7 +262,7 @@ namespace casadi {
     void assignIfDuplicate(const SXElement& scalar, int depth=1);
 
     /** \brief Assign the node to something, without invoking the deletion of the node,
-     * if the count reaches 0 */
+     * if the count reaches 0. Returns the old node if this was the case, null otherwise */
     SXNode* assignNoDelete(const SXElement& scalar);
     /// \endcond
 
@@ -26,10 +26,14 @@
 #ifndef CASADI_SX_NODE_HPP
 #define CASADI_SX_NODE_HPP
 
+#include <casadi/core/casadi_config.hpp>
 #include <iostream>
 #include <string>
 #include <sstream>
 #include <math.h>
+#ifdef WITH_THREADSAFE_SYMBOLICS
+#include <atomic>
+#endif // WITH_THREADSAFE_SYMBOLICS
 
 /** \brief  Scalar expression (which also works as a smart pointer class to this class) */
 #include "sx_element.hpp"
@@ -123,7 +127,11 @@ namespace casadi {
     int temp;
 
     // Reference counter -- counts the number of parents of the node
+#ifdef WITH_THREADSAFE_SYMBOLICS
+    std::atomic<unsigned int> count;
+#else // WITH_THREADSAFE_SYMBOLICS
     unsigned int count;
+#endif // WITH_THREADSAFE_SYMBOLICS
 
   };
 
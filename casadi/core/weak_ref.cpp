@@ -34,14 +34,33 @@ namespace casadi {
   }
 
   bool WeakRef::alive() const {
+#ifdef WITH_THREADSAFE_SYMBOLICS
+    std::lock_guard<std::mutex> lock(getMutex());
+#endif // WITH_THREADSAFE_SYMBOLICS
     return !isNull() && (*this)->raw_ != 0;
   }
 
   SharedObject WeakRef::shared() {
     SharedObject ret;
+#ifdef WITH_THREADSAFE_SYMBOLICS
+    std::lock_guard<std::mutex> lock(getMutex());
+    SharedObjectNode* raw = isNull() ? 0 : (*this)->raw_;
+    if (raw!=0) {
+      // The object may be in the process of being deleted by another thread, in which case its
+      // reference count has already reached zero and it must not be resurrected. Deletion
+      // cannot complete before the lock is released, since kill() needs the same lock.
+      unsigned int c = raw->count;
+      while (c!=0 && !raw->count.compare_exchange_weak(c, c+1)) {}
+      if (c!=0) {
+        ret.assignNode(raw);
+        raw->count--;
+      }
+    }
+#else // WITH_THREADSAFE_SYMBOLICS
     if (alive()) {
       ret.assignNode((*this)->raw_);
     }
+#endif // WITH_THREADSAFE_SYMBOLICS
     return ret;
   }
 
@@ -62,9 +81,19 @@ namespace casadi {
   }
 
   void WeakRef::kill() {
+#ifdef WITH_THREADSAFE_SYMBOLICS
+    std::lock_guard<std::mutex> lock(getMutex());
+#endif // WITH_THREADSAFE_SYMBOLICS
     (*this)->raw_ = 0;
   }
 
+#ifdef WITH_THREADSAFE_SYMBOLICS
+  std::mutex& WeakRef::getMutex() {
+    static std::mutex m;
+    return m;
+  }
+#endif // WITH_THREADSAFE_SYMBOLICS
+
   WeakRefInternal::WeakRefInternal(SharedObjectNode* raw) : raw_(raw) {
   }
 
@@ -26,7 +26,11 @@
 #ifndef CASADI_WEAK_REF_HPP
 #define CASADI_WEAK_REF_HPP
 
+#include <casadi/core/casadi_config.hpp>
 #include "shared_object.hpp"
+#ifdef WITH_THREADSAFE_SYMBOLICS
+#include <mutex>
+#endif // WITH_THREADSAFE_SYMBOLICS
 
 
 /// \cond INTERNAL
@@ -70,6 +74,11 @@ namespace casadi {
 
     /** \brief The shared object has been deleted */
     void kill();
+
+#ifdef WITH_THREADSAFE_SYMBOLICS
+    /** \brief Mutex protecting the raw pointers of all weak references */
+    static std::mutex& getMutex();
+#endif // WITH_THREADSAFE_SYMBOLICS
 #endif // SWIG
  };
 
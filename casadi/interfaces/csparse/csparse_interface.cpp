@@ -48,6 +48,20 @@ namespace casadi {
 
   CsparseInterface::CsparseInterface(const Sparsity& sparsity, int nrhs)
       : LinearSolverInternal(sparsity, nrhs) {
+    addOption("ordering", OT_STRING, "natural",
+              "Fill-reducing column ordering computed once in the symbolic analysis: "
+              "natural, amd (on A+A^T, for nearly symmetric patterns) or "
+              "colamd (on A^T*A with dense rows removed, for general patterns)",
+              "natural|amd|colamd");
+    addOption("refactorize", OT_BOOLEAN, false,
+              "Reuse the pivot sequence and the patterns of L and U of the previous "
+              "factorization and only recompute their values. Falls back to a full "
+              "factorization with partial pivoting when a pivot becomes unstable.");
+    addOption("pivot_tol", OT_REAL, 1e-8,
+              "Threshold for preferring the diagonal entry in partial pivoting");
+    addOption("refactorize_tol", OT_REAL, 1e-3,
+              "A reused pivot is accepted if its magnitude is at least refactorize_tol "
+              "times the largest entry below it in the same column");
     N_ = 0;
     S_ = 0;
   }
@@ -80,6 +94,23 @@ namespace casadi {
     // Temporary
     temp_.resize(A_.n);
 
+    // Read options
+    string ordering = getOption("ordering");
+    if (ordering=="natural") {
+      order_ = 0;
+    } else if (ordering=="amd") {
+      order_ = 1;
+    } else if (ordering=="colamd") {
+      order_ = 2;
+    } else {
+      casadi_error("CsparseInterface::init: Unknown ordering \"" << ordering << "\"");
+    }
+    refactorize_ = getOption("refactorize");
+    pivot_tol_ = getOption("pivot_tol");
+    refactorize_tol_ = getOption("refactorize_tol");
+    xwork_.resize(A_.n);
+    n_factorize_ = n_refactorize_ = n_repivot_ = 0;
+
     // Has the routine been called once
     called_once_ = false;
 
@@ -98,20 +129,69 @@ namespace casadi {
       time_start = getRealTime(); // Start timer
       profileWriteEntry(CasadiOptions::profilingLog, this);
     }
+    double time_symbolic = gather_stats_ ? getRealTime() : 0;
     if (!called_once_) {
       if (verbose()) {
         cout << "CsparseInterface::prepare: symbolic factorization" << endl;
       }
 
       // ordering and symbolic analysis
-      int order = 0; // ordering?
       if (S_) cs_sfree(S_);
-      S_ = cs_sqr(order, &A_, 0) ;
+      S_ = cs_sqr(order_, &A_, 0) ;
+      casadi_assert_message(S_!=0, "CsparseInterface::prepare: symbolic analysis failed");
+      if (N_) {
+        cs_nfree(N_);
+        N_ = 0;
+      }
+      if (gather_stats_) stats_["t_symbolic"] = getRealTime() - time_symbolic;
     }
 
     prepared_ = false;
     called_once_ = true;
 
+    if (verbose()) {
+      cout << "CsparseInterface::prepare: numeric factorization" << endl;
+      cout << "linear system to be factorized = " << endl;
+      input(0).printSparse();
+    }
+
+    double time_numeric = gather_stats_ ? getRealTime() : 0;
+    if (refactorize_ && N_!=0 && refactorize()) {
+      n_refactorize_++;
+    } else {
+      if (refactorize_ && N_!=0) {
+        if (verbose()) {
+          cout << "CsparseInterface::prepare: pivot sequence unstable, repivoting" << endl;
+        }
+        n_repivot_++;
+      }
+      factorize();
+      n_factorize_++;
+
+      // Fill-in only changes when the pivot sequence changes
+      double nnz_A = A_.p[A_.n], nnz_L = N_->L->p[A_.n], nnz_U = N_->U->p[A_.n];
+      stats_["nnz_A"] = nnz_A;
+      stats_["nnz_L"] = nnz_L;
+      stats_["nnz_U"] = nnz_U;
+      stats_["fill_in"] = nnz_L + nnz_U - A_.n - nnz_A;
+    }
+    stats_["n_factorize"] = n_factorize_;
+    stats_["n_refactorize"] = n_refactorize_;
+    stats_["n_repivot"] = n_repivot_;
+    if (gather_stats_) stats_["t_factorize"] = getRealTime() - time_numeric;
+
+    prepared_ = true;
+
+    if (CasadiOptions::profiling && CasadiOptions::profilingBinary) {
+      double time_stop = getRealTime(); // Stop timer
+      profileWriteTime(CasadiOptions::profilingLog, this, 0,
+                       time_stop-time_start,
+                       time_stop-time_start);
+      profileWriteExit(CasadiOptions::profilingLog, this, time_stop-time_start);
+    }
+  }
+
+  void CsparseInterface::factorize() {
     // Get a referebce to the nonzeros of the linear system
     const vector<double>& linsys_nz = input().data();
 
@@ -121,16 +201,8 @@ namespace casadi {
       casadi_assert_message(!isinf(linsys_nz[k]), "Nonzero " << k << " is infinite");
     }
 
-    if (verbose()) {
-      cout << "CsparseInterface::prepare: numeric factorization" << endl;
-      cout << "linear system to be factorized = " << endl;
-      input(0).printSparse();
-    }
-
-    double tol = 1e-8;
-
     if (N_) cs_nfree(N_);
-    N_ = cs_lu(&A_, S_, tol) ;                 // numeric LU factorization
+    N_ = cs_lu(&A_, S_, pivot_tol_) ;                 // numeric LU factorization
     if (N_==0) {
       DMatrix temp = input();
       temp.makeSparse();
@@ -158,16 +230,58 @@ namespace casadi {
       }
     }
     casadi_assert(N_!=0);
+  }
 
-    prepared_ = true;
+  bool CsparseInterface::refactorize() {
+    // After cs_lu, the row indices of both L and U refer to pivot positions, the
+    // first entry of column k of L is the unit diagonal, the last entry of column k
+    // of U is the pivot and the remaining entries of U are in topological order
+    int n = A_.n;
+    const int *Ap = A_.p, *Ai = A_.i, *q = S_->q, *pinv = N_->pinv;
+    const double *Ax = A_.x;
+    const int *Lp = N_->L->p, *Li = N_->L->i, *Up = N_->U->p, *Ui = N_->U->i;
+    double *Lx = N_->L->x, *Ux = N_->U->x;
+    double *x = getPtr(xwork_);
+
+    // Accumulates 0*v for every value computed, becomes NaN for non-finite entries
+    double finite_check = 0;
+    bool stable = true;
+    for (int k=0; k<n && stable; ++k) {
+      // Scatter the permuted column of A
+      int col = q ? q[k] : k;
+      for (int p=Ap[col]; p<Ap[col+1]; ++p) x[pinv[Ai[p]]] = Ax[p];
+
+      // Left-looking update with the columns of L to the left
+      for (int p=Up[k]; p<Up[k+1]-1; ++p) {
+        int j = Ui[p];
+        double ujk = x[j];
+        Ux[p] = ujk;
+        finite_check += 0*ujk;
+        for (int pl=Lp[j]+1; pl<Lp[j+1]; ++pl) x[Li[pl]] -= Lx[pl]*ujk;
+        x[j] = 0;
+      }
 
-    if (CasadiOptions::profiling && CasadiOptions::profilingBinary) {
-      double time_stop = getRealTime(); // Stop timer
-      profileWriteTime(CasadiOptions::profilingLog, this, 0,
-                       time_stop-time_start,
-                       time_stop-time_start);
-      profileWriteExit(CasadiOptions::profilingLog, this, time_stop-time_start);
+      // Check the stability of the reused pivot
+      double pivot = x[k];
+      double amax = 0;
+      for (int p=Lp[k]+1; p<Lp[k+1]; ++p) amax = std::max(amax, fabs(x[Li[p]]));
+      if (!(fabs(pivot) > 0 && fabs(pivot) >= refactorize_tol_*amax)) stable = false;
+
+      // Store the pivot and scale the column of L
+      Ux[Up[k+1]-1] = pivot;
+      finite_check += 0*pivot;
+      x[k] = 0;
+      for (int p=Lp[k]+1; p<Lp[k+1]; ++p) {
+        double lik = x[Li[p]] / pivot;
+        Lx[p] = lik;
+        finite_check += 0*lik;
+        x[Li[p]] = 0;
+      }
     }
+
+    // Leave the work vector cleared if aborted early
+    if (!stable) fill(xwork_.begin(), xwork_.end(), 0);
+    return stable && finite_check==0;
   }
 
   void CsparseInterface::solve(double* x, int nrhs, bool transpose) {
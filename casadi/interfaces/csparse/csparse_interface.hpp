@@ -68,6 +68,19 @@ namespace casadi {
     // Solve the system of equations
     virtual void solve(double* x, int nrhs, bool transpose);
 
+    /** \brief Numeric refactorization reusing the pivot sequence of N_
+     *
+     * Recomputes the values of L and U in place for the current nonzeros of A,
+     * keeping the row permutation and the nonzero patterns of the last full
+     * factorization. Returns false if a reused pivot is too small relative to
+     * its column or if a non-finite value appears, in which case the caller
+     * falls back to a full factorization with partial pivoting.
+     */
+    bool refactorize();
+
+    // Full numeric factorization with partial pivoting
+    void factorize();
+
     // Clone
     virtual CsparseInterface* clone() const;
 
@@ -86,6 +99,24 @@ namespace casadi {
     // Temporary
     std::vector<double> temp_;
 
+    // Fill-reducing ordering passed to cs_sqr (0: natural, 1: amd, 2: colamd)
+    int order_;
+
+    // Reuse the pivot sequence between factorizations
+    bool refactorize_;
+
+    // Threshold for partial pivoting in cs_lu
+    double pivot_tol_;
+
+    // Smallest accepted ratio between a reused pivot and its column maximum
+    double refactorize_tol_;
+
+    // Work vector for the numeric refactorization
+    std::vector<double> xwork_;
+
+    // Number of full factorizations, numeric refactorizations and repivotings
+    int n_factorize_, n_refactorize_, n_repivot_;
+
     /// A documentation string
     static const std::string meta_doc;
 
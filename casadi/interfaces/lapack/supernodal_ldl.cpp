@@ -0,0 +1,607 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "supernodal_ldl.hpp"
+#include "../../core/std_vector_tools.hpp"
+#include "../../core/matrix/sparsity_internal.hpp"
+
+#include "../../core/profiling.hpp"
+#include "../../core/casadi_options.hpp"
+
+using namespace std;
+namespace casadi {
+
+  extern "C"
+  int CASADI_LINEARSOLVER_SUPERNODAL_EXPORT
+  casadi_register_linearsolver_supernodal(LinearSolverInternal::Plugin* plugin) {
+    plugin->creator = SupernodalLdl::creator;
+    plugin->name = "supernodal";
+    plugin->doc = SupernodalLdl::meta_doc.c_str();
+    plugin->version = 22;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_LINEARSOLVER_SUPERNODAL_EXPORT casadi_load_linearsolver_supernodal() {
+    LinearSolverInternal::registerPlugin(casadi_register_linearsolver_supernodal);
+  }
+
+  SupernodalLdl::SupernodalLdl(const Sparsity& sparsity, int nrhs)
+      : LinearSolverInternal(sparsity, nrhs) {
+    addOption("ordering", OT_STRING, "amd",
+              "Fill-reducing ordering: amd (approximate minimum degree on A) or natural",
+              "amd|natural");
+    addOption("pivot_perturbation", OT_REAL, 1e-8,
+              "Pivots that cannot be chosen within a supernode with a magnitude above "
+              "pivot_perturbation times max(1, largest entry of A) are replaced by plus or "
+              "minus this threshold and counted as zero eigenvalues in the inertia");
+    addOption("max_refinement", OT_INTEGER, 5,
+              "Maximum number of iterative refinement steps, only done if pivots were "
+              "perturbed");
+  }
+
+  SupernodalLdl::~SupernodalLdl() {
+  }
+
+  void SupernodalLdl::init() {
+    // Call the base class initializer
+    LinearSolverInternal::init();
+
+    const Sparsity& sp = input(LINSOL_A).sparsity();
+    casadi_assert_message(sp.isSquare() && sp.isSymmetric(),
+                          "SupernodalLdl::init: the sparsity pattern must be symmetric");
+    n_ = sp.size2();
+
+    // Fill-reducing ordering
+    vector<int> p;
+    if (getOption("ordering")=="amd" && n_>0) {
+      p = sp->approximateMinimumDegree(1);
+      p.resize(n_);
+    } else {
+      p = range(n_);
+    }
+
+    // Postorder the elimination tree so that supernodes have consecutive columns
+    vector<int> mapping;
+    vector<int> post = SparsityInternal::postorder(sp.sub(p, p, mapping).eliminationTree(), n_);
+    perm_.resize(n_);
+    for (int k=0; k<n_; ++k) perm_[k] = p[post[k]];
+    mapping.clear();
+    Sparsity C = sp.sub(perm_, perm_, mapping);
+    vector<int> parent = C.eliminationTree();
+    const vector<int>& colind = C.colind();
+    const vector<int>& row = C.row();
+
+    // Number of off-diagonal nonzeros in each column of L, from the row subtrees
+    vector<int> colcount(n_, 0), mark(n_, -1);
+    for (int i=0; i<n_; ++i) {
+      mark[i] = i;
+      for (int el=colind[i]; el<colind[i+1]; ++el) {
+        for (int k=row[el]; k<i && mark[k]!=i; k=parent[k]) {
+          colcount[k]++;
+          mark[k] = i;
+        }
+      }
+    }
+
+    // Fundamental supernodes: column j-1 joins column j if j is its parent and the
+    // structures coincide below j
+    vector<int> fundamental;
+    for (int j=0; j<n_; ++j) {
+      if (j==0 || parent[j-1]!=j || colcount[j-1]!=colcount[j]+1) fundamental.push_back(j);
+    }
+    fundamental.push_back(n_);
+
+    // Relaxed supernodes: merge a supernode into the next one if it is its parent, allowing
+    // a fraction of explicit zeros that decreases with the size (thresholds from CHOLMOD)
+    super_.clear();
+    super_.push_back(0);
+    double nz_current = 0, zeros_current = 0;
+    for (int s=0; s+1<fundamental.size(); ++s) {
+      int f = fundamental[s], l = fundamental[s+1];
+      int nc = l-f, m = colcount[l-1];
+      double nz = 0.5*nc*(nc+1) + nc*m;
+      int f_current = super_.back();
+      if (f_current<f) {
+        // Try to merge [f_current, f) into [f, l)
+        int nc_current = f-f_current;
+        int nc_merged = nc_current + nc;
+        double nz_merged = 0.5*nc_merged*(nc_merged+1) + nc_merged*m;
+        double zeros = zeros_current + nz_merged - nz_current - nz;
+        double frac = zeros/nz_merged;
+        bool merge = parent[f-1]==f &&
+          (nc_merged<=4 || (nc_merged<=16 && frac<0.8) || (nc_merged<=48 && frac<0.1)
+           || frac<0.05);
+        if (merge) {
+          nz_current = nz_merged;
+          zeros_current = zeros;
+          continue;
+        }
+        super_.push_back(f);
+      }
+      nz_current = nz;
+      zeros_current = 0;
+    }
+    super_.push_back(n_);
+    int nsuper = super_.size()-1;
+    col2super_.resize(n_);
+    for (int s=0; s<nsuper; ++s) {
+      for (int j=super_[s]; j<super_[s+1]; ++j) col2super_[j] = s;
+    }
+
+    // Allocate the row indices and the dense blocks
+    rows_ptr_.resize(nsuper+1);
+    val_ptr_.resize(nsuper+1);
+    rows_ptr_[0] = val_ptr_[0] = 0;
+    int max_nc = 0, max_m = 0;
+    vector<int> next(nsuper);
+    for (int s=0; s<nsuper; ++s) {
+      int nc = super_[s+1]-super_[s];
+      int m = colcount[super_[s+1]-1];
+      rows_ptr_[s+1] = rows_ptr_[s] + nc + m;
+      val_ptr_[s+1] = val_ptr_[s] + (nc + m)*nc;
+      next[s] = rows_ptr_[s] + nc;
+      max_nc = std::max(max_nc, nc);
+      max_m = std::max(max_m, m);
+    }
+    rows_.resize(rows_ptr_.back());
+    for (int s=0; s<nsuper; ++s) {
+      for (int j=super_[s]; j<super_[s+1]; ++j) rows_[rows_ptr_[s]+j-super_[s]] = j;
+    }
+
+    // Rows below the diagonal blocks, in increasing order
+    fill(mark.begin(), mark.end(), -1);
+    vector<int> last_row(nsuper, -1);
+    for (int i=0; i<n_; ++i) {
+      mark[i] = i;
+      for (int el=colind[i]; el<colind[i+1]; ++el) {
+        for (int k=row[el]; k<i && mark[k]!=i; k=parent[k]) {
+          mark[k] = i;
+          int s = col2super_[k];
+          if (i>=super_[s+1] && last_row[s]!=i) {
+            rows_[next[s]++] = i;
+            last_row[s] = i;
+          }
+        }
+      }
+    }
+    for (int s=0; s<nsuper; ++s) casadi_assert(next[s]==rows_ptr_[s+1]);
+
+    // Where to place each nonzero of the lower triangular part of P'.A.P
+    amap_.resize(sp.size());
+    fill(amap_.begin(), amap_.end(), -1);
+    for (int j=0; j<n_; ++j) {
+      int s = col2super_[j];
+      int nr = rows_ptr_[s+1]-rows_ptr_[s];
+      vector<int>::const_iterator rbegin = rows_.begin()+rows_ptr_[s];
+      for (int el=colind[j]; el<colind[j+1]; ++el) {
+        int i = row[el];
+        if (i<j) continue;
+        int r = lower_bound(rbegin, rbegin+nr, i) - rbegin;
+        amap_[mapping[el]] = val_ptr_[s] + r + (j-super_[s])*nr;
+      }
+    }
+
+    // Allocate memory for the numeric factorization
+    val_.resize(val_ptr_.back());
+    ipiv_.resize(n_);
+    lperm_.resize(n_);
+    dsub_.resize(n_);
+    work_.resize(max_nc*max_nc);
+    tmp_.resize(max_nc*max_m);
+    update_.resize(max_m*max_m);
+    relpos_.resize(n_);
+    npos_ = nneg_ = nzero_ = nperturbed_ = 0;
+    pivot_perturbation_ = getOption("pivot_perturbation");
+    max_refinement_ = getOption("max_refinement");
+
+    stats_["n_supernodes"] = nsuper;
+    stats_["max_supernode"] = max_nc;
+    double nnz_L = 0;
+    for (int s=0; s<nsuper; ++s) {
+      int nc = super_[s+1]-super_[s];
+      nnz_L += nc*(nc+1)/2 + (rows_ptr_[s+1]-rows_ptr_[s]-nc)*nc;
+    }
+    stats_["nnz_L"] = nnz_L;
+
+    if (CasadiOptions::profiling && CasadiOptions::profilingBinary) {
+      profileWriteName(CasadiOptions::profilingLog, this, "SupernodalLdl",
+                       ProfilingData_FunctionType_Other, 2);
+
+      profileWriteSourceLine(CasadiOptions::profilingLog, this, 0, "prepare", -1);
+      profileWriteSourceLine(CasadiOptions::profilingLog, this, 1, "solve", -1);
+    }
+  }
+
+  void SupernodalLdl::prepare() {
+    double time_start=0;
+    if (CasadiOptions::profiling && CasadiOptions::profilingBinary) {
+      time_start = getRealTime(); // Start timer
+      profileWriteEntry(CasadiOptions::profilingLog, this);
+    }
+    prepared_ = false;
+
+    // Scatter the lower triangular part of the permuted matrix into the blocks
+    fill(val_.begin(), val_.end(), 0);
+    const vector<double>& a = input(LINSOL_A).data();
+    for (int k=0; k<a.size(); ++k) {
+      if (amap_[k]>=0) val_[amap_[k]] = a[k];
+    }
+
+    // Threshold for perturbing pivots
+    double amax = 0;
+    for (int k=0; k<a.size(); ++k) amax = std::max(amax, fabs(a[k]));
+    double delta = pivot_perturbation_*std::max(amax, 1.0);
+
+    npos_ = nneg_ = nzero_ = nperturbed_ = 0;
+    char notrans = 'N';
+    double one = 1, zero = 0;
+    int nsuper = super_.size()-1;
+    for (int s=0; s<nsuper; ++s) {
+      int f = super_[s];
+      int nc = super_[s+1]-f;
+      int nr = rows_ptr_[s+1]-rows_ptr_[s];
+      int m = nr-nc;
+      double* F = getPtr(val_) + val_ptr_[s];
+
+      // Factorize the diagonal block
+      factorizeBlock(s, delta);
+      if (m==0) continue;
+
+      // L_rs = W.F^{-1} with W the block below the diagonal block, via T = F^{-1}.W'
+      double* W = F + nc;
+      double* T = getPtr(tmp_);
+      for (int c=0; c<nc; ++c) {
+        for (int r=0; r<m; ++r) T[c+r*nc] = W[r+c*nr];
+      }
+      solveBlock(s, T, nc, m);
+
+      // Update matrix W.F^{-1}.W' for the ancestors
+      double* U = getPtr(update_);
+      dgemm_(&notrans, &notrans, &m, &m, &nc, &one, W, &nr, T, &nc, &zero, U, &m);
+      for (int c=0; c<nc; ++c) {
+        for (int r=0; r<m; ++r) W[r+c*nr] = T[c+r*nc];
+      }
+
+      // Subtract the lower triangular part of the update from the ancestors
+      const int* ri = getPtr(rows_) + rows_ptr_[s] + nc;
+      int t = -1, nrt = 0;
+      double* Ft = 0;
+      for (int jj=0; jj<m; ++jj) {
+        int g = ri[jj];
+        if (col2super_[g]!=t) {
+          t = col2super_[g];
+          nrt = rows_ptr_[t+1]-rows_ptr_[t];
+          Ft = getPtr(val_) + val_ptr_[t];
+          for (int q=0; q<nrt; ++q) relpos_[rows_[rows_ptr_[t]+q]] = q;
+        }
+        double* Ftj = Ft + (g-super_[t])*nrt;
+        for (int ii=jj; ii<m; ++ii) Ftj[relpos_[ri[ii]]] -= U[ii+jj*m];
+      }
+    }
+    stats_["n_perturbed"] = nperturbed_;
+
+    // Keep the matrix for iterative refinement
+    a_ = a;
+
+    prepared_ = true;
+
+    if (CasadiOptions::profiling && CasadiOptions::profilingBinary) {
+      double time_stop = getRealTime(); // Stop timer
+      profileWriteTime(CasadiOptions::profilingLog, this, 0,
+                       time_stop-time_start,
+                       time_stop-time_start);
+      profileWriteExit(CasadiOptions::profilingLog, this, time_stop-time_start);
+    }
+  }
+
+  void SupernodalLdl::factorizeBlock(int s, double delta) {
+    int f = super_[s];
+    int nc = super_[s+1]-f;
+    int nr = rows_ptr_[s+1]-rows_ptr_[s];
+    double* F = getPtr(val_) + val_ptr_[s];
+    int* q = getPtr(lperm_) + f;
+    int* piv = getPtr(ipiv_) + f;
+    double* dsub = getPtr(dsub_) + f;
+
+    // Work on a full symmetric copy of the diagonal block
+    double* M = getPtr(work_);
+    for (int c=0; c<nc; ++c) {
+      for (int r=c; r<nc; ++r) M[r+c*nc] = M[c+r*nc] = F[r+c*nr];
+    }
+    for (int k=0; k<nc; ++k) q[k] = k;
+
+    // Bunch-Kaufman pivoting, restricted to the supernode
+    const double alpha = (1+sqrt(17.0))/8;
+    for (int k=0; k<nc; ) {
+      double absakk = fabs(M[k+k*nc]);
+      int imax = k;
+      double colmax = 0;
+      for (int i=k+1; i<nc; ++i) {
+        if (fabs(M[i+k*nc])>colmax) {
+          colmax = fabs(M[i+k*nc]);
+          imax = i;
+        }
+      }
+      int kp = k, size = 1;
+      bool perturbed = false;
+      if (std::max(absakk, colmax)<=delta) {
+        // No acceptable pivot in the supernode: perturb
+        casadi_assert_message(delta>0, "SupernodalLdl::prepare: factorization failed, "
+                              "the matrix is singular (zero pivot in column "
+                              << perm_[f+q[k]] << ")");
+        M[k+k*nc] = M[k+k*nc]<0 ? -delta : delta;
+        perturbed = true;
+        nperturbed_++;
+      } else if (absakk<alpha*colmax) {
+        double rowmax = 0;
+        for (int j=k; j<nc; ++j) {
+          if (j!=imax) rowmax = std::max(rowmax, fabs(M[imax+j*nc]));
+        }
+        if (absakk*rowmax>=alpha*colmax*colmax) {
+          kp = k;
+        } else if (fabs(M[imax+imax*nc])>=alpha*rowmax) {
+          kp = imax;
+        } else {
+          kp = imax;
+          size = 2;
+        }
+      }
+
+      // Symmetric interchange of rows and columns kk and kp
+      int kk = k+size-1;
+      if (kp!=kk) {
+        for (int j=0; j<nc; ++j) std::swap(M[kk+j*nc], M[kp+j*nc]);
+        for (int i=0; i<nc; ++i) std::swap(M[i+kk*nc], M[i+kp*nc]);
+        std::swap(q[kk], q[kp]);
+      }
+
+      if (size==1) {
+        // 1-by-1 pivot: update the trailing matrix, then scale the column
+        double d = M[k+k*nc];
+        for (int j=k+1; j<nc; ++j) {
+          double w = M[j+k*nc]/d;
+          for (int i=k+1; i<nc; ++i) M[i+j*nc] -= M[i+k*nc]*w;
+        }
+        for (int i=k+1; i<nc; ++i) M[i+k*nc] /= d;
+        // A perturbed pivot stands for a (numerically) zero eigenvalue
+        if (perturbed) nzero_++; else if (d>0) npos_++; else nneg_++;
+        piv[k] = 1;
+        dsub[k] = 0;
+      } else {
+        // 2-by-2 pivot
+        double d11 = M[k+k*nc], d21 = M[k+1+k*nc], d22 = M[k+1+(k+1)*nc];
+        double det = d11*d22 - d21*d21;
+        for (int j=k+2; j<nc; ++j) {
+          double w1 = (d22*M[j+k*nc] - d21*M[j+(k+1)*nc])/det;
+          double w2 = (d11*M[j+(k+1)*nc] - d21*M[j+k*nc])/det;
+          for (int i=k+2; i<nc; ++i) M[i+j*nc] -= M[i+k*nc]*w1 + M[i+(k+1)*nc]*w2;
+        }
+        for (int i=k+2; i<nc; ++i) {
+          double l1 = (d22*M[i+k*nc] - d21*M[i+(k+1)*nc])/det;
+          double l2 = (d11*M[i+(k+1)*nc] - d21*M[i+k*nc])/det;
+          M[i+k*nc] = l1;
+          M[i+(k+1)*nc] = l2;
+        }
+        if (det<0) {
+          npos_++;
+          nneg_++;
+        } else if (d11>0) {
+          npos_ += 2;
+        } else {
+          nneg_ += 2;
+        }
+        piv[k] = 2;
+        piv[k+1] = 0;
+        dsub[k] = d21;
+        dsub[k+1] = 0;
+        M[k+1+k*nc] = 0;
+      }
+      k += size;
+    }
+
+    // Unit lower triangular factor below the diagonal, D on the diagonal
+    for (int c=0; c<nc; ++c) {
+      for (int r=c; r<nc; ++r) F[r+c*nr] = M[r+c*nc];
+    }
+  }
+
+  void SupernodalLdl::solveBlock(int s, double* B, int ldb, int nrhs) {
+    int f = super_[s];
+    int nc = super_[s+1]-f;
+    int nr = rows_ptr_[s+1]-rows_ptr_[s];
+    double* F = getPtr(val_) + val_ptr_[s];
+    const int* q = getPtr(lperm_) + f;
+    const int* piv = getPtr(ipiv_) + f;
+    const double* dsub = getPtr(dsub_) + f;
+    char side = 'L', uplo = 'L', notrans = 'N', trans = 'T', diag = 'U';
+    double one = 1;
+
+    // Permute
+    if (blk_.size()<nc*nrhs) blk_.resize(nc*nrhs);
+    double* Y = getPtr(blk_);
+    for (int r=0; r<nrhs; ++r) {
+      for (int i=0; i<nc; ++i) Y[i+r*nc] = B[q[i]+r*ldb];
+    }
+
+    // Y := L^{-1}.Y
+    dtrsm_(&side, &uplo, &notrans, &diag, &nc, &nrhs, &one, F, &nr, Y, &nc);
+
+    // Y := D^{-1}.Y
+    for (int k=0; k<nc; ) {
+      if (piv[k]==1) {
+        double d = F[k+k*nr];
+        for (int r=0; r<nrhs; ++r) Y[k+r*nc] /= d;
+        k++;
+      } else {
+        double d11 = F[k+k*nr], d21 = dsub[k], d22 = F[k+1+(k+1)*nr];
+        double det = d11*d22 - d21*d21;
+        for (int r=0; r<nrhs; ++r) {
+          double y1 = Y[k+r*nc], y2 = Y[k+1+r*nc];
+          Y[k+r*nc] = (d22*y1 - d21*y2)/det;
+          Y[k+1+r*nc] = (d11*y2 - d21*y1)/det;
+        }
+        k += 2;
+      }
+    }
+
+    // Y := L^{-T}.Y
+    dtrsm_(&side, &uplo, &trans, &diag, &nc, &nrhs, &one, F, &nr, Y, &nc);
+
+    // Undo the permutation
+    for (int r=0; r<nrhs; ++r) {
+      for (int i=0; i<nc; ++i) B[q[i]+r*ldb] = Y[i+r*nc];
+    }
+  }
+
+  void SupernodalLdl::solveFactored(double* x, int nrhs) {
+    char notrans = 'N', trans = 'T';
+    double one = 1, minus_one = -1, zero = 0;
+    int nsuper = super_.size()-1;
+
+    // Permute the right hand sides
+    rhs_.resize(n_*nrhs);
+    double* y = getPtr(rhs_);
+    for (int r=0; r<nrhs; ++r) {
+      for (int i=0; i<n_; ++i) y[i+r*n_] = x[perm_[i]+r*n_];
+    }
+
+    // Work vector for the rows below each diagonal block
+    int max_m = 0;
+    for (int s=0; s<nsuper; ++s) {
+      max_m = std::max(max_m, rows_ptr_[s+1]-rows_ptr_[s]-super_[s+1]+super_[s]);
+    }
+    if (tmp_.size()<max_m*nrhs) tmp_.resize(max_m*nrhs);
+    double* z = getPtr(tmp_);
+
+    // Forward substitution with the block unit lower triangular factor
+    for (int s=0; s<nsuper; ++s) {
+      int f = super_[s];
+      int nc = super_[s+1]-f;
+      int nr = rows_ptr_[s+1]-rows_ptr_[s];
+      int m = nr-nc;
+      if (m==0) continue;
+      double* F = getPtr(val_) + val_ptr_[s];
+      dgemm_(&notrans, &notrans, &m, &nrhs, &nc, &one, F+nc, &nr, y+f, &n_, &zero, z, &m);
+      const int* ri = getPtr(rows_) + rows_ptr_[s] + nc;
+      for (int r=0; r<nrhs; ++r) {
+        for (int i=0; i<m; ++i) y[ri[i]+r*n_] -= z[i+r*m];
+      }
+    }
+
+    // Block diagonal solve
+    for (int s=0; s<nsuper; ++s) solveBlock(s, y+super_[s], n_, nrhs);
+
+    // Backward substitution with the transpose
+    for (int s=nsuper-1; s>=0; --s) {
+      int f = super_[s];
+      int nc = super_[s+1]-f;
+      int nr = rows_ptr_[s+1]-rows_ptr_[s];
+      int m = nr-nc;
+      if (m==0) continue;
+      double* F = getPtr(val_) + val_ptr_[s];
+      const int* ri = getPtr(rows_) + rows_ptr_[s] + nc;
+      for (int r=0; r<nrhs; ++r) {
+        for (int i=0; i<m; ++i) z[i+r*m] = y[ri[i]+r*n_];
+      }
+      dgemm_(&trans, &notrans, &nc, &nrhs, &m, &minus_one, F+nc, &nr, z, &m, &one, y+f, &n_);
+    }
+
+    // Undo the permutation
+    for (int r=0; r<nrhs; ++r) {
+      for (int i=0; i<n_; ++i) x[perm_[i]+r*n_] = y[i+r*n_];
+    }
+  }
+
+  void SupernodalLdl::solve(double* x, int nrhs, bool transpose) {
+    double time_start=0;
+    if (CasadiOptions::profiling&& CasadiOptions::profilingBinary) {
+      time_start = getRealTime(); // Start timer
+      profileWriteEntry(CasadiOptions::profilingLog, this);
+    }
+
+    // The matrix is symmetric, so transpose is ignored
+    casadi_assert(prepared_);
+    bool refine = nperturbed_>0 && max_refinement_>0;
+    if (refine) refine_.assign(x, x+n_*nrhs);
+    solveFactored(x, nrhs);
+
+    // Iterative refinement with the unperturbed matrix
+    if (refine) {
+      const vector<int>& colind = input(LINSOL_A).colind();
+      const vector<int>& row = input(LINSOL_A).row();
+      vector<double> r(n_*nrhs), dx;
+      double rnorm_last = numeric_limits<double>::infinity();
+      for (int iter=0; iter<=max_refinement_; ++iter) {
+        // r = b - A.x
+        copy(refine_.begin(), refine_.end(), r.begin());
+        for (int k=0; k<nrhs; ++k) {
+          for (int j=0; j<n_; ++j) {
+            for (int el=colind[j]; el<colind[j+1]; ++el) {
+              r[row[el]+k*n_] -= a_[el]*x[j+k*n_];
+            }
+          }
+        }
+        double rnorm = 0;
+        for (int i=0; i<r.size(); ++i) rnorm = std::max(rnorm, fabs(r[i]));
+
+        // Undo the last correction if it did not decrease the residual
+        if (rnorm>=rnorm_last) {
+          for (int i=0; i<dx.size(); ++i) x[i] -= dx[i];
+          break;
+        }
+        if (rnorm==0 || iter==max_refinement_) break;
+        rnorm_last = rnorm;
+
+        // x += A^{-1}.r
+        dx = r;
+        solveFactored(getPtr(dx), nrhs);
+        for (int i=0; i<dx.size(); ++i) x[i] += dx[i];
+      }
+    }
+
+    if (CasadiOptions::profiling && CasadiOptions::profilingBinary) {
+      double time_stop = getRealTime(); // Stop timer
+      profileWriteTime(CasadiOptions::profilingLog, this, 1,
+                       time_stop-time_start,
+                       time_stop-time_start);
+      profileWriteExit(CasadiOptions::profilingLog, this, time_stop-time_start);
+    }
+  }
+
+  std::vector<int> SupernodalLdl::getInertia() const {
+    casadi_assert_message(prepared_, "SupernodalLdl::getInertia: matrix not factorized");
+    vector<int> ret(3);
+    ret[0] = npos_;
+    ret[1] = nneg_;
+    ret[2] = nzero_;
+    return ret;
+  }
+
+  SupernodalLdl* SupernodalLdl::clone() const {
+    return new SupernodalLdl(*this);
+  }
+
+} // namespace casadi
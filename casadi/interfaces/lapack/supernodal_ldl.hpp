@@ -0,0 +1,175 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_SUPERNODAL_LDL_HPP
+#define CASADI_SUPERNODAL_LDL_HPP
+
+#include "casadi/core/function/linear_solver_internal.hpp"
+#include <casadi/interfaces/lapack/casadi_linearsolver_supernodal_export.h>
+
+namespace casadi {
+
+/** \defgroup plugin_LinearSolver_supernodal
+*
+   * This class solves the linear system <tt>A.x=b</tt> for a symmetric, possibly indefinite,
+   * sparse matrix A by making a supernodal factorization <tt>P'.A.P = L.D.L'</tt>. \n
+   * The symbolic analysis (approximate minimum degree ordering, elimination tree,
+   * supernode partition and the nonzero pattern of L) is done once in init. The numeric
+   * factorization treats each supernode as a dense block whose diagonal block is factorized
+   * with Bunch-Kaufman pivoting. Pivoting is restricted to the supernode, so pivots
+   * that would have to be delayed to an ancestor are perturbed instead, and the solution is
+   * then improved by iterative refinement. Updates to the ancestors of a supernode and the
+   * triangular solves are done with BLAS level 3 (dgemm, dtrsm). The inertia of A is
+   * available after the factorization, perturbed pivots are counted as zero eigenvalues.
+*/
+
+/** \pluginsection{LinearSolver,supernodal} */
+
+/// \cond INTERNAL
+
+  /// Triangular solve with multiple right hand sides (blas)
+  extern "C" void dtrsm_(char* side, char* uplo, char* transa, char* diag, int* m, int* n,
+                         double* alpha, double* a, int* lda, double* b, int* ldb);
+
+  /// General matrix-matrix product (blas)
+  extern "C" void dgemm_(char* transa, char* transb, int* m, int* n, int* k, double* alpha,
+                         double* a, int* lda, double* b, int* ldb, double* beta,
+                         double* c, int* ldc);
+
+  /** \brief \pluginbrief{LinearSolver,supernodal}
+   *
+   * @copydoc LinearSolver_doc
+   * @copydoc plugin_LinearSolver_supernodal
+   *
+   */
+  class CASADI_LINEARSOLVER_SUPERNODAL_EXPORT SupernodalLdl : public LinearSolverInternal {
+  public:
+    // Create a linear solver given a sparsity pattern and a number of right hand sides
+    SupernodalLdl(const Sparsity& sparsity, int nrhs);
+
+    /** \brief  Create a new LinearSolver */
+    static LinearSolverInternal* creator(const Sparsity& sp, int nrhs)
+    { return new SupernodalLdl(sp, nrhs);}
+
+    /// Clone
+    virtual SupernodalLdl* clone() const;
+
+    /// Destructor
+    virtual ~SupernodalLdl();
+
+    /// Initialize the solver: symbolic analysis
+    virtual void init();
+
+    /// Numeric factorization
+    virtual void prepare();
+
+    /// Solve the system of equations
+    virtual void solve(double* x, int nrhs, bool transpose);
+
+    /// Number of positive, negative and zero eigenvalues
+    virtual std::vector<int> getInertia() const;
+
+    /// Factorize the diagonal block of a supernode, perturbing pivots smaller than delta
+    void factorizeBlock(int s, double delta);
+
+    /// Solve with the factorized diagonal block of a supernode
+    void solveBlock(int s, double* B, int ldb, int nrhs);
+
+    /// Solve with the factorization, without refinement
+    void solveFactored(double* x, int nrhs);
+
+    /// A documentation string
+    static const std::string meta_doc;
+
+  protected:
+
+    /// Dimension
+    int n_;
+
+    /// Fill-reducing, postordered permutation: row/column k of P'.A.P is perm_[k] of A
+    std::vector<int> perm_;
+
+    /// First column of each supernode (size nsuper+1)
+    std::vector<int> super_;
+
+    /// Offsets into rows_ for each supernode (size nsuper+1)
+    std::vector<int> rows_ptr_;
+
+    /** \brief Row indices of each supernode, in the permuted numbering
+     * The first entries are the columns of the supernode itself, followed by the
+     * rows below the diagonal block in increasing order.
+     */
+    std::vector<int> rows_;
+
+    /// Supernode containing each column
+    std::vector<int> col2super_;
+
+    /// Offsets into val_ for each supernode (size nsuper+1)
+    std::vector<int> val_ptr_;
+
+    /** \brief Dense, column major block of each supernode
+     * After the factorization, the diagonal block holds the unit lower triangular factor and
+     * the diagonal of D of the pivoted block, the rows below it hold the off-diagonal block
+     * of the block unit lower triangular factor.
+     */
+    std::vector<double> val_;
+
+    /// Position in val_ of each nonzero of A, -1 for the upper triangular part
+    std::vector<int> amap_;
+
+    /// Pivot type per column: 1 for a 1-by-1 pivot, 2 and 0 for the columns of a 2-by-2 pivot
+    std::vector<int> ipiv_;
+
+    /// Pivoting permutation within each supernode, per column
+    std::vector<int> lperm_;
+
+    /// Off-diagonal entry of the 2-by-2 pivots, per column
+    std::vector<double> dsub_;
+
+    /// Nonzeros of A, kept for iterative refinement
+    std::vector<double> a_;
+
+    /// Work vectors
+    std::vector<double> work_, tmp_, update_, rhs_, blk_, refine_;
+
+    /// Map from a row index to its position within a supernode
+    std::vector<int> relpos_;
+
+    /// Inertia of the last factorization, perturbed pivots are counted as zero
+    int npos_, nneg_, nzero_;
+
+    /// Number of perturbed pivots in the last factorization
+    int nperturbed_;
+
+    /// Options
+    double pivot_perturbation_;
+    int max_refinement_;
+  };
+
+/// \endcond
+
+} // namespace casadi
+
+#endif // CASADI_SUPERNODAL_LDL_HPP
@@ -0,0 +1,62 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+      #include "supernodal_ldl.hpp"
+      #include <string>
+
+      const std::string casadi::SupernodalLdl::meta_doc=
+      "\n"
+"This class solves the linear system A.x=b for a symmetric, possibly\n"
+"indefinite, sparse matrix A by making a supernodal factorization\n"
+"P'.A.P = L.D.L'.\n"
+"\n"
+"\n"
+">List of available options\n"
+"\n"
+"+--------------------+------------+---------+------------------------------------+\n"
+"| Id                 | Type       | Default | Description                        |\n"
+"+====================+============+=========+====================================+\n"
+"| max_refinement     | OT_INTEGER | 5       | Maximum number of iterative        |\n"
+"|                    |            |         | refinement steps, only done if     |\n"
+"|                    |            |         | pivots were perturbed              |\n"
+"+--------------------+------------+---------+------------------------------------+\n"
+"| ordering           | OT_STRING  | \"amd\"   | Fill-reducing ordering: amd        |\n"
+"|                    |            |         | (approximate minimum degree on A)  |\n"
+"|                    |            |         | or natural (amd|natural)           |\n"
+"+--------------------+------------+---------+------------------------------------+\n"
+"| pivot_perturbation | OT_REAL    | 1e-08   | Pivots that cannot be chosen       |\n"
+"|                    |            |         | within a supernode with a          |\n"
+"|                    |            |         | magnitude above pivot_perturbation |\n"
+"|                    |            |         | times max(1, largest entry of A)   |\n"
+"|                    |            |         | are replaced by plus or minus this |\n"
+"|                    |            |         | threshold and counted as zero      |\n"
+"|                    |            |         | eigenvalues in the inertia         |\n"
+"+--------------------+------------+---------+------------------------------------+\n"
+"\n"
+"\n"
+"\n"
+"\n"
+;
@@ -64,6 +64,9 @@ namespace casadi {
     addOption("CPUtime",                OT_REAL,        GenericType(),
               "The maximum allowed CPU time in seconds for the whole initialisation"
               " (and the actually required one on output). Disabled if unset.");
+    addOption("sparse",                 OT_BOOLEAN,     false,
+              "Pass H and A to qpOASES as sparse matrices instead of densifying them. "
+              "Only the nonzeros are copied before each solve.");
 
     // Temporary object
     qpOASES::Options ops;
@@ -137,10 +140,14 @@ namespace casadi {
 
     called_once_ = false;
     qp_ = 0;
+    h_ = 0;
+    a_ = 0;
   }
 
   QpoasesInterface::~QpoasesInterface() {
     if (qp_!=0) delete qp_;
+    if (h_!=0) delete h_;
+    if (a_!=0) delete a_;
   }
 
   void QpoasesInterface::init() {
@@ -161,17 +168,53 @@ namespace casadi {
       max_cputime_ = -1;
     }
 
-    // Create data for H if not dense
-    if (!input(QP_SOLVER_H).sparsity().isDense()) h_data_.resize(n_*n_);
+    // Free the instance before the matrices it refers to
+    if (qp_) delete qp_;
+    qp_ = 0;
+    if (h_) delete h_;
+    h_ = 0;
+    if (a_) delete a_;
+    a_ = 0;
+    h_data_.clear();
+    a_data_.clear();
+
+    sparse_ = getOption("sparse");
+    if (sparse_) {
+      // Sparse H, qpOASES needs the index of the diagonal in each column
+      const Sparsity& h_sp = input(QP_SOLVER_H).sparsity();
+      h_colind_ = h_sp.colind();
+      h_row_ = h_sp.row();
+      h_val_.resize(h_sp.size());
+      h_diag_.resize(n_);
+      for (int cc=0; cc<n_; ++cc) {
+        int el = h_colind_[cc];
+        while (el<h_colind_[cc+1] && h_row_[el]<cc) el++;
+        h_diag_[cc] = el;
+      }
+      h_ = new qpOASES::SymSparseMat(n_, n_, getPtr(h_row_), getPtr(h_colind_),
+                                     getPtr(h_val_), getPtr(h_diag_));
+
+      // Sparse A, compressed column format as in CasADi
+      if (nc_>0) {
+        const Sparsity& a_sp = input(QP_SOLVER_A).sparsity();
+        a_colind_ = a_sp.colind();
+        a_row_ = a_sp.row();
+        a_val_.resize(a_sp.size());
+        a_ = new qpOASES::SparseMatrix(nc_, n_, getPtr(a_row_), getPtr(a_colind_),
+                                       getPtr(a_val_));
+      }
+    } else {
+      // Create data for H if not dense
+      if (!input(QP_SOLVER_H).sparsity().isDense()) h_data_.resize(n_*n_);
 
-    // Create data for A
-    a_data_.resize(n_*nc_);
+      // Create data for A
+      a_data_.resize(n_*nc_);
+    }
 
     // Dual solution vector
     dual_.resize(n_+nc_);
 
     // Create qpOASES instance
-    if (qp_) delete qp_;
     if (ALLOW_QPROBLEMB && nc_==0) {
       qp_ = new qpOASES::QProblemB(n_);
     } else {
@@ -232,9 +275,17 @@ namespace casadi {
       cout << "UBA = " << input(QP_SOLVER_UBA) << endl;
     }
 
+    // Refresh the nonzeros of the sparse matrices
+    if (sparse_) {
+      input(QP_SOLVER_H).get(h_val_);
+      if (nc_>0) input(QP_SOLVER_A).get(a_val_);
+    }
+
     // Get pointer to H
     const double* h=0;
-    if (h_data_.empty()) {
+    if (sparse_) {
+      // Passed as a matrix object
+    } else if (h_data_.empty()) {
       // No copying needed
       h = getPtr(input(QP_SOLVER_H));
     } else {
@@ -245,7 +296,7 @@ namespace casadi {
 
     // Copy A to a row-major dense vector
     const double* a=0;
-    if (nc_>0) {
+    if (nc_>0 && !sparse_) {
       input(QP_SOLVER_A).get(a_data_, DENSETRANS);
       a = getPtr(a_data_);
     }
@@ -263,7 +314,19 @@ namespace casadi {
     const double* ubA = getPtr(input(QP_SOLVER_UBA));
 
     int flag;
-    if (!called_once_) {
+    if (sparse_) {
+      if (ALLOW_QPROBLEMB && nc_==0) {
+        if (called_once_) static_cast<qpOASES::QProblemB*>(qp_)->reset();
+        flag = static_cast<qpOASES::QProblemB*>(qp_)->init(h_, g, lb, ub, nWSR, cputime_ptr);
+      } else if (!called_once_) {
+        flag = static_cast<qpOASES::SQProblem*>(qp_)->init(h_, g, a_, lb, ub, lbA, ubA,
+                                                           nWSR, cputime_ptr);
+      } else {
+        flag = static_cast<qpOASES::SQProblem*>(qp_)->hotstart(h_, g, a_, lb, ub, lbA, ubA,
+                                                               nWSR, cputime_ptr);
+      }
+      called_once_ = true;
+    } else if (!called_once_) {
       if (ALLOW_QPROBLEMB && nc_==0) {
         flag = static_cast<qpOASES::QProblemB*>(qp_)->init(h, g, lb, ub, nWSR, cputime_ptr);
       } else {
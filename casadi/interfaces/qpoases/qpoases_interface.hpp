@@ -108,6 +108,20 @@ public:
     std::vector<double> h_data_;
     std::vector<double> a_data_;
 
+    /// Pass H and A to qpOASES as sparse matrices
+    bool sparse_;
+
+    /// Sparse H and A, referring to the vectors below
+    qpOASES::SymSparseMat *h_;
+    qpOASES::SparseMatrix *a_;
+
+    /// Column offsets, row indices and nonzeros of H and A in compressed column format
+    std::vector<int> h_colind_, h_row_, a_colind_, a_row_;
+    std::vector<double> h_val_, a_val_;
+
+    /// First nonzero on or below the diagonal in each column of H
+    std::vector<int> h_diag_;
+
     /// Temporary vector holding the dual solution
     std::vector<double> dual_;
 
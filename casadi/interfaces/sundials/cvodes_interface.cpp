@@ -118,6 +118,23 @@ namespace casadi {
     monitor_rhsB_  = monitored("resB");
     monitor_rhs_   = monitored("res");
     monitor_rhsQB_ = monitored("resQB");
+    timing_ = gather_stats_ || getOption("print_stats");
+
+    // Memory for evaluating the DAE functions without copying to their inputs and outputs
+    f_mem_ = f_.allocMemory();
+    f_arg_.assign(f_.getNumInputs(), 0);
+    f_res_.assign(f_.getNumOutputs(), 0);
+    if (!g_.isNull()) {
+      g_mem_ = g_.allocMemory();
+      g_arg_.assign(g_.getNumInputs(), 0);
+      g_res_.assign(g_.getNumOutputs(), 0);
+    }
+    if (!jac_.isNull()) {
+      jac_mem_ = jac_.allocMemory();
+      jac_arg_.assign(jac_.getNumInputs(), 0);
+      jac_res_.assign(jac_.getNumOutputs(), 0);
+      jac_nz_.resize(jac_.output().size());
+    }
 
     // Sundials return flag
     int flag;
@@ -174,6 +191,9 @@ namespace casadi {
     case SD_USER_DEFINED:
       initUserDefinedLinearSolver();
       break;
+    case SD_SPARSE:
+      initSparseLinearSolver();
+      break;
     }
 
     // Set user data
@@ -348,6 +368,7 @@ namespace casadi {
       initIterativeLinearSolverB();
       break;
     case SD_USER_DEFINED:
+    case SD_SPARSE:
       initUserDefinedLinearSolverB();
       break;
     }
@@ -369,38 +390,64 @@ namespace casadi {
     isInitAdj_ = true;
   }
 
+  void CvodesInterface::evalF(double t, const double* x, double* ode, double* quad) {
+    f_arg_[DAE_T] = &t;
+    f_arg_[DAE_X] = x;
+    f_arg_[DAE_P] = input(INTEGRATOR_P).ptr();
+    f_res_[DAE_ODE] = ode;
+    f_res_[DAE_QUAD] = quad;
+    f_.evaluate(getPtr(f_arg_), getPtr(f_res_), f_mem_);
+  }
+
+  void CvodesInterface::evalG(double t, const double* x, const double* rx, double* rode,
+                              double* rquad) {
+    g_arg_[RDAE_T] = &t;
+    g_arg_[RDAE_X] = x;
+    g_arg_[RDAE_P] = input(INTEGRATOR_P).ptr();
+    g_arg_[RDAE_RX] = rx;
+    g_arg_[RDAE_RP] = input(INTEGRATOR_RP).ptr();
+    g_res_[RDAE_ODE] = rode;
+    g_res_[RDAE_QUAD] = rquad;
+    g_.evaluate(getPtr(g_arg_), getPtr(g_res_), g_mem_);
+  }
+
+  void CvodesInterface::evalJac(double t, const double* x, double c_x, double c_xdot,
+                                double* jac) {
+    jac_arg_[DAE_T] = &t;
+    jac_arg_[DAE_X] = x;
+    jac_arg_[DAE_P] = input(INTEGRATOR_P).ptr();
+    jac_arg_[DAE_NUM_IN] = &c_x;
+    jac_arg_[DAE_NUM_IN+1] = &c_xdot;
+    jac_res_[0] = jac;
+    jac_.evaluate(getPtr(jac_arg_), getPtr(jac_res_), jac_mem_);
+  }
+
   void CvodesInterface::rhs(double t, const double* x, double* xdot) {
-    log("CvodesInterface::rhs", "begin");
+    casadi_log("CvodesInterface::rhs begin");
 
     // Get time
-    time1 = clock();
-
-    // Pass input
-    f_.setInput(&t, DAE_T);
-    f_.setInput(x, DAE_X);
-    f_.setInput(input(INTEGRATOR_P), DAE_P);
+    if (timing_) time1 = clock();
 
     if (monitor_rhs_) {
       cout << "t       = " << t << endl;
-      cout << "x       = " << f_.input(DAE_X) << endl;
-      cout << "p       = " << f_.input(DAE_P) << endl;
+      cout << "x       = " << vector<double>(x, x+nx_) << endl;
+      cout << "p       = " << input(INTEGRATOR_P) << endl;
     }
+
     // Evaluate
-    f_.evaluate();
+    evalF(t, x, xdot, 0);
 
     if (monitor_rhs_) {
-      cout << "xdot       = " << f_.output(DAE_ODE)<< endl;
+      cout << "xdot       = " << vector<double>(xdot, xdot+nx_) << endl;
     }
 
-    // Get results
-    f_.getOutput(xdot);
-
     // Log time
-    time2 = clock();
-    t_res += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
-
-    log("CvodesInterface::rhs", "end");
+    if (timing_) {
+      time2 = clock();
+      t_res += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    }
 
+    casadi_log("CvodesInterface::rhs end");
   }
 
   int CvodesInterface::rhs_wrapper(double t, N_Vector x, N_Vector xdot, void *user_data) {
@@ -516,7 +563,7 @@ namespace casadi {
 
 
     // Print statistics
-    if (getOption("print_stats")) printStats(std::cout);
+    if (print_stats_) printStats(std::cout);
 
     if (gather_stats_) {
       long nsteps, nfevals, nlinsetups, netfails;
@@ -527,6 +574,7 @@ namespace casadi {
       if (flag!=CV_SUCCESS) cvodes_error("CVodeGetIntegratorStats", flag);
 
       stats_["nsteps"] = 1.0*nsteps;
+      stats_["nfevals"] = 1.0*nfevals;
       stats_["nlinsetups"] = 1.0*nlinsetups;
 
     }
@@ -737,7 +785,7 @@ namespace casadi {
     //    casadi_assert(Ns==nfdir_);
 
     // Record the current cpu time
-    time1 = clock();
+    if (timing_) time1 = clock();
 
     // Commented out since a new implementation currently cannot be tested
     casadi_error("Commented out, #884, #794.");
@@ -766,8 +814,10 @@ namespace casadi {
     //  }
 
     // Record timings
-    time2 = clock();
-    t_fres += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    if (timing_) {
+      time2 = clock();
+      t_fres += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    }
   }
 
   int CvodesInterface::rhsS_wrapper(int Ns, double t, N_Vector x, N_Vector xdot, N_Vector *xF,
@@ -834,16 +884,7 @@ namespace casadi {
   }
 
   void CvodesInterface::rhsQ(double t, const double* x, double* qdot) {
-    // Pass input
-    f_.setInput(&t, DAE_T);
-    f_.setInput(x, DAE_X);
-    f_.setInput(input(INTEGRATOR_P), DAE_P);
-
-    // Evaluate
-    f_.evaluate();
-
-    // Get results
-    f_.getOutput(qdot, DAE_QUAD);
+    evalF(t, x, 0, qdot);
   }
 
   void CvodesInterface::rhsQS(int Ns, double t, N_Vector x, N_Vector *xF, N_Vector qdot,
@@ -892,38 +933,28 @@ namespace casadi {
   }
 
   void CvodesInterface::rhsB(double t, const double* x, const double *rx, double* rxdot) {
-    log("CvodesInterface::rhsB", "begin");
-
-    // Pass inputs
-    g_.setInput(&t, RDAE_T);
-    g_.setInput(x, RDAE_X);
-    g_.setInput(input(INTEGRATOR_P), RDAE_P);
-    g_.setInput(input(INTEGRATOR_RP), RDAE_RP);
-    g_.setInput(rx, RDAE_RX);
+    casadi_log("CvodesInterface::rhsB begin");
 
     if (monitor_rhsB_) {
       cout << "t       = " << t << endl;
-      cout << "x       = " << g_.input(RDAE_X) << endl;
-      cout << "p       = " << g_.input(RDAE_P) << endl;
-      cout << "rx      = " << g_.input(RDAE_RX) << endl;
-      cout << "rp      = " << g_.input(RDAE_RP) << endl;
+      cout << "x       = " << vector<double>(x, x+nx_) << endl;
+      cout << "p       = " << input(INTEGRATOR_P) << endl;
+      cout << "rx      = " << vector<double>(rx, rx+nrx_) << endl;
+      cout << "rp      = " << input(INTEGRATOR_RP) << endl;
     }
 
     // Evaluate
-    g_.evaluate();
-
-    // Save to output
-    g_.getOutput(rxdot, RDAE_ODE);
+    evalG(t, x, rx, rxdot, 0);
 
     if (monitor_rhsB_) {
-      cout << "xdotB = " << g_.output(RDAE_ODE) << endl;
+      cout << "xdotB = " << vector<double>(rxdot, rxdot+nrx_) << endl;
     }
 
     // Negate (note definition of g)
     for (int i=0; i<nrx_; ++i)
       rxdot[i] *= -1;
 
-    log("CvodesInterface::rhsB", "end");
+    casadi_log("CvodesInterface::rhsB end");
   }
 
   void CvodesInterface::rhsBS(double t, N_Vector x, N_Vector *xF, N_Vector rx, N_Vector rxdot) {
@@ -1011,29 +1042,19 @@ namespace casadi {
       cout << "CvodesInterface::rhsQB: begin" << endl;
     }
 
-    // Pass inputs
-    g_.setInput(&t, RDAE_T);
-    g_.setInput(x, RDAE_X);
-    g_.setInput(input(INTEGRATOR_P), RDAE_P);
-    g_.setInput(input(INTEGRATOR_RP), RDAE_RP);
-    g_.setInput(rx, RDAE_RX);
-
     if (monitor_rhsB_) {
       cout << "t       = " << t << endl;
-      cout << "x       = " << g_.input(RDAE_X) << endl;
-      cout << "p       = " << g_.input(RDAE_P) << endl;
-      cout << "rx      = " << g_.input(RDAE_RX) << endl;
-      cout << "rp      = " << g_.input(RDAE_RP) << endl;
+      cout << "x       = " << vector<double>(x, x+nx_) << endl;
+      cout << "p       = " << input(INTEGRATOR_P) << endl;
+      cout << "rx      = " << vector<double>(rx, rx+nrx_) << endl;
+      cout << "rp      = " << input(INTEGRATOR_RP) << endl;
     }
 
     // Evaluate
-    g_.evaluate();
-
-    // Save to output
-    g_.getOutput(rqdot, RDAE_QUAD);
+    evalG(t, x, rx, 0, rqdot);
 
     if (monitor_rhsB_) {
-      cout << "qdotB = " << g_.output(RDAE_QUAD) << endl;
+      cout << "qdotB = " << vector<double>(rqdot, rqdot+nrq_) << endl;
     }
 
     // Negate (note definition of g)
@@ -1074,9 +1095,9 @@ namespace casadi {
 
   void CvodesInterface::jtimes(N_Vector v, N_Vector Jv, double t, N_Vector x,
                               N_Vector xdot, N_Vector tmp) {
-    log("CvodesInterface::jtimes", "begin");
+    casadi_log("CvodesInterface::jtimes begin");
     // Get time
-    time1 = clock();
+    if (timing_) time1 = clock();
 
     // Pass input
     f_fwd_.setInput(&t,                 DAE_T);
@@ -1095,17 +1116,19 @@ namespace casadi {
     f_fwd_.getOutput(NV_DATA_S(Jv), DAE_NUM_OUT + DAE_ODE);
 
     // Log time duration
-    time2 = clock();
-    t_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    if (timing_) {
+      time2 = clock();
+      t_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    }
 
-    log("CvodesInterface::jtimes", "end");
+    casadi_log("CvodesInterface::jtimes end");
   }
 
   void CvodesInterface::jtimesB(N_Vector vB, N_Vector JvB, double t, N_Vector x, N_Vector xB,
                                N_Vector xdotB, N_Vector tmpB) {
-    log("CvodesInterface::jtimesB", "begin");
+    casadi_log("CvodesInterface::jtimesB begin");
     // Get time
-    time1 = clock();
+    if (timing_) time1 = clock();
 
     // Pass input
     g_fwd_.setInput(&t,                  RDAE_T);
@@ -1128,9 +1151,11 @@ namespace casadi {
     g_fwd_.getOutput(NV_DATA_S(JvB), RDAE_NUM_OUT + RDAE_ODE);
 
     // Log time duration
-    time2 = clock();
-    t_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
-    log("CvodesInterface::jtimesB", "end");
+    if (timing_) {
+      time2 = clock();
+      t_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    }
+    casadi_log("CvodesInterface::jtimesB end");
   }
 
   int CvodesInterface::djac_wrapper(long N, double t, N_Vector x, N_Vector xdot, DlsMat Jac,
@@ -1162,38 +1187,28 @@ namespace casadi {
 
   void CvodesInterface::djac(long N, double t, N_Vector x, N_Vector xdot, DlsMat Jac,
                             N_Vector tmp1, N_Vector tmp2, N_Vector tmp3) {
-    log("CvodesInterface::djac", "begin");
+    casadi_log("CvodesInterface::djac begin");
 
     // Get time
-    time1 = clock();
-
-    // Pass inputs to the jacobian function
-    jac_.setInput(&t, DAE_T);
-    jac_.setInput(NV_DATA_S(x), DAE_X);
-    jac_.setInput(f_.input(DAE_P), DAE_P);
-    jac_.setInput(1.0, DAE_NUM_IN);
-    jac_.setInput(0.0, DAE_NUM_IN+1);
-
+    if (timing_) time1 = clock();
 
     if (monitored("djac")) {
       cout << "DAE_T    = " << t << endl;
-      cout << "DAE_X    = " << jac_.input(DAE_X) << endl;
-      cout << "RDAE_P    = " << jac_.input(DAE_P) << endl;
-      cout << "c_x = " << jac_.input(DAE_NUM_IN) << endl;
-      cout << "c_xdot = " << jac_.input(DAE_NUM_IN+1) << endl;
+      cout << "DAE_X    = " << vector<double>(NV_DATA_S(x), NV_DATA_S(x)+nx_) << endl;
+      cout << "RDAE_P    = " << input(INTEGRATOR_P) << endl;
     }
 
     // Evaluate
-    jac_.evaluate();
+    evalJac(t, NV_DATA_S(x), 1.0, 0.0, getPtr(jac_nz_));
 
     if (monitored("djac")) {
-      cout << "jac = " << jac_.output() << endl;
+      cout << "jac = " << jac_nz_ << endl;
     }
 
     // Get sparsity and non-zero elements
     const vector<int>& colind = jac_.output().colind();
     const vector<int>& row = jac_.output().row();
-    const vector<double>& val = jac_.output().data();
+    const vector<double>& val = jac_nz_;
 
     // Loop over columns
     for (int cc=0; cc<colind.size()-1; ++cc) {
@@ -1208,17 +1223,19 @@ namespace casadi {
     }
 
     // Log time duration
-    time2 = clock();
-    t_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    if (timing_) {
+      time2 = clock();
+      t_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    }
 
-    log("CvodesInterface::djac", "end");
+    casadi_log("CvodesInterface::djac end");
   }
 
   void CvodesInterface::djacB(long NeqB, double t, N_Vector x, N_Vector xB, N_Vector xdotB,
                              DlsMat JacB, N_Vector tmp1B, N_Vector tmp2B, N_Vector tmp3B) {
-    log("CvodesInterface::djacB", "begin");
+    casadi_log("CvodesInterface::djacB begin");
     // Get time
-    time1 = clock();
+    if (timing_) time1 = clock();
 
     // Pass inputs to the jacobian function
     jacB_.setInput(&t, RDAE_T);
@@ -1265,9 +1282,11 @@ namespace casadi {
     }
 
     // Log time duration
-    time2 = clock();
-    t_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
-    log("CvodesInterface::djacB", "end");
+    if (timing_) {
+      time2 = clock();
+      t_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    }
+    casadi_log("CvodesInterface::djacB end");
   }
 
   int CvodesInterface::bjac_wrapper(long N, long mupper, long mlower, double t, N_Vector x,
@@ -1300,25 +1319,18 @@ namespace casadi {
 
   void CvodesInterface::bjac(long N, long mupper, long mlower, double t, N_Vector x, N_Vector xdot,
                             DlsMat Jac, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3) {
-    log("CvodesInterface::bjac", "begin");
+    casadi_log("CvodesInterface::bjac begin");
 
     // Get time
-    time1 = clock();
-
-    // Pass inputs to the jacobian function
-    jac_.setInput(&t, DAE_T);
-    jac_.setInput(NV_DATA_S(x), DAE_X);
-    jac_.setInput(f_.input(DAE_P), DAE_P);
-    jac_.setInput(1.0, DAE_NUM_IN);
-    jac_.setInput(0.0, DAE_NUM_IN+1);
+    if (timing_) time1 = clock();
 
     // Evaluate
-    jac_.evaluate();
+    evalJac(t, NV_DATA_S(x), 1.0, 0.0, getPtr(jac_nz_));
 
     // Get sparsity and non-zero elements
     const vector<int>& colind = jac_.output().colind();
     const vector<int>& row = jac_.output().row();
-    const vector<double>& val = jac_.output().data();
+    const vector<double>& val = jac_nz_;
 
     // Loop over cols
     for (int cc=0; cc<colind.size()-1; ++cc) {
@@ -1334,19 +1346,21 @@ namespace casadi {
     }
 
     // Log time duration
-    time2 = clock();
-    t_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    if (timing_) {
+      time2 = clock();
+      t_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    }
 
-    log("CvodesInterface::bjac", "end");
+    casadi_log("CvodesInterface::bjac end");
   }
 
   void CvodesInterface::bjacB(long NeqB, long mupperB, long mlowerB, double t, N_Vector x,
                              N_Vector xB, N_Vector xdotB, DlsMat JacB, N_Vector tmp1B,
                              N_Vector tmp2B, N_Vector tmp3B) {
-    log("CvodesInterface::bjacB", "begin");
+    casadi_log("CvodesInterface::bjacB begin");
 
     // Get time
-    time1 = clock();
+    if (timing_) time1 = clock();
 
     // Pass inputs to the jacobian function
     jacB_.setInput(&t, RDAE_T);
@@ -1393,10 +1407,12 @@ namespace casadi {
     }
 
     // Log time duration
-    time2 = clock();
-    t_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    if (timing_) {
+      time2 = clock();
+      t_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    }
 
-    log("CvodesInterface::bjacB", "end");
+    casadi_log("CvodesInterface::bjacB end");
   }
 
   void CvodesInterface::setStopTime(double tf) {
@@ -1465,7 +1481,7 @@ namespace casadi {
   void CvodesInterface::psolve(double t, N_Vector x, N_Vector xdot, N_Vector r, N_Vector z,
                               double gamma, double delta, int lr, N_Vector tmp) {
     // Get time
-    time1 = clock();
+    if (timing_) time1 = clock();
 
     // Copy input to output, if necessary
     if (r!=z) {
@@ -1477,15 +1493,17 @@ namespace casadi {
     linsol_.solve(NV_DATA_S(z), 1, false);
 
     // Log time duration
-    time2 = clock();
-    t_lsolve += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    if (timing_) {
+      time2 = clock();
+      t_lsolve += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    }
   }
 
   void CvodesInterface::psolveB(double t, N_Vector x, N_Vector xB, N_Vector xdotB, N_Vector rvecB,
                                N_Vector zvecB, double gammaB, double deltaB,
                                int lr, N_Vector tmpB) {
     // Get time
-    time1 = clock();
+    if (timing_) time1 = clock();
 
     // Copy input to output, if necessary
     if (rvecB!=zvecB) {
@@ -1497,51 +1515,47 @@ namespace casadi {
     linsolB_.solve(NV_DATA_S(zvecB), 1, false);
 
     // Log time duration
-    time2 = clock();
-    t_lsolve += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    if (timing_) {
+      time2 = clock();
+      t_lsolve += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    }
   }
 
   void CvodesInterface::psetup(double t, N_Vector x, N_Vector xdot, booleantype jok,
                               booleantype *jcurPtr, double gamma, N_Vector tmp1,
                               N_Vector tmp2, N_Vector tmp3) {
-    log("CvodesInterface::psetup", "begin");
+    casadi_log("CvodesInterface::psetup begin");
     // Get time
-    time1 = clock();
+    if (timing_) time1 = clock();
 
-    // Pass input to the jacobian function
-    jac_.setInput(&t, DAE_T);
-    jac_.setInput(NV_DATA_S(x), DAE_X);
-    jac_.setInput(input(INTEGRATOR_P), DAE_P);
-    jac_.setInput(-gamma, DAE_NUM_IN);
-    jac_.setInput(1.0, DAE_NUM_IN+1);
-
-    // Evaluate jacobian
-    jac_.evaluate();
+    // Evaluate jacobian, scaled by -gamma, directly into the linear solver
+    evalJac(t, NV_DATA_S(x), -gamma, 1.0, linsol_.input(LINSOL_A).ptr());
 
     // Log time duration
-    time2 = clock();
-    t_lsetup_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
-
-    // Pass non-zero elements, scaled by -gamma, to the linear solver
-    linsol_.setInput(jac_.output(), 0);
+    if (timing_) {
+      time2 = clock();
+      t_lsetup_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    }
 
     // Prepare the solution of the linear system (e.g. factorize)
     // -- only if the linear solver inherits from LinearSolver
     linsol_.prepare();
 
     // Log time duration
-    time1 = clock();
-    t_lsetup_fac += static_cast<double>(time1-time2)/CLOCKS_PER_SEC;
+    if (timing_) {
+      time1 = clock();
+      t_lsetup_fac += static_cast<double>(time1-time2)/CLOCKS_PER_SEC;
+    }
 
-    log("CvodesInterface::psetup", "end");
+    casadi_log("CvodesInterface::psetup end");
   }
 
   void CvodesInterface::psetupB(double t, N_Vector x, N_Vector xB, N_Vector xdotB,
                                booleantype jokB, booleantype *jcurPtrB, double gammaB,
                                N_Vector tmp1B, N_Vector tmp2B, N_Vector tmp3B) {
-    log("CvodesInterface::psetupB", "begin");
+    casadi_log("CvodesInterface::psetupB begin");
     // Get time
-    time1 = clock();
+    if (timing_) time1 = clock();
 
     // Pass inputs to the jacobian function
     jacB_.setInput(&t, RDAE_T);
@@ -1569,8 +1583,10 @@ namespace casadi {
     }
 
     // Log time duration
-    time2 = clock();
-    t_lsetup_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    if (timing_) {
+      time2 = clock();
+      t_lsetup_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    }
 
     // Pass non-zero elements, scaled by -gamma, to the linear solver
     linsolB_.setInput(jacB_.output(), 0);
@@ -1580,9 +1596,11 @@ namespace casadi {
     linsolB_.prepare();
 
     // Log time duration
-    time1 = clock();
-    t_lsetup_fac += static_cast<double>(time1-time2)/CLOCKS_PER_SEC;
-    log("CvodesInterface::psetupB", "end");
+    if (timing_) {
+      time1 = clock();
+      t_lsetup_fac += static_cast<double>(time1-time2)/CLOCKS_PER_SEC;
+    }
+    casadi_log("CvodesInterface::psetupB end");
   }
 
   void CvodesInterface::lsetup(CVodeMem cv_mem, int convfail, N_Vector x, N_Vector xdot,
@@ -1594,10 +1612,62 @@ namespace casadi {
     // Scaling factor before J
     double gamma = cv_mem->cv_gamma;
 
+    // Sparse direct solver
+    if (linsol_f_==SD_SPARSE) {
+      lsetupSparse(cv_mem, convfail, x, jcurPtr);
+      return;
+    }
+
     // Call the preconditioner setup function (which sets up the linear solver)
     psetup(t, x, xdot, FALSE, jcurPtr, gamma, vtemp1, vtemp2, vtemp3);
   }
 
+  void CvodesInterface::lsetupSparse(CVodeMem cv_mem, int convfail, N_Vector x,
+                                     booleantype *jcurPtr) {
+    casadi_log("CvodesInterface::lsetupSparse begin");
+
+    // Get time
+    if (timing_) time1 = clock();
+
+    // Current time and scaling factor before J
+    double t = cv_mem->cv_tn;
+    double gamma = cv_mem->cv_gamma;
+
+    // Reevaluate df/dx under the same conditions as the dense solver of CVODES: at the
+    // first step, after 50 steps, or when the Newton iteration failed with a stale Jacobian
+    bool jbad = cv_mem->cv_nst==0 || cv_mem->cv_nst > nstlj_ + 50
+      || convfail==CV_FAIL_OTHER
+      || (convfail==CV_FAIL_BAD_J && std::fabs(gamma/cv_mem->cv_gammap - 1) < 0.2);
+    if (jbad) {
+      // Evaluate df/dx
+      evalJac(t, NV_DATA_S(x), 1.0, 0.0, getPtr(jac_nz_));
+      nstlj_ = cv_mem->cv_nst;
+    }
+    *jcurPtr = jbad ? TRUE : FALSE;
+
+    // Log time duration
+    if (timing_) {
+      time2 = clock();
+      t_lsetup_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    }
+
+    // Form M = I - gamma*df/dx with the sparsity pattern of the Jacobian
+    std::vector<double>& m = linsol_.input(LINSOL_A).data();
+    for (int k=0; k<m.size(); ++k) m[k] = -gamma*jac_nz_[k];
+    for (int k=0; k<jac_diag_.size(); ++k) m[jac_diag_[k]] += 1;
+
+    // Numeric factorization, the symbolic one is kept by the linear solver
+    linsol_.prepare();
+
+    // Log time duration
+    if (timing_) {
+      time1 = clock();
+      t_lsetup_fac += static_cast<double>(time1-time2)/CLOCKS_PER_SEC;
+    }
+
+    casadi_log("CvodesInterface::lsetupSparse end");
+  }
+
   void CvodesInterface::lsetupB(double t, double gamma, int convfail,
                                N_Vector x, N_Vector xB, N_Vector xdotB, booleantype *jcurPtr,
                                N_Vector vtemp1, N_Vector vtemp2, N_Vector vtemp3) {
@@ -1653,7 +1723,7 @@ namespace casadi {
 
   void CvodesInterface::lsolve(CVodeMem cv_mem, N_Vector b, N_Vector weight,
                               N_Vector x, N_Vector xdot) {
-    log("CvodesInterface::lsolve", "begin");
+    casadi_log("CvodesInterface::lsolve begin");
 
     // Current time
     double t = cv_mem->cv_tn;
@@ -1670,12 +1740,17 @@ namespace casadi {
     // Call the preconditioner solve function (which solves the linear system)
     psolve(t, x, xdot, b, b, gamma, delta, lr, 0);
 
-    log("CvodesInterface::lsolve", "end");
+    // Scale the correction to account for change in gamma since the last setup
+    if (linsol_f_==SD_SPARSE && cv_mem->cv_lmm==CV_BDF && cv_mem->cv_gamrat!=1) {
+      N_VScale(2.0/(1.0 + cv_mem->cv_gamrat), b, b);
+    }
+
+    casadi_log("CvodesInterface::lsolve end");
   }
 
   void CvodesInterface::lsolveB(double t, double gamma, N_Vector b, N_Vector weight,
                                N_Vector x, N_Vector xB, N_Vector xdotB) {
-    log("CvodesInterface::lsolveB", "begin");
+    casadi_log("CvodesInterface::lsolveB begin");
     // Accuracy
     double delta = 0.0;
 
@@ -1685,7 +1760,7 @@ namespace casadi {
     // Call the preconditioner solve function (which solves the linear system)
     psolveB(t, x, xB, xdotB, b, b, gamma, delta, lr, 0);
 
-    log("CvodesInterface::lsolveB", "end");
+    casadi_log("CvodesInterface::lsolveB end");
   }
 
   int CvodesInterface::lsolve_wrapper(CVodeMem cv_mem, N_Vector b, N_Vector weight,
@@ -1900,6 +1975,28 @@ namespace casadi {
     cvB_mem->cv_mem->cv_setupNonNull = TRUE;
   }
 
+  void CvodesInterface::initSparseLinearSolver() {
+    casadi_assert(!jac_.isNull());
+    casadi_assert(!linsol_.isNull());
+
+    // Locate the diagonal entries of the Newton matrix, which are part of the pattern
+    const Sparsity& sp = jac_.output().sparsity();
+    const std::vector<int>& colind = sp.colind();
+    const std::vector<int>& row = sp.row();
+    jac_diag_.resize(nx_);
+    for (int c=0; c<nx_; ++c) {
+      jac_diag_[c] = -1;
+      for (int k=colind[c]; k<colind[c+1]; ++k) {
+        if (row[k]==c) jac_diag_[c] = k;
+      }
+      casadi_assert(jac_diag_[c]>=0);
+    }
+    nstlj_ = 0;
+
+    // Hook into the lsetup/lsolve functions of CVODES
+    initUserDefinedLinearSolver();
+  }
+
   void CvodesInterface::deepCopyMembers(std::map<SharedObjectNode*, SharedObject>& already_copied) {
     SundialsInterface::deepCopyMembers(already_copied);
   }
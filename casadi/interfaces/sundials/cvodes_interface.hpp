@@ -51,9 +51,11 @@
       you may experience a dramatic speed-up by using a sparse linear solver:
 
       \verbatim
-       intg.setOption("linear_solver","csparse")
-       intg.setOption("linear_solver_type","user_defined")
+       intg.setOption("linear_solver_type","sparse")
       \endverbatim
+
+      which factorizes the Newton matrix in compressed column format with
+      csparse, or with the LinearSolver plugin given by "linear_solver".
 */
 
 /** \pluginsection{Integrator,cvodes} */
@@ -135,6 +137,15 @@ namespace casadi {
 
   protected:
 
+    /// Evaluate the ODE right-hand side and/or quadratures, null results are not calculated
+    void evalF(double t, const double* x, double* ode, double* quad);
+
+    /// Evaluate the backward right-hand side and/or quadratures
+    void evalG(double t, const double* x, const double* rx, double* rode, double* rquad);
+
+    /// Evaluate the nonzeros of <tt>c_x*df/dx + c_xdot*I</tt>
+    void evalJac(double t, const double* x, double c_x, double c_xdot, double* jac);
+
     // Sundials callback functions
     void rhs(double t, const double* x, double* xdot);
     void ehfun(int error_code, const char *module, const char *function, char *msg);
@@ -177,6 +188,8 @@ namespace casadi {
     void lsetupB(double t, double gamma, int convfail, N_Vector x, N_Vector xB, N_Vector xdotB,
                  booleantype *jcurPtr,
                  N_Vector vtemp1, N_Vector vtemp2, N_Vector vtemp3);
+    /// <tt>M = I-gamma*df/dx</tt> in compressed column format, reusing df/dx if possible
+    void lsetupSparse(CVodeMem cv_mem, int convfail, N_Vector x, booleantype *jcurPtr);
     /// <tt>b = M^(-1).b</tt>
     void lsolve(CVodeMem cv_mem, N_Vector b, N_Vector weight, N_Vector ycur, N_Vector fcur);
     void lsolveB(double t, double gamma, N_Vector b, N_Vector weight, N_Vector x,
@@ -251,6 +264,12 @@ namespace casadi {
     double t_lsetup_jac; // preconditioner/linear solver setup function, generate Jacobian
     double t_lsetup_fac; // preconditioner setup function, factorize Jacobian
 
+    // Nonzeros of df/dx; for the sparse linear solver also the positions of the diagonal
+    // entries and the step at which df/dx was last evaluated
+    std::vector<double> jac_nz_;
+    std::vector<int> jac_diag_;
+    long nstlj_;
+
     // N-vectors for the forward integration
     N_Vector x0_, x_, q_;
 
@@ -288,6 +307,9 @@ namespace casadi {
     // Initialize the user defined linear solver
     void initUserDefinedLinearSolver();
 
+    // Initialize the sparse direct linear solver
+    void initSparseLinearSolver();
+
     // Initialize the dense linear solver (backward integration)
     void initDenseLinearSolverB();
 
@@ -307,6 +329,15 @@ namespace casadi {
     bool monitor_rhs_;
     bool monitor_rhsQB_;
 
+    // Time the callbacks, only if gather_stats or print_stats
+    bool timing_;
+
+    // Memory and argument/result pointers for evaluating f_, g_ and jac_ directly on the
+    // data of the Sundials vectors
+    FunctionMemory f_mem_, g_mem_, jac_mem_;
+    std::vector<const double*> f_arg_, g_arg_, jac_arg_;
+    std::vector<double*> f_res_, g_res_, jac_res_;
+
     bool disable_internal_warnings_;
 
   };
@@ -158,6 +158,26 @@ namespace casadi {
 
     // Read options
     cj_scaling_ = getOption("cj_scaling");
+    monitor_res_ = monitored("res");
+    monitor_resB_ = monitored("resB");
+    monitor_rhsQB_ = monitored("rhsQB");
+    timing_ = gather_stats_ || getOption("print_stats");
+
+    // Memory for evaluating the DAE functions without copying to their inputs and outputs
+    f_mem_ = f_.allocMemory();
+    f_arg_.assign(f_.getNumInputs(), 0);
+    f_res_.assign(f_.getNumOutputs(), 0);
+    if (!g_.isNull()) {
+      g_mem_ = g_.allocMemory();
+      g_arg_.assign(g_.getNumInputs(), 0);
+      g_res_.assign(g_.getNumOutputs(), 0);
+    }
+    if (!jac_.isNull()) {
+      jac_mem_ = jac_.allocMemory();
+      jac_arg_.assign(jac_.getNumInputs(), 0);
+      jac_res_.assign(jac_.getNumOutputs(), 0);
+      jac_nz_.resize(jac_.output().size());
+    }
     calc_ic_ = getOption("calc_ic");
     calc_icB_ = hasSetOption("calc_icB") ?  getOption("calc_icB") : getOption("calc_ic");
 
@@ -243,6 +263,7 @@ namespace casadi {
       initIterativeLinearSolver();
       break;
     case SD_USER_DEFINED:
+    case SD_SPARSE:
       initUserDefinedLinearSolver();
       break;
     default: casadi_error("Uncaught switch");
@@ -473,6 +494,7 @@ namespace casadi {
       initIterativeLinearSolverB();
       break;
     case SD_USER_DEFINED:
+    case SD_SPARSE:
       initUserDefinedLinearSolverB();
       break;
     default: casadi_error("Uncaught switch");
@@ -499,41 +521,68 @@ namespace casadi {
   }
 
 
+  void IdasInterface::evalF(double t, const double* xz, double* ode, double* alg,
+                            double* quad) {
+    f_arg_[DAE_T] = &t;
+    f_arg_[DAE_X] = xz;
+    f_arg_[DAE_Z] = xz+nx_;
+    f_arg_[DAE_P] = input(INTEGRATOR_P).ptr();
+    f_res_[DAE_ODE] = ode;
+    f_res_[DAE_ALG] = alg;
+    f_res_[DAE_QUAD] = quad;
+    f_.evaluate(getPtr(f_arg_), getPtr(f_res_), f_mem_);
+  }
+
+  void IdasInterface::evalG(double t, const double* xz, const double* rxz, double* rode,
+                            double* ralg, double* rquad) {
+    g_arg_[RDAE_T] = &t;
+    g_arg_[RDAE_X] = xz;
+    g_arg_[RDAE_Z] = xz+nx_;
+    g_arg_[RDAE_P] = input(INTEGRATOR_P).ptr();
+    g_arg_[RDAE_RX] = rxz;
+    g_arg_[RDAE_RZ] = rxz+nrx_;
+    g_arg_[RDAE_RP] = input(INTEGRATOR_RP).ptr();
+    g_res_[RDAE_ODE] = rode;
+    g_res_[RDAE_ALG] = ralg;
+    g_res_[RDAE_QUAD] = rquad;
+    g_.evaluate(getPtr(g_arg_), getPtr(g_res_), g_mem_);
+  }
+
+  void IdasInterface::evalJac(double t, const double* xz, double cj, double* jac) {
+    jac_arg_[DAE_T] = &t;
+    jac_arg_[DAE_X] = xz;
+    jac_arg_[DAE_Z] = xz+nx_;
+    jac_arg_[DAE_P] = input(INTEGRATOR_P).ptr();
+    jac_arg_[DAE_NUM_IN] = &cj;
+    jac_res_[0] = jac;
+    jac_.evaluate(getPtr(jac_arg_), getPtr(jac_res_), jac_mem_);
+  }
+
   void IdasInterface::res(double t, const double* xz, const double* xzdot, double* r) {
-    log("IdasInterface::res", "begin");
+    casadi_log("IdasInterface::res begin");
 
     // Get time
-    time1 = clock();
+    if (timing_) time1 = clock();
 
-    // Pass input
-    f_.setInput(&t, DAE_T);
-    f_.setInput(xz, DAE_X);
-    f_.setInput(xz+nx_, DAE_Z);
-    f_.setInput(input(INTEGRATOR_P), DAE_P);
-
-    if (monitored("res")) {
+    if (monitor_res_) {
       cout << "DAE_T    = " << t << endl;
-      cout << "DAE_X    = " << f_.input(DAE_X) << endl;
-      cout << "DAE_Z    = " << f_.input(DAE_Z) << endl;
-      cout << "DAE_P    = " << f_.input(DAE_P) << endl;
+      cout << "DAE_X    = " << vector<double>(xz, xz+nx_) << endl;
+      cout << "DAE_Z    = " << vector<double>(xz+nx_, xz+nx_+nz_) << endl;
+      cout << "DAE_P    = " << input(INTEGRATOR_P) << endl;
     }
 
     // Evaluate
-    f_.evaluate();
-
-    // Get results
-    f_.getOutput(r, DAE_ODE);
-    f_.getOutput(r+nx_, DAE_ALG);
+    evalF(t, xz, r, r+nx_, 0);
 
-    if (monitored("res")) {
-      cout << "ODE rhs  = " << f_.output(DAE_ODE) << endl;
-      cout << "ALG rhs  = " << f_.output(DAE_ALG) << endl;
+    if (monitor_res_) {
+      cout << "ODE rhs  = " << vector<double>(r, r+nx_) << endl;
+      cout << "ALG rhs  = " << vector<double>(r+nx_, r+nx_+nz_) << endl;
     }
 
     if (regularity_check_) {
-      casadi_assert_message(isRegular(f_.output(DAE_ODE).data()),
+      casadi_assert_message(isRegular(r, nx_),
                             "IdasInterface::res: f.output(DAE_ODE) is not regular.");
-      casadi_assert_message(isRegular(f_.output(DAE_ALG).data()),
+      casadi_assert_message(isRegular(r+nx_, nz_),
                             "IdasInterface::res: f.output(DAE_ALG) is not regular.");
     }
 
@@ -542,9 +591,11 @@ namespace casadi {
       r[i] -= xzdot[i];
     }
 
-    time2 = clock();
-    t_res += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
-    log("IdasInterface::res", "end");
+    if (timing_) {
+      time2 = clock();
+      t_res += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    }
+    casadi_log("IdasInterface::res end");
   }
 
   int IdasInterface::res_wrapper(double t, N_Vector xz, N_Vector xzdot,
@@ -578,9 +629,9 @@ namespace casadi {
   void IdasInterface::jtimes(double t, const double *xz, const double *xzdot, const double *rr,
                             const double *v, double *Jv, double cj,
                             double *tmp1, double *tmp2) {
-    log("IdasInterface::jtimes", "begin");
+    casadi_log("IdasInterface::jtimes begin");
     // Get time
-    time1 = clock();
+    if (timing_) time1 = clock();
 
     // Pass input
     f_fwd_.setInput(&t,                  DAE_T);
@@ -605,9 +656,11 @@ namespace casadi {
     }
 
     // Log time duration
-    time2 = clock();
-    t_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
-    log("IdasInterface::jtimes", "end");
+    if (timing_) {
+      time2 = clock();
+      t_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    }
+    casadi_log("IdasInterface::jtimes end");
   }
 
   int IdasInterface::jtimes_wrapper(double t, N_Vector xz, N_Vector xzdot, N_Vector rr, N_Vector v,
@@ -627,9 +680,9 @@ namespace casadi {
   void IdasInterface::jtimesB(double t, const double *xz, const double *xzdot, const double *xzB,
                              const double *xzdotB, const double *resvalB, const double *vB,
                              double *JvB, double cjB, double * tmp1B, double * tmp2B) {
-    log("IdasInterface::jtimesB", "begin");
+    casadi_log("IdasInterface::jtimesB begin");
     // Get time
-    time1 = clock();
+    if (timing_) time1 = clock();
 
     // Pass input
     g_fwd_.setInput(&t,                  RDAE_T);
@@ -697,9 +750,11 @@ namespace casadi {
     }
 
     // Log time duration
-    time2 = clock();
-    t_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
-    log("IdasInterface::jtimesB", "end");
+    if (timing_) {
+      time2 = clock();
+      t_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    }
+    casadi_log("IdasInterface::jtimesB end");
   }
 
   int IdasInterface::jtimesB_wrapper(double t, N_Vector xz, N_Vector xzdot, N_Vector xzB,
@@ -721,11 +776,11 @@ namespace casadi {
   void IdasInterface::resS(int Ns, double t, const double* xz, const double* xzdot,
                           const double *resval, N_Vector *xzF, N_Vector* xzdotF, N_Vector *rrF,
                           double *tmp1, double *tmp2, double *tmp3) {
-    log("IdasInterface::resS", "begin");
+    casadi_log("IdasInterface::resS begin");
     //    casadi_assert(Ns==nfdir_);
 
     // Record the current cpu time
-    time1 = clock();
+    if (timing_) time1 = clock();
 
     // Commented out since a new implementation currently cannot be tested
     casadi_error("Commented out, #884, #794.");
@@ -764,9 +819,11 @@ namespace casadi {
     // }
 
     // Record timings
-    time2 = clock();
-    t_fres += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
-    log("IdasInterface::resS", "end");
+    if (timing_) {
+      time2 = clock();
+      t_fres += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    }
+    casadi_log("IdasInterface::resS end");
   }
 
   int IdasInterface::resS_wrapper(int Ns, double t, N_Vector xz, N_Vector xzdot, N_Vector resval,
@@ -784,7 +841,7 @@ namespace casadi {
   }
 
   void IdasInterface::reset() {
-    log("IdasInterface::reset", "begin");
+    casadi_log("IdasInterface::reset begin");
 
     // Reset the base classes
     SundialsInterface::reset();
@@ -813,7 +870,7 @@ namespace casadi {
     // Re-initialize
     flag = IDAReInit(mem_, t0_, xz_, xzdot_);
     if (flag != IDA_SUCCESS) idas_error("IDAReInit", flag);
-    log("IdasInterface::reset", "re-initialized IVP solution");
+    casadi_log("IdasInterface::reset re-initialized IVP solution");
 
 
     // Re-initialize quadratures
@@ -821,7 +878,7 @@ namespace casadi {
       N_VConst(0.0, q_);
       flag = IDAQuadReInit(mem_, q_);
       if (flag != IDA_SUCCESS) idas_error("IDAQuadReInit", flag);
-      log("IdasInterface::reset", "re-initialized quadratures");
+      casadi_log("IdasInterface::reset re-initialized quadratures");
     }
 
     // if (nsens>0) {
@@ -863,12 +920,12 @@ namespace casadi {
     // Set the stop time of the integration -- don't integrate past this point
     if (stop_at_end_) setStopTime(tf_);
 
-    log("IdasInterface::reset", "end");
+    casadi_log("IdasInterface::reset end");
   }
 
 
   void IdasInterface::correctInitialConditions() {
-    log("IdasInterface::correctInitialConditions", "begin");
+    casadi_log("IdasInterface::correctInitialConditions begin");
     if (monitored("correctInitialConditions")) {
       cout << "initial guess: " << endl;
       cout << "p = " << input(INTEGRATOR_P) << endl;
@@ -895,7 +952,7 @@ namespace casadi {
     if (flag != IDA_SUCCESS) idas_error("IDAGetConsistentIC", flag);
 
     // Print progress
-    log("IdasInterface::correctInitialConditions", "found consistent initial values");
+    casadi_log("IdasInterface::correctInitialConditions found consistent initial values");
     if (monitored("correctInitialConditions")) {
       cout << "p = " << input(INTEGRATOR_P) << endl;
       cout << "x0 = " << input(INTEGRATOR_X0) << endl;
@@ -907,7 +964,7 @@ namespace casadi {
       //   }
       // }
     }
-    log("IdasInterface::correctInitialConditions", "end");
+    casadi_log("IdasInterface::correctInitialConditions end");
   }
 
   void IdasInterface::integrate(double t_out) {
@@ -925,22 +982,22 @@ namespace casadi {
     double ttol = 1e-9;   // tolerance
     if (fabs(t_-t_out)<ttol) {
       // No integration necessary
-      log("IdasInterface::integrate", "already at the end of the horizon end");
+      casadi_log("IdasInterface::integrate already at the end of the horizon end");
 
     } else {
       // Integrate ...
       if (nrx_>0) {
         // ... with taping
-        log("IdasInterface::integrate", "integration with taping");
+        casadi_log("IdasInterface::integrate integration with taping");
         flag = IDASolveF(mem_, t_out, &t_, xz_, xzdot_, IDA_NORMAL, &ncheck_);
         if (flag != IDA_SUCCESS && flag != IDA_TSTOP_RETURN) idas_error("IDASolveF", flag);
       } else {
         // ... without taping
-        log("IdasInterface::integrate", "integration without taping");
+        casadi_log("IdasInterface::integrate integration without taping");
         flag = IDASolve(mem_, t_out, &t_, xz_, xzdot_, IDA_NORMAL);
         if (flag != IDA_SUCCESS && flag != IDA_TSTOP_RETURN) idas_error("IDASolve", flag);
       }
-      log("IdasInterface::integrate", "integration complete");
+      casadi_log("IdasInterface::integrate integration complete");
 
       // Get quadrature states
       if (nq_>0) {
@@ -974,7 +1031,7 @@ namespace casadi {
     copy(NV_DATA_S(xz_)+nx_, NV_DATA_S(xz_)+nx_+nz_, output(INTEGRATOR_ZF).begin());
 
     // Print statistics
-    if (getOption("print_stats")) printStats(std::cout);
+    if (print_stats_) printStats(std::cout);
 
     if (gather_stats_) {
       long nsteps, nfevals, nlinsetups, netfails;
@@ -994,7 +1051,7 @@ namespace casadi {
   }
 
   void IdasInterface::resetB() {
-    log("IdasInterface::resetB", "begin");
+    casadi_log("IdasInterface::resetB begin");
 
     int flag;
 
@@ -1023,10 +1080,10 @@ namespace casadi {
 
     // Correct initial values for the integration if necessary
     if (calc_icB_) {
-      log("IdasInterface::resetB", "IDACalcICB begin");
+      casadi_log("IdasInterface::resetB IDACalcICB begin");
       flag = IDACalcICB(mem_, whichB_, t0_, xz_, xzdot_);
       if (flag != IDA_SUCCESS) idas_error("IDACalcICB", flag);
-      log("IdasInterface::resetB", "IDACalcICB end");
+      casadi_log("IdasInterface::resetB IDACalcICB end");
 
       // Retrieve the initial values
       flag = IDAGetConsistentICB(mem_, whichB_, rxz_, rxzdot_);
@@ -1034,7 +1091,7 @@ namespace casadi {
 
     }
 
-    log("IdasInterface::resetB", "end");
+    casadi_log("IdasInterface::resetB end");
 
   }
 
@@ -1176,26 +1233,16 @@ namespace casadi {
   }
 
   void IdasInterface::rhsQ(double t, const double* xz, const double* xzdot, double* rhsQ) {
-    log("IdasInterface::rhsQ", "begin");
-    // Pass input
-    f_.setInput(&t, DAE_T);
-    f_.setInput(xz, DAE_X);
-    f_.setInput(xz+nx_, DAE_Z);
-    f_.setInput(input(INTEGRATOR_P), DAE_P);
-
-    // Evaluate
-    f_.evaluate();
-
-    // Get results
-    f_.getOutput(rhsQ, DAE_QUAD);
-    log("IdasInterface::rhsQ", "end");
+    casadi_log("IdasInterface::rhsQ begin");
+    evalF(t, xz, 0, 0, rhsQ);
+    casadi_log("IdasInterface::rhsQ end");
   }
 
   void IdasInterface::rhsQS(int Ns, double t, N_Vector xz, N_Vector xzdot, N_Vector *xzF,
                            N_Vector *xzdotF, N_Vector rrQ, N_Vector *qdotF,
                            N_Vector tmp1, N_Vector tmp2, N_Vector tmp3) {
 
-    log("IdasInterface::rhsQS", "enter");
+    casadi_log("IdasInterface::rhsQS enter");
     //    casadi_assert(Ns==nfdir_);
 
     // Commented out since a new implementation currently cannot be tested
@@ -1220,7 +1267,7 @@ namespace casadi {
     //   // Get the output seeds
     //   f_.getFwdSens(NV_DATA_S(qdotF[i]), DAE_QUAD);
     //  }
-    log("IdasInterface::rhsQS", "end");
+    casadi_log("IdasInterface::rhsQS end");
   }
 
   int IdasInterface::rhsQS_wrapper(int Ns, double t, N_Vector xz, N_Vector xzdot, N_Vector *xzF,
@@ -1239,30 +1286,21 @@ namespace casadi {
 
   void IdasInterface::resB(double t, const double* xz, const double* xzdot, const double* xzA,
                           const double* xzdotA, double* rrA) {
-    log("IdasInterface::resB", "begin");
-
-    // Pass inputs
-    g_.setInput(&t, RDAE_T);
-    g_.setInput(xz, RDAE_X);
-    g_.setInput(xz+nx_, RDAE_Z);
-    g_.setInput(input(INTEGRATOR_P), RDAE_P);
-    g_.setInput(input(INTEGRATOR_RP), RDAE_RP);
-    g_.setInput(xzA, RDAE_RX);
-    g_.setInput(xzA+nrx_, RDAE_RZ);
-
-    if (monitored("resB")) {
+    casadi_log("IdasInterface::resB begin");
+
+    if (monitor_resB_) {
       cout << "RDAE_T    = " << t << endl;
-      cout << "RDAE_X    = " << g_.input(RDAE_X) << endl;
-      cout << "RDAE_Z    = " << g_.input(RDAE_Z) << endl;
-      cout << "RDAE_P    = " << g_.input(RDAE_P) << endl;
+      cout << "RDAE_X    = " << vector<double>(xz, xz+nx_) << endl;
+      cout << "RDAE_Z    = " << vector<double>(xz+nx_, xz+nx_+nz_) << endl;
+      cout << "RDAE_P    = " << input(INTEGRATOR_P) << endl;
       cout << "RDAE_XDOT  = ";
       for (int k=0;k<nx_;++k) {
         cout << xzdot[k] << " " ;
       }
       cout << endl;
-      cout << "RDAE_RX    = " << g_.input(RDAE_RX) << endl;
-      cout << "RDAE_RZ    = " << g_.input(RDAE_RZ) << endl;
-      cout << "RDAE_RP    = " << g_.input(RDAE_RP) << endl;
+      cout << "RDAE_RX    = " << vector<double>(xzA, xzA+nrx_) << endl;
+      cout << "RDAE_RZ    = " << vector<double>(xzA+nrx_, xzA+nrx_+nrz_) << endl;
+      cout << "RDAE_RP    = " << input(INTEGRATOR_RP) << endl;
       cout << "RDAE_RXDOT  = ";
       for (int k=0;k<nrx_;++k) {
         cout << xzdotA[k] << " " ;
@@ -1271,15 +1309,11 @@ namespace casadi {
     }
 
     // Evaluate
-    g_.evaluate();
-
-    // Save to output
-    g_.getOutput(rrA, RDAE_ODE);
-    g_.getOutput(rrA+nrx_, RDAE_ALG);
+    evalG(t, xz, xzA, rrA, rrA+nrx_, 0);
 
-    if (monitored("resB")) {
-      cout << "RDAE_ODE    = " << g_.output(RDAE_ODE) << endl;
-      cout << "RDAE_ALG    = " << g_.output(RDAE_ALG) << endl;
+    if (monitor_resB_) {
+      cout << "RDAE_ODE    = " << vector<double>(rrA, rrA+nrx_) << endl;
+      cout << "RDAE_ALG    = " << vector<double>(rrA+nrx_, rrA+nrx_+nrz_) << endl;
     }
 
     // Add state derivative to get residual (note definition of g)
@@ -1287,15 +1321,12 @@ namespace casadi {
       rrA[i] += xzdotA[i];
     }
 
-    if (monitored("resB")) {
-      g_.setOutput(rrA, RDAE_ODE);
-      g_.setOutput(rrA+nrx_, RDAE_ALG);
-      cout << "res ODE    = " << g_.output(RDAE_ODE) << endl;
-      cout << "res ALG    = " << g_.output(RDAE_ALG) << endl;
+    if (monitor_resB_) {
+      cout << "res ODE    = " << vector<double>(rrA, rrA+nrx_) << endl;
+      cout << "res ALG    = " << vector<double>(rrA+nrx_, rrA+nrx_+nrz_) << endl;
     }
 
-
-    log("IdasInterface::resB", "end");
+    casadi_log("IdasInterface::resB end");
   }
 
   int IdasInterface::resB_wrapper(double t, N_Vector xz, N_Vector xzdot, N_Vector xzA,
@@ -1313,39 +1344,27 @@ namespace casadi {
 
   void IdasInterface::rhsQB(double t, const double* xz, const double* xzdot, const double* xzA,
                            const double* xzdotA, double *qdotA) {
-    log("IdasInterface::rhsQB", "begin");
-
-    // Pass inputs
-    g_.setInput(&t, RDAE_T);
-    g_.setInput(xz, RDAE_X);
-    g_.setInput(xz+nx_, RDAE_Z);
-    g_.setInput(input(INTEGRATOR_P), RDAE_P);
-    g_.setInput(input(INTEGRATOR_RP), RDAE_RP);
-    g_.setInput(xzA, RDAE_RX);
-    g_.setInput(xzA+nrx_, RDAE_RZ);
+    casadi_log("IdasInterface::rhsQB begin");
 
     // Evaluate
-    g_.evaluate();
+    evalG(t, xz, xzA, 0, 0, qdotA);
 
-    // Save to output
-    g_.getOutput(qdotA, RDAE_QUAD);
-
-    if (monitored("rhsQB")) {
+    if (monitor_rhsQB_) {
       cout << "RDAE_T    = " << t << endl;
-      cout << "RDAE_X    = " << g_.input(RDAE_X) << endl;
-      cout << "RDAE_Z    = " << g_.input(RDAE_Z) << endl;
-      cout << "RDAE_P    = " << g_.input(RDAE_P) << endl;
-      cout << "RDAE_RX    = " << g_.input(RDAE_RX) << endl;
-      cout << "RDAE_RZ    = " << g_.input(RDAE_RZ) << endl;
-      cout << "RDAE_RP    = " << g_.input(RDAE_RP) << endl;
-      cout << "rhs = " << g_.output(RDAE_QUAD) << endl;
+      cout << "RDAE_X    = " << vector<double>(xz, xz+nx_) << endl;
+      cout << "RDAE_Z    = " << vector<double>(xz+nx_, xz+nx_+nz_) << endl;
+      cout << "RDAE_P    = " << input(INTEGRATOR_P) << endl;
+      cout << "RDAE_RX    = " << vector<double>(xzA, xzA+nrx_) << endl;
+      cout << "RDAE_RZ    = " << vector<double>(xzA+nrx_, xzA+nrx_+nrz_) << endl;
+      cout << "RDAE_RP    = " << input(INTEGRATOR_RP) << endl;
+      cout << "rhs = " << vector<double>(qdotA, qdotA+nrq_) << endl;
     }
 
     // Negate (note definition of g)
     for (int i=0; i<nrq_; ++i)
       qdotA[i] *= -1;
 
-    log("IdasInterface::rhsQB", "end");
+    casadi_log("IdasInterface::rhsQB end");
   }
 
   int IdasInterface::rhsQB_wrapper(double t, N_Vector y, N_Vector xzdot, N_Vector xzA,
@@ -1364,25 +1383,18 @@ namespace casadi {
   void IdasInterface::djac(long Neq, double t, double cj, N_Vector xz, N_Vector xzdot,
                           N_Vector rr, DlsMat Jac,
                           N_Vector tmp1, N_Vector tmp2, N_Vector tmp3) {
-    log("IdasInterface::djac", "begin");
+    casadi_log("IdasInterface::djac begin");
 
     // Get time
-    time1 = clock();
-
-    // Pass input to the Jacobian function
-    jac_.setInput(&t, DAE_T);
-    jac_.setInput(NV_DATA_S(xz), DAE_X);
-    jac_.setInput(NV_DATA_S(xz)+nx_, DAE_Z);
-    jac_.setInput(input(INTEGRATOR_P), DAE_P);
-    jac_.setInput(cj, DAE_NUM_IN);
+    if (timing_) time1 = clock();
 
     // Evaluate Jacobian
-    jac_.evaluate();
+    evalJac(t, NV_DATA_S(xz), cj, getPtr(jac_nz_));
 
     // Get sparsity and non-zero elements
     const vector<int>& colind = jac_.output().colind();
     const vector<int>& row = jac_.output().row();
-    const vector<double>& val = jac_.output().data();
+    const vector<double>& val = jac_nz_;
 
     // Loop over columns
     for (int cc=0; cc<colind.size()-1; ++cc) {
@@ -1398,9 +1410,11 @@ namespace casadi {
     }
 
     // Log time duration
-    time2 = clock();
-    t_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
-    log("IdasInterface::djac", "end");
+    if (timing_) {
+      time2 = clock();
+      t_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    }
+    casadi_log("IdasInterface::djac end");
   }
 
   int IdasInterface::djac_wrapper(long Neq, double t, double cj, N_Vector xz, N_Vector xzdot,
@@ -1419,10 +1433,10 @@ namespace casadi {
   void IdasInterface::djacB(long int NeqB, double t, double cjB, N_Vector xz, N_Vector xzdot,
                            N_Vector xzB, N_Vector xzdotB, N_Vector rrB, DlsMat JacB,
                            N_Vector tmp1B, N_Vector tmp2B, N_Vector tmp3B) {
-    log("IdasInterface::djacB", "begin");
+    casadi_log("IdasInterface::djacB begin");
 
     // Get time
-    time1 = clock();
+    if (timing_) time1 = clock();
 
     // Pass input to the Jacobian function
     jacB_.setInput(&t, RDAE_T);
@@ -1481,9 +1495,11 @@ namespace casadi {
     }
 
     // Log time duration
-    time2 = clock();
-    t_jacB += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
-    log("IdasInterface::djacB", "end");
+    if (timing_) {
+      time2 = clock();
+      t_jacB += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    }
+    casadi_log("IdasInterface::djacB end");
   }
 
   int IdasInterface::djacB_wrapper(long int NeqB, double t, double cjB, N_Vector xz, N_Vector xzdot,
@@ -1503,24 +1519,17 @@ namespace casadi {
   void IdasInterface::bjac(long Neq, long mupper, long mlower, double t, double cj, N_Vector xz,
                           N_Vector xzdot, N_Vector rr, DlsMat Jac,
                           N_Vector tmp1, N_Vector tmp2, N_Vector tmp3) {
-    log("IdasInterface::bjac", "begin");
+    casadi_log("IdasInterface::bjac begin");
     // Get time
-    time1 = clock();
-
-    // Pass input to the jacobian function
-    jac_.setInput(&t, DAE_T);
-    jac_.setInput(NV_DATA_S(xz), DAE_X);
-    jac_.setInput(NV_DATA_S(xz)+nx_, DAE_Z);
-    jac_.setInput(input(INTEGRATOR_P), DAE_P);
-    jac_.setInput(cj, DAE_NUM_IN);
+    if (timing_) time1 = clock();
 
     // Evaluate jacobian
-    jac_.evaluate();
+    evalJac(t, NV_DATA_S(xz), cj, getPtr(jac_nz_));
 
     // Get sparsity and non-zero elements
     const vector<int>& colind = jac_.output().colind();
     const vector<int>& row = jac_.output().row();
-    const vector<double>& val = jac_.output().data();
+    const vector<double>& val = jac_nz_;
 
     // Loop over columns
     for (int cc=0; cc<colind.size()-1; ++cc) {
@@ -1536,9 +1545,11 @@ namespace casadi {
     }
 
     // Log time duration
-    time2 = clock();
-    t_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
-    log("IdasInterface::bjac", "end");
+    if (timing_) {
+      time2 = clock();
+      t_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    }
+    casadi_log("IdasInterface::bjac end");
   }
 
   int IdasInterface::bjac_wrapper(long Neq, long mupper, long mlower, double t, double cj,
@@ -1559,10 +1570,10 @@ namespace casadi {
                            N_Vector xz, N_Vector xzdot, N_Vector xzB, N_Vector xzdotB,
                            N_Vector resvalB, DlsMat JacB, N_Vector tmp1B, N_Vector tmp2B,
                            N_Vector tmp3B) {
-    log("IdasInterface::bjacB", "begin");
+    casadi_log("IdasInterface::bjacB begin");
 
     // Get time
-    time1 = clock();
+    if (timing_) time1 = clock();
 
     // Pass input to the Jacobian function
     jacB_.setInput(&t, RDAE_T);
@@ -1621,9 +1632,11 @@ namespace casadi {
     }
 
     // Log time duration
-    time2 = clock();
-    t_jacB += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
-    log("IdasInterface::bjacB", "end");
+    if (timing_) {
+      time2 = clock();
+      t_jacB += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    }
+    casadi_log("IdasInterface::bjacB end");
   }
 
   int IdasInterface::bjacB_wrapper(
@@ -1708,10 +1721,10 @@ namespace casadi {
 
   void IdasInterface::psolve(double t, N_Vector xz, N_Vector xzdot, N_Vector rr, N_Vector rvec,
                             N_Vector zvec, double cj, double delta, N_Vector tmp) {
-    log("IdasInterface::psolve", "begin");
+    casadi_log("IdasInterface::psolve begin");
 
     // Get time
-    time1 = clock();
+    if (timing_) time1 = clock();
 
     // Copy input to output, if necessary
     if (rvec!=zvec) {
@@ -1724,19 +1737,21 @@ namespace casadi {
     linsol_.solve(NV_DATA_S(zvec), 1, false);
 
     // Log time duration
-    time2 = clock();
-    t_lsolve += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
-    log("IdasInterface::psolve", "end");
+    if (timing_) {
+      time2 = clock();
+      t_lsolve += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    }
+    casadi_log("IdasInterface::psolve end");
   }
 
 
   void IdasInterface::psolveB(double t, N_Vector xz, N_Vector xzdot, N_Vector xzB, N_Vector xzdotB,
                              N_Vector resvalB, N_Vector rvecB, N_Vector zvecB,
                              double cjB, double deltaB, N_Vector tmpB) {
-    log("IdasInterface::psolveB", "begin");
+    casadi_log("IdasInterface::psolveB begin");
 
     // Get time
-    time1 = clock();
+    if (timing_) time1 = clock();
 
     // Copy input to output, if necessary
     if (rvecB!=zvecB) {
@@ -1768,56 +1783,52 @@ namespace casadi {
     }
 
     // Log time duration
-    time2 = clock();
-    t_lsolve += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
-    log("IdasInterface::psolveB", "end");
+    if (timing_) {
+      time2 = clock();
+      t_lsolve += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    }
+    casadi_log("IdasInterface::psolveB end");
   }
 
   void IdasInterface::psetup(double t, N_Vector xz, N_Vector xzdot, N_Vector rr, double cj,
                             N_Vector tmp1, N_Vector tmp2, N_Vector tmp3) {
-    log("IdasInterface::psetup", "begin");
+    casadi_log("IdasInterface::psetup begin");
 
     // Get time
-    time1 = clock();
-
-    // Pass input to the jacobian function
-    jac_.setInput(&t, DAE_T);
-    jac_.setInput(NV_DATA_S(xz), DAE_X);
-    jac_.setInput(NV_DATA_S(xz)+nx_, DAE_Z);
-    jac_.setInput(input(INTEGRATOR_P), DAE_P);
-    jac_.setInput(cj, DAE_NUM_IN);
+    if (timing_) time1 = clock();
 
     if (monitored("psetup")) {
       cout << "DAE_T    = " << t << endl;
-      cout << "DAE_X    = " << jac_.input(DAE_X) << endl;
-      cout << "DAE_Z    = " << jac_.input(DAE_Z) << endl;
-      cout << "DAE_P    = " << jac_.input(DAE_P) << endl;
+      cout << "DAE_X    = " << vector<double>(NV_DATA_S(xz), NV_DATA_S(xz)+nx_) << endl;
+      cout << "DAE_Z    = " << vector<double>(NV_DATA_S(xz)+nx_, NV_DATA_S(xz)+nx_+nz_) << endl;
+      cout << "DAE_P    = " << input(INTEGRATOR_P) << endl;
       cout << "cj = " << cj << endl;
     }
 
-    // Evaluate jacobian
-    jac_.evaluate();
+    // Evaluate jacobian directly into the linear solver
+    evalJac(t, NV_DATA_S(xz), cj, linsol_.input(LINSOL_A).ptr());
 
     if (monitored("psetup")) {
-      cout << "psetup = " << jac_.output() << endl;
+      cout << "psetup = " << linsol_.input(LINSOL_A) << endl;
     }
 
     // Log time duration
-    time2 = clock();
-    t_lsetup_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
-
-    // Pass non-zero elements to the linear solver
-    linsol_.setInput(jac_.output(), 0);
+    if (timing_) {
+      time2 = clock();
+      t_lsetup_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    }
 
     // Prepare the solution of the linear system (e.g. factorize)
     // -- only if the linear solver inherits from LinearSolver
     linsol_.prepare();
 
     // Log time duration
-    time1 = clock();
-    t_lsetup_fac += static_cast<double>(time1-time2)/CLOCKS_PER_SEC;
+    if (timing_) {
+      time1 = clock();
+      t_lsetup_fac += static_cast<double>(time1-time2)/CLOCKS_PER_SEC;
+    }
 
-    log("IdasInterface::psetup", "end");
+    casadi_log("IdasInterface::psetup end");
 
   }
 
@@ -1825,10 +1836,10 @@ namespace casadi {
   void IdasInterface::psetupB(double t, N_Vector xz, N_Vector xzdot, N_Vector xzB, N_Vector xzdotB,
                              N_Vector resvalB, double cjB,
                              N_Vector tmp1B, N_Vector tmp2B, N_Vector tmp3B) {
-    log("IdasInterface::psetupB", "begin");
+    casadi_log("IdasInterface::psetupB begin");
 
     // Get time
-    time1 = clock();
+    if (timing_) time1 = clock();
 
     // Pass input to the Jacobian function
     jacB_.setInput(&t, RDAE_T);
@@ -1869,8 +1880,10 @@ namespace casadi {
     }
 
     // Log time duration
-    time2 = clock();
-    t_lsetup_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    if (timing_) {
+      time2 = clock();
+      t_lsetup_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
+    }
 
     // Pass non-zero elements to the linear solver
     linsolB_.setInput(jacB_.output(), 0);
@@ -1880,10 +1893,12 @@ namespace casadi {
     linsolB_.prepare();
 
     // Log time duration
-    time1 = clock();
-    t_lsetup_fac += static_cast<double>(time1-time2)/CLOCKS_PER_SEC;
+    if (timing_) {
+      time1 = clock();
+      t_lsetup_fac += static_cast<double>(time1-time2)/CLOCKS_PER_SEC;
+    }
 
-    log("IdasInterface::psetupB", "end");
+    casadi_log("IdasInterface::psetupB end");
 
   }
 
@@ -1992,7 +2007,7 @@ namespace casadi {
 
   void IdasInterface::lsetup(IDAMem IDA_mem, N_Vector xz, N_Vector xzdot, N_Vector resp,
                             N_Vector vtemp1, N_Vector vtemp2, N_Vector vtemp3) {
-    log("IdasInterface::lsetup", "begin");
+    casadi_log("IdasInterface::lsetup begin");
 
     // Current time
     double t = IDA_mem->ida_tn;
@@ -2002,23 +2017,23 @@ namespace casadi {
 
     // Call the preconditioner setup function (which sets up the linear solver)
     psetup(t, xz, xzdot, 0, cj, vtemp1, vtemp1, vtemp3);
-    log("IdasInterface::lsetup", "end");
+    casadi_log("IdasInterface::lsetup end");
   }
 
   void IdasInterface::lsetupB(double t, double cj, N_Vector xz, N_Vector xzdot, N_Vector xzB,
                              N_Vector xzdotB, N_Vector resp,
                              N_Vector vtemp1, N_Vector vtemp2, N_Vector vtemp3) {
-    log("IdasInterface::lsetupB", "begin");
+    casadi_log("IdasInterface::lsetupB begin");
 
     // Call the preconditioner setup function (which sets up the linear solver)
     psetupB(t, xz, xzdot, xzB, xzdotB, 0, cj, vtemp1, vtemp1, vtemp3);
-    log("IdasInterface::lsetupB", "end");
+    casadi_log("IdasInterface::lsetupB end");
   }
 
 
   void IdasInterface::lsolve(IDAMem IDA_mem, N_Vector b, N_Vector weight, N_Vector xz,
                             N_Vector xzdot, N_Vector rr) {
-    log("IdasInterface::lsolve", "begin");
+    casadi_log("IdasInterface::lsolve begin");
     // Current time
     double t = IDA_mem->ida_tn;
 
@@ -2031,18 +2046,19 @@ namespace casadi {
     // Call the preconditioner solve function (which solves the linear system)
     psolve(t, xz, xzdot, rr, b, b, cj, delta, 0);
 
-    // Scale the correction to account for change in cj
-    if (cj_scaling_) {
+    // Scale the correction to account for change in cj (always done by the sparse solver,
+    // like the direct solvers of IDAS)
+    if (cj_scaling_ || linsol_f_==SD_SPARSE) {
       double cjratio = IDA_mem->ida_cjratio;
       if (cjratio != 1.0) N_VScale(2.0/(1.0 + cjratio), b, b);
     }
-    log("IdasInterface::lsolve", "end");
+    casadi_log("IdasInterface::lsolve end");
   }
 
   void IdasInterface::lsolveB(double t, double cj, double cjratio, N_Vector b, N_Vector weight,
                              N_Vector xz, N_Vector xzdot, N_Vector xzB, N_Vector xzdotB,
                              N_Vector rr) {
-    log("IdasInterface::lsolveB", "begin");
+    casadi_log("IdasInterface::lsolveB begin");
 
     // Accuracy
     double delta = 0.0;
@@ -2051,11 +2067,11 @@ namespace casadi {
     psolveB(t, xz, xzdot, xzB, xzdotB, rr, b, b, cj, delta, 0);
 
     // Scale the correction to account for change in cj
-    if (cj_scaling_) {
+    if (cj_scaling_ || linsol_g_==SD_SPARSE) {
       if (cjratio != 1.0) N_VScale(2.0/(1.0 + cjratio), b, b);
     }
 
-    log("IdasInterface::lsolveB", "end");
+    casadi_log("IdasInterface::lsolveB end");
   }
 
 
@@ -45,9 +45,11 @@
       you may experience a dramatic speed-up by using a sparse linear solver:
 
       \verbatim
-       intg.setOption("linear_solver","csparse")
-       intg.setOption("linear_solver_type","user_defined")
+       intg.setOption("linear_solver_type","sparse")
       \endverbatim
+
+      which factorizes the Newton matrix in compressed column format with
+      csparse, or with the LinearSolver plugin given by "linear_solver".
 */
 
 /** \pluginsection{Integrator,idas} */
@@ -150,6 +152,16 @@ namespace casadi {
 
   protected:
 
+    /// Evaluate the DAE right-hand side and/or quadratures, null results are not calculated
+    void evalF(double t, const double* xz, double* ode, double* alg, double* quad);
+
+    /// Evaluate the backward right-hand side and/or quadratures
+    void evalG(double t, const double* xz, const double* rxz, double* rode, double* ralg,
+               double* rquad);
+
+    /// Evaluate the nonzeros of the Jacobian of the residual for a given \p cj
+    void evalJac(double t, const double* xz, double cj, double* jac);
+
     // Sundials callback functions
     void res(double t, const double* xz, const double* xzdot, double* rr);
     void ehfun(int error_code, const char *module, const char *function, char *msg);
@@ -327,6 +339,21 @@ namespace casadi {
     //  Initial values for \p xdot and \p z
     std::vector<double> init_xdot_;
 
+    // Monitors of the residual functions
+    bool monitor_res_, monitor_resB_, monitor_rhsQB_;
+
+    // Time the callbacks, only if gather_stats or print_stats
+    bool timing_;
+
+    // Memory and argument/result pointers for evaluating f_, g_ and jac_ directly on the
+    // data of the Sundials vectors
+    FunctionMemory f_mem_, g_mem_, jac_mem_;
+    std::vector<const double*> f_arg_, g_arg_, jac_arg_;
+    std::vector<double*> f_res_, g_res_, jac_res_;
+
+    // Nonzeros of the Jacobian
+    std::vector<double> jac_nz_;
+
   };
 
 } // namespace casadi
@@ -37,11 +37,13 @@
 "\n"
 "::\n"
 "\n"
-"     intg.setOption(\"linear_solver\",\"csparse\")\n"
-"     intg.setOption(\"linear_solver_type\",\"user_defined\")\n"
+"     intg.setOption(\"linear_solver_type\",\"sparse\")\n"
 "\n"
 "\n"
 "\n"
+"which factorizes the Newton matrix in compressed column format with\n"
+"csparse, or with the LinearSolver plugin given by \"linear_solver\".\n"
+"\n"
 "\n"
 ">List of available options\n"
 "\n"
@@ -204,13 +206,32 @@
 "|                 |                 |                 | to linear_solve |\n"
 "|                 |                 |                 | r_options]      |\n"
 "+-----------------+-----------------+-----------------+-----------------+\n"
-"| linear_solver_t | OT_STRING       | \"dense\"         | (user_defined|d |\n"
-"| ype             |                 |                 | ense|banded|ite |\n"
-"|                 |                 |                 | rative)         |\n"
+"| linear_solver_t | OT_STRING       | \"dense\"         | Linear solver   |\n"
+"| ype             |                 |                 | for the Newton  |\n"
+"|                 |                 |                 | iterations.     |\n"
+"|                 |                 |                 | 'sparse' uses   |\n"
+"|                 |                 |                 | the exact       |\n"
+"|                 |                 |                 | Jacobian in     |\n"
+"|                 |                 |                 | compressed      |\n"
+"|                 |                 |                 | column format   |\n"
+"|                 |                 |                 | with the        |\n"
+"|                 |                 |                 | LinearSolver    |\n"
+"|                 |                 |                 | plugin          |\n"
+"|                 |                 |                 | 'linear_solver' |\n"
+"|                 |                 |                 | [default:       |\n"
+"|                 |                 |                 | csparse with a  |\n"
+"|                 |                 |                 | fill-reducing   |\n"
+"|                 |                 |                 | ordering and    |\n"
+"|                 |                 |                 | numeric         |\n"
+"|                 |                 |                 | refactorization |\n"
+"|                 |                 |                 | ]               |\n"
+"|                 |                 |                 | (user_defined|d |\n"
+"|                 |                 |                 | ense|banded|ite |\n"
+"|                 |                 |                 | rative|sparse)  |\n"
 "+-----------------+-----------------+-----------------+-----------------+\n"
 "| linear_solver_t | OT_STRING       | GenericType()   | (user_defined|d |\n"
 "| ypeB            |                 |                 | ense|banded|ite |\n"
-"|                 |                 |                 | rative)         |\n"
+"|                 |                 |                 | rative|sparse)  |\n"
 "+-----------------+-----------------+-----------------+-----------------+\n"
 "| lower_bandwidth | OT_INTEGER      | GenericType()   | Lower band-     |\n"
 "|                 |                 |                 | width of banded |\n"
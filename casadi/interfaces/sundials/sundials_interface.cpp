@@ -55,7 +55,10 @@ SundialsInterface::SundialsInterface(const Function& f, const Function& g)
   addOption("lower_bandwidth",             OT_INTEGER,          GenericType(),
             "Lower band-width of banded Jacobian (estimations)");
   addOption("linear_solver_type",          OT_STRING,           "dense",
-            "", "user_defined|dense|banded|iterative");
+            "Linear solver for the Newton iterations. 'sparse' uses the exact Jacobian in "
+            "compressed column format with the LinearSolver plugin 'linear_solver' "
+            "[default: csparse with a fill-reducing ordering and numeric refactorization]",
+            "user_defined|dense|banded|iterative|sparse");
   addOption("iterative_solver",            OT_STRING,           "gmres",
             "", "gmres|bcgstab|tfqmr");
   addOption("pretype",                     OT_STRING,           "none",
@@ -104,7 +107,7 @@ SundialsInterface::SundialsInterface(const Function& f, const Function& g)
             "lower band-width of banded jacobians for backward integration "
             "[default: equal to lower_bandwidth]");
   addOption("linear_solver_typeB",         OT_STRING,           GenericType(),
-            "", "user_defined|dense|banded|iterative");
+            "", "user_defined|dense|banded|iterative|sparse");
   addOption("iterative_solverB",           OT_STRING,           GenericType(),
             "", "gmres|bcgstab|tfqmr");
   addOption("pretypeB",                    OT_STRING,           GenericType(),
@@ -187,6 +190,8 @@ void SundialsInterface::init() {
       throw CasadiException("Unknown preconditioning type for forward integration");
   } else if (getOption("linear_solver_type")=="user_defined") {
     linsol_f_ = SD_USER_DEFINED;
+  } else if (getOption("linear_solver_type")=="sparse") {
+    linsol_f_ = SD_SPARSE;
   } else {
     throw CasadiException("Unknown linear solver for forward integration");
   }
@@ -226,6 +231,8 @@ void SundialsInterface::init() {
       throw CasadiException("Unknown preconditioning type for backward integration");
   } else if (linear_solver_typeB=="user_defined") {
     linsol_g_ = SD_USER_DEFINED;
+  } else if (linear_solver_typeB=="sparse") {
+    linsol_g_ = SD_SPARSE;
   } else {
    casadi_error("Unknown linear solver for backward integration: " << iterative_solverB);
   }
@@ -268,10 +275,19 @@ void SundialsInterface::init() {
       << jacB_.output().size2() << ")");
   }
 
-  if (hasSetOption("linear_solver") && !jac_.isNull()) {
+  if (linsol_f_==SD_SPARSE) {
+    casadi_assert_message(!jac_.isNull(), "SundialsInterface::init: linear_solver_type 'sparse' "
+                          "requires exact_jacobian");
+  }
+
+  if ((hasSetOption("linear_solver") || linsol_f_==SD_SPARSE) && !jac_.isNull()) {
     // Create a linear solver
-    std::string linear_solver_name = getOption("linear_solver");
-    linsol_ = LinearSolver(linear_solver_name, jac_.output().sparsity(), 1);
+    if (hasSetOption("linear_solver")) {
+      std::string linear_solver_name = getOption("linear_solver");
+      linsol_ = LinearSolver(linear_solver_name, jac_.output().sparsity(), 1);
+    } else {
+      linsol_ = sparseLinearSolver(jac_.output().sparsity());
+    }
     // Pass options
     if (hasSetOption("linear_solver_options")) {
       linsol_.setOption(getOption("linear_solver_options"));
@@ -279,11 +295,16 @@ void SundialsInterface::init() {
     linsol_.init();
   }
 
-  if ((hasSetOption("linear_solverB") || hasSetOption("linear_solver")) && !jacB_.isNull()) {
+  if ((hasSetOption("linear_solverB") || hasSetOption("linear_solver") || linsol_g_==SD_SPARSE)
+      && !jacB_.isNull()) {
     // Create a linear solver
-    std::string linear_solver_name =
+    if (hasSetOption("linear_solverB") || hasSetOption("linear_solver")) {
+      std::string linear_solver_name =
         hasSetOption("linear_solverB") ? getOption("linear_solverB") : getOption("linear_solver");
-    linsolB_ = LinearSolver(linear_solver_name, jacB_.output().sparsity(), 1);
+      linsolB_ = LinearSolver(linear_solver_name, jacB_.output().sparsity(), 1);
+    } else {
+      linsolB_ = sparseLinearSolver(jacB_.output().sparsity());
+    }
     // Pass options
     if (hasSetOption("linear_solver_optionsB")) {
       linsolB_.setOption(getOption("linear_solver_optionsB"));
@@ -294,6 +315,15 @@ void SundialsInterface::init() {
   }
 }
 
+LinearSolver SundialsInterface::sparseLinearSolver(const Sparsity& sp) {
+  // The pattern of the Newton matrix is fixed, so the ordering is computed once and
+  // later factorizations only update the numerical values
+  LinearSolver linsol("csparse", sp, 1);
+  linsol.setOption("ordering", "amd");
+  linsol.setOption("refactorize", true);
+  return linsol;
+}
+
 void SundialsInterface::deepCopyMembers(std::map<SharedObjectNode*, SharedObject>& already_copied) {
   IntegratorInternal::deepCopyMembers(already_copied);
   linsol_ = deepcopy(linsol_, already_copied);
@@ -74,8 +74,12 @@ public:
   /// number of checkpoints stored so far
   int ncheck_;
 
-  /// Supported linear solvers in Sundials
-  enum LinearSolverType {SD_USER_DEFINED, SD_DENSE, SD_BANDED, SD_ITERATIVE};
+  /** \brief Supported linear solvers in Sundials
+
+      SD_SPARSE factorizes the Newton matrix in compressed column format with a
+      LinearSolver plugin hooked into the lsetup/lsolve functions of Sundials
+  */
+  enum LinearSolverType {SD_USER_DEFINED, SD_DENSE, SD_BANDED, SD_ITERATIVE, SD_SPARSE};
 
   /// Supported iterative solvers in Sundials
   enum IterativeSolverType {SD_GMRES, SD_BCGSTAB, SD_TFQMR};
@@ -115,6 +119,9 @@ public:
 
   // Get bandwidth for backward problem
   std::pair<int, int> getBandwidthB() const;
+
+  // Default linear solver for linear_solver_type 'sparse'
+  static LinearSolver sparseLinearSolver(const Sparsity& sp);
 };
 
 } // namespace casadi
@@ -132,6 +132,18 @@ namespace casadi {
     Wrapper::evaluate();
   }
 
+  void CondensingIndefDpleInternal::evalD(const double** arg, double** res, FunctionMemory& mem) {
+    Wrapper::evalD(arg, res, mem);
+  }
+
+  void CondensingIndefDpleInternal::allocMemory(FunctionMemory& mem) const {
+    Wrapper::allocMemory(mem);
+  }
+
+  bool CondensingIndefDpleInternal::isReentrant() const {
+    return Wrapper::isReentrant();
+  }
+
   Function CondensingIndefDpleInternal::getDerivative(int nfwd, int nadj) {
     return f_.derivative(nfwd, nadj);
   }
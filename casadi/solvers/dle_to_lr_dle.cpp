@@ -95,6 +95,18 @@ namespace casadi {
     Wrapper::evaluate();
   }
 
+  void DleToLrDle::evalD(const double** arg, double** res, FunctionMemory& mem) {
+    Wrapper::evalD(arg, res, mem);
+  }
+
+  void DleToLrDle::allocMemory(FunctionMemory& mem) const {
+    Wrapper::allocMemory(mem);
+  }
+
+  bool DleToLrDle::isReentrant() const {
+    return Wrapper::isReentrant();
+  }
+
   Function DleToLrDle::getDerivative(int nfwd, int nadj) {
     return f_.derivative(nfwd, nadj);
 
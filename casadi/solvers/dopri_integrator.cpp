@@ -0,0 +1,528 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "dopri_integrator.hpp"
+#include "casadi/core/std_vector_tools.hpp"
+#include "casadi/core/function/sx_function.hpp"
+#include "casadi/core/function/mx_function.hpp"
+
+using namespace std;
+namespace casadi {
+
+  extern "C"
+  int CASADI_INTEGRATOR_DOPRI_EXPORT
+      casadi_register_integrator_dopri(IntegratorInternal::Plugin* plugin) {
+    plugin->creator = DopriIntegrator::creator;
+    plugin->name = "dopri";
+    plugin->doc = DopriIntegrator::meta_doc.c_str();
+    plugin->version = 22;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_INTEGRATOR_DOPRI_EXPORT casadi_load_integrator_dopri() {
+    IntegratorInternal::registerPlugin(casadi_register_integrator_dopri);
+  }
+
+  DopriIntegrator::DopriIntegrator(const Function& f, const Function& g) :
+      IntegratorInternal(f, g) {
+    addOption("tableau",                 OT_STRING,  "dopri5",
+              "Embedded Runge-Kutta pair: Dormand-Prince 5(4) or Bogacki-Shampine 3(2)",
+              "dopri5|bs3");
+    addOption("abstol",                  OT_REAL,    1e-8,
+              "Absolute tolerance for the IVP solution");
+    addOption("reltol",                  OT_REAL,    1e-6,
+              "Relative tolerance for the IVP solution");
+    addOption("abstolB",                 OT_REAL,    GenericType(),
+              "Absolute tolerance for the adjoint sensitivity solution [default: equal to abstol]");
+    addOption("reltolB",                 OT_REAL,    GenericType(),
+              "Relative tolerance for the adjoint sensitivity solution [default: equal to reltol]");
+    addOption("quad_err_con",            OT_BOOLEAN, false,
+              "Should the quadratures affect the step size control");
+    addOption("max_num_steps",           OT_INTEGER, 10000,
+              "Maximum number of accepted integrator steps over the time horizon, counted from "
+              "reset (resetB for the backward problem)");
+    addOption("max_step_size",           OT_REAL,    0.0,
+              "Maximum step size, 0 for no limit");
+    addOption("initial_step_size",       OT_REAL,    0.0,
+              "Size of the first step, 0 to estimate it from the derivatives");
+    addOption("expand_f",                OT_BOOLEAN, false,
+              "Expand the DAE functions in scalar operations, if they are MXFunction");
+  }
+
+  void DopriIntegrator::deepCopyMembers(
+      std::map<SharedObjectNode*, SharedObject>& already_copied) {
+    IntegratorInternal::deepCopyMembers(already_copied);
+  }
+
+  DopriIntegrator::~DopriIntegrator() {
+  }
+
+  void DopriIntegrator::init() {
+    // Call the base class init
+    IntegratorInternal::init();
+
+    // Algebraic variables not supported
+    casadi_assert_message(nz_==0 && nrz_==0,
+                          "Explicit Runge-Kutta integrators do not support algebraic variables");
+
+    // Expand the DAE functions
+    if (getOption("expand_f")) {
+      Function* fcn[] = {&f_, &g_};
+      for (int i=0; i<2; ++i) {
+        if (fcn[i]->isNull()) continue;
+        MXFunction fcn_mx = shared_cast<MXFunction>(*fcn[i]);
+        if (fcn_mx.isNull()) continue;
+        *fcn[i] = SXFunction(fcn_mx);
+        fcn[i]->copyOptions(fcn_mx, true);
+        fcn[i]->init();
+      }
+    }
+
+    // Butcher tableau, with the first-same-as-last property: the last stage is evaluated
+    // at the new state, so its coefficients are the weights of the solution
+    string tableau = getOption("tableau");
+    if (tableau=="dopri5") {
+      double c[] = {0, 1./5, 3./10, 4./5, 8./9, 1, 1};
+      double a[] = {0, 0, 0, 0, 0, 0, 0,
+                    1./5, 0, 0, 0, 0, 0, 0,
+                    3./40, 9./40, 0, 0, 0, 0, 0,
+                    44./45, -56./15, 32./9, 0, 0, 0, 0,
+                    19372./6561, -25360./2187, 64448./6561, -212./729, 0, 0, 0,
+                    9017./3168, -355./33, 46732./5247, 49./176, -5103./18656, 0, 0,
+                    35./384, 0, 500./1113, 125./192, -2187./6784, 11./84, 0};
+      double e[] = {71./57600, 0, -71./16695, 71./1920, -17253./339200, 22./525, -1./40};
+
+      // Continuous extension of order 4 (Hairer, Norsett and Wanner)
+      double d[] = {-12715105075./11282082432, 0, 87487479700./32700410799,
+                    -10690763975./1880347072, 701980252875./199316789632,
+                    -1453857185./822651844, 69997945./29380423};
+      nstages_ = 7;
+      order_ = 5;
+      c_.assign(c, c+nstages_);
+      a_.assign(a, a+nstages_*nstages_);
+      e_.assign(e, e+nstages_);
+      d_.assign(d, d+nstages_);
+    } else if (tableau=="bs3") {
+      double c[] = {0, 1./2, 3./4, 1};
+      double a[] = {0, 0, 0, 0,
+                    1./2, 0, 0, 0,
+                    0, 3./4, 0, 0,
+                    2./9, 1./3, 4./9, 0};
+      double e[] = {-5./72, 1./12, 1./9, -1./8};
+      nstages_ = 4;
+      order_ = 3;
+      c_.assign(c, c+nstages_);
+      a_.assign(a, a+nstages_*nstages_);
+      e_.assign(e, e+nstages_);
+
+      // Dense output is the cubic Hermite interpolant
+      d_.clear();
+    } else {
+      casadi_error("Unknown tableau: " << tableau);
+    }
+
+    // Read options
+    max_num_steps_ = getOption("max_num_steps");
+    max_step_size_ = getOption("max_step_size");
+    initial_step_size_ = getOption("initial_step_size");
+    bool quad_err_con = getOption("quad_err_con");
+
+    // Forward problem, without error control on the quadratures the states come first
+    fwd_.backward = false;
+    fwd_.n = nx_ + nq_;
+    fwd_.n_err = quad_err_con || nx_==0 ? fwd_.n : nx_;
+    fwd_.abstol = getOption("abstol");
+    fwd_.reltol = getOption("reltol");
+
+    // Backward problem
+    bwd_.backward = true;
+    bwd_.n = nrx_ + nrq_;
+    bwd_.n_err = quad_err_con || nrx_==0 ? bwd_.n : nrx_;
+    bwd_.abstol = hasSetOption("abstolB") ? static_cast<double>(getOption("abstolB"))
+        : fwd_.abstol;
+    bwd_.reltol = hasSetOption("reltolB") ? static_cast<double>(getOption("reltolB"))
+        : fwd_.reltol;
+
+    // Recomputation of forward steps, no error control
+    ck_ = fwd_;
+    ck_.n_err = 0;
+
+    // Allocate work vectors
+    Stepper* s[] = {&fwd_, &bwd_, &ck_};
+    for (int i=0; i<3; ++i) {
+      s[i]->y.resize(s[i]->n);
+      s[i]->y_old.resize(s[i]->n);
+      s[i]->y_new.resize(s[i]->n);
+      s[i]->k.resize(nstages_*s[i]->n);
+    }
+    ck_x_.resize(nx_);
+
+    // Memory for the DAE functions
+    f_mem_ = f_.allocMemory();
+    f_arg_.resize(DAE_NUM_IN);
+    f_res_.resize(DAE_NUM_OUT);
+    if (!g_.isNull()) {
+      g_mem_ = g_.allocMemory();
+      g_arg_.resize(RDAE_NUM_IN);
+      g_res_.resize(RDAE_NUM_OUT);
+    }
+  }
+
+  void DopriIntegrator::rhs(double t, const double* y, double* ydot) {
+    f_arg_[DAE_T] = &t;
+    f_arg_[DAE_X] = y;
+    f_arg_[DAE_Z] = 0;
+    f_arg_[DAE_P] = getPtr(p().data());
+    f_res_[DAE_ODE] = ydot;
+    f_res_[DAE_ALG] = 0;
+    f_res_[DAE_QUAD] = ydot+nx_;
+    f_.evaluate(getPtr(f_arg_), getPtr(f_res_), f_mem_);
+  }
+
+  void DopriIntegrator::rhsB(double t, const double* ry, double* rydot) {
+    g_arg_[RDAE_T] = &t;
+    g_arg_[RDAE_X] = checkpointState(t);
+    g_arg_[RDAE_Z] = 0;
+    g_arg_[RDAE_P] = getPtr(p().data());
+    g_arg_[RDAE_RX] = ry;
+    g_arg_[RDAE_RZ] = 0;
+    g_arg_[RDAE_RP] = getPtr(rp().data());
+    g_res_[RDAE_ODE] = rydot;
+    g_res_[RDAE_ALG] = 0;
+    g_res_[RDAE_QUAD] = rydot+nrx_;
+    g_.evaluate(getPtr(g_arg_), getPtr(g_res_), g_mem_);
+
+    // The backward problem is stated in reversed time
+    for (int i=0; i<nrx_+nrq_; ++i) rydot[i] = -rydot[i];
+  }
+
+  void DopriIntegrator::eval(Stepper& s, double t, const double* y, double* ydot) {
+    if (s.backward) {
+      rhsB(t, y, ydot);
+    } else {
+      rhs(t, y, ydot);
+    }
+    s.nevals++;
+  }
+
+  void DopriIntegrator::start(Stepper& s, double t, double t_end) {
+    s.t = s.t_old = t;
+    s.t_end = t_end;
+    s.h = 0;
+    s.nsteps = s.nrejected = s.nevals = 0;
+
+    // Derivative at the initial point, the first stage of the first step
+    eval(s, s.t, getPtr(s.y), getPtr(s.k) + (nstages_-1)*s.n);
+
+    // Size of the first step
+    s.h_next = t_end==t ? 0 : initial_step_size_>0 ? initial_step_size_ : initialStep(s);
+    if (max_step_size_>0) s.h_next = std::min(s.h_next, max_step_size_);
+    if (t_end<t) s.h_next = -s.h_next;
+  }
+
+  double DopriIntegrator::initialStep(Stepper& s) {
+    // Algorithm of Hairer, Norsett and Wanner, Solving ODEs I, section II.4
+    int n = s.n;
+    const double* y0 = getPtr(s.y);
+    const double* f0 = getPtr(s.k) + (nstages_-1)*n;
+    double* y1 = getPtr(s.y_new);
+    double* f1 = getPtr(s.k);
+    double dir = s.t_end<s.t ? -1 : 1;
+
+    // Without error controlled components, a single step over the horizon
+    if (s.n_err==0) return std::fabs(s.t_end-s.t);
+
+    // Norms of the state and of its derivative
+    double d0 = 0, d1 = 0;
+    for (int i=0; i<s.n_err; ++i) {
+      double sc = s.abstol + s.reltol*std::fabs(y0[i]);
+      d0 += (y0[i]/sc)*(y0[i]/sc);
+      d1 += (f0[i]/sc)*(f0[i]/sc);
+    }
+    d0 = std::sqrt(d0/s.n_err);
+    d1 = std::sqrt(d1/s.n_err);
+
+    // First guess, and an explicit Euler step
+    double h0 = d0<1e-5 || d1<1e-5 ? 1e-6 : 0.01*d0/d1;
+    h0 = std::min(h0, std::fabs(s.t_end-s.t));
+    for (int i=0; i<n; ++i) y1[i] = y0[i] + dir*h0*f0[i];
+    eval(s, s.t + dir*h0, y1, f1);
+
+    // Estimate of the second derivative
+    double d2 = 0;
+    for (int i=0; i<s.n_err; ++i) {
+      double sc = s.abstol + s.reltol*std::fabs(y0[i]);
+      d2 += ((f1[i]-f0[i])/sc)*((f1[i]-f0[i])/sc);
+    }
+    d2 = std::sqrt(d2/s.n_err)/h0;
+
+    // Step for which the local error is about 0.01
+    double der12 = std::max(d1, d2);
+    double h1 = der12<=1e-15 ? std::max(1e-6, h0*1e-3) : std::pow(0.01/der12, 1./order_);
+    return std::min(std::min(100*h0, h1), std::fabs(s.t_end-s.t));
+  }
+
+  double DopriIntegrator::trialStep(Stepper& s, double h) {
+    int n = s.n;
+    double* k = getPtr(s.k);
+    double* y1 = getPtr(s.y_new);
+
+    // Stages, the argument of the last stage is the new state
+    for (int i=1; i<nstages_; ++i) {
+      copy(s.y.begin(), s.y.end(), y1);
+      for (int j=0; j<i; ++j) {
+        double a = h*a_[i*nstages_+j];
+        if (a==0) continue;
+        const double* kj = k + j*n;
+        for (int el=0; el<n; ++el) y1[el] += a*kj[el];
+      }
+      eval(s, s.t + c_[i]*h, y1, k + i*n);
+    }
+
+    // Local error estimate, weighted root mean square
+    if (s.n_err==0) return 0;
+    double err = 0;
+    for (int el=0; el<s.n_err; ++el) {
+      double e = 0;
+      for (int j=0; j<nstages_; ++j) e += e_[j]*k[j*n+el];
+      e *= h/(s.abstol + s.reltol*std::max(std::fabs(s.y[el]), std::fabs(y1[el])));
+      err += e*e;
+    }
+    return std::sqrt(err/s.n_err);
+  }
+
+  void DopriIntegrator::acceptStep(Stepper& s, double h, double t_new) {
+    s.y_old.swap(s.y);
+    s.y.swap(s.y_new);
+    s.t_old = s.t;
+    s.t = t_new;
+    s.h = h;
+  }
+
+  void DopriIntegrator::step(Stepper& s) {
+    // Step size control parameters: safety factor, bounds on the change of the step size
+    const double fac = 0.9, facmin = 0.2, facmax = 10;
+
+    // The derivative at the current point is the first stage
+    double* k = getPtr(s.k);
+    copy(k + (nstages_-1)*s.n, k + nstages_*s.n, k);
+
+    double h = s.h_next;
+    bool rejected = false;
+    while (true) {
+      // Do not step past the end of the time horizon, and stretch the step onto the end
+      // if the remainder would be tiny (Hairer, Norsett and Wanner)
+      bool last = (s.t + 1.01*h - s.t_end)*h >= 0;
+      if (last) h = s.t_end - s.t;
+
+      // Step size underflow
+      casadi_assert_message(std::fabs(h) > 16*numeric_limits<double>::epsilon()*std::fabs(s.t),
+                            "DopriIntegrator: step size too small at t = " << s.t);
+
+      // Attempt step
+      double err = trialStep(s, h);
+      if (err<=1) {
+        acceptStep(s, h, last ? s.t_end : s.t + h);
+        s.nsteps++;
+
+        // Next step size, not increased right after a rejection
+        double h_next = h*(err==0 ? facmax : std::min(facmax, std::max(facmin,
+                                     fac*std::pow(err, -1./order_))));
+        if (rejected && std::fabs(h_next)>std::fabs(h)) h_next = h;
+        if (max_step_size_>0 && std::fabs(h_next)>max_step_size_) {
+          h_next = h_next>0 ? max_step_size_ : -max_step_size_;
+        }
+        s.h_next = h_next;
+        return;
+      }
+
+      // Reject and try again with a smaller step, also if the error is not a number
+      s.nrejected++;
+      rejected = true;
+      h *= std::max(facmin, fac*std::pow(err, -1./order_));
+    }
+  }
+
+  void DopriIntegrator::interpolate(const Stepper& s, double t, int offset, int n,
+                                    double* y) const {
+    // Exactly at the current point
+    if (t==s.t) {
+      copy(s.y.begin()+offset, s.y.begin()+offset+n, y);
+      return;
+    }
+
+    // Continuous extension: cubic Hermite interpolant plus a tableau specific correction
+    const double* y0 = getPtr(s.y_old);
+    const double* y1 = getPtr(s.y);
+    const double* k = getPtr(s.k);
+    const double* k0 = k;
+    const double* k1 = k + (nstages_-1)*s.n;
+    double th = (t - s.t_old)/s.h, th1 = 1-th;
+    for (int el=offset; el<offset+n; ++el) {
+      double dy = y1[el] - y0[el];
+      double c3 = s.h*k0[el] - dy;
+      double c4 = dy - s.h*k1[el] - c3;
+      double c5 = 0;
+      for (int j=0; j<d_.size(); ++j) c5 += d_[j]*k[j*s.n+el];
+      c5 *= s.h;
+      *y++ = y0[el] + th*(dy + th1*(c3 + th*(c4 + th1*c5)));
+    }
+  }
+
+  const double* DopriIntegrator::checkpointState(double t) {
+    // No steps taken: t0 equals tf
+    if (ck_t_.empty()) return getPtr(fwd_.y);
+
+    // Locate the forward step
+    int nck = ck_t_.size();
+    int i = upper_bound(ck_t_.begin(), ck_t_.end(), t) - ck_t_.begin() - 1;
+    i = std::min(std::max(i, 0), nck-1);
+
+    // Recompute it, starting from the checkpoint
+    if (i!=ck_index_) {
+      ck_.t = ck_t_[i];
+      copy(ck_y_.begin() + i*ck_.n, ck_y_.begin() + (i+1)*ck_.n, ck_.y.begin());
+      eval(ck_, ck_.t, getPtr(ck_.y), getPtr(ck_.k));
+      trialStep(ck_, ck_h_[i]);
+      acceptStep(ck_, ck_h_[i], i+1<nck ? ck_t_[i+1] : fwd_.t);
+      ck_index_ = i;
+    }
+
+    // Interpolate the states
+    interpolate(ck_, t, 0, nx_, getPtr(ck_x_));
+    return getPtr(ck_x_);
+  }
+
+  void DopriIntegrator::reset() {
+    casadi_log("DopriIntegrator::reset begin");
+
+    // Reset the base classes
+    IntegratorInternal::reset();
+
+    // Initial state, quadratures start at zero
+    copy(x0().begin(), x0().end(), fwd_.y.begin());
+    fill(fwd_.y.begin()+nx_, fwd_.y.end(), 0);
+    start(fwd_, t0_, tf_);
+
+    // Clear checkpoints
+    ck_t_.clear();
+    ck_h_.clear();
+    ck_y_.clear();
+    ck_index_ = -1;
+    ck_.nevals = 0;
+
+    casadi_log("DopriIntegrator::reset end");
+  }
+
+  void DopriIntegrator::integrate(double t_out) {
+    casadi_log("DopriIntegrator::integrate(" << t_out << ") begin");
+    casadi_assert_message(t_out<=tf_, "DopriIntegrator::integrate: cannot integrate past tf");
+
+    // Take steps until t_out is inside the last step
+    while (fwd_.t<t_out) {
+      casadi_assert_message(fwd_.nsteps<max_num_steps_, "DopriIntegrator::integrate: "
+                            "maximum number of steps reached at t = " << fwd_.t);
+      step(fwd_);
+
+      // Store checkpoint for the backward problem
+      if (nrx_>0) {
+        ck_t_.push_back(fwd_.t_old);
+        ck_h_.push_back(fwd_.h);
+        ck_y_.insert(ck_y_.end(), fwd_.y_old.begin(), fwd_.y_old.end());
+      }
+    }
+
+    // Interpolate to t_out
+    t_ = t_out;
+    interpolate(fwd_, t_out, 0, nx_, getPtr(xf().data()));
+    interpolate(fwd_, t_out, nx_, nq_, getPtr(qf().data()));
+
+    if (gather_stats_) {
+      stats_["nsteps"] = 1.0*fwd_.nsteps;
+      stats_["nrejected"] = 1.0*fwd_.nrejected;
+      stats_["nfevals"] = 1.0*fwd_.nevals;
+    }
+
+    casadi_log("DopriIntegrator::integrate(" << t_out << ") end");
+  }
+
+  void DopriIntegrator::resetB() {
+    casadi_log("DopriIntegrator::resetB begin");
+    casadi_assert_message(fwd_.t==tf_, "DopriIntegrator::resetB: the forward problem must be "
+                          "integrated to tf first");
+
+    // Reset the base classes
+    IntegratorInternal::resetB();
+
+    // Terminal state, quadratures start at zero
+    copy(rx0().begin(), rx0().end(), bwd_.y.begin());
+    fill(bwd_.y.begin()+nrx_, bwd_.y.end(), 0);
+    start(bwd_, tf_, t0_);
+
+    casadi_log("DopriIntegrator::resetB end");
+  }
+
+  void DopriIntegrator::integrateB(double t_out) {
+    casadi_log("DopriIntegrator::integrateB(" << t_out << ") begin");
+    casadi_assert_message(t_out>=t0_, "DopriIntegrator::integrateB: cannot integrate past t0");
+
+    // Take steps until t_out is inside the last step
+    while (bwd_.t>t_out) {
+      casadi_assert_message(bwd_.nsteps<max_num_steps_, "DopriIntegrator::integrateB: "
+                            "maximum number of steps reached at t = " << bwd_.t);
+      step(bwd_);
+    }
+
+    // Interpolate to t_out
+    t_ = t_out;
+    interpolate(bwd_, t_out, 0, nrx_, getPtr(rxf().data()));
+    interpolate(bwd_, t_out, nrx_, nrq_, getPtr(rqf().data()));
+
+    if (gather_stats_) {
+      stats_["nstepsB"] = 1.0*bwd_.nsteps;
+      stats_["nrejectedB"] = 1.0*bwd_.nrejected;
+      stats_["nfevalsB"] = 1.0*bwd_.nevals;
+      stats_["nfevals_recomputed"] = 1.0*ck_.nevals;
+    }
+
+    casadi_log("DopriIntegrator::integrateB(" << t_out << ") end");
+  }
+
+  void DopriIntegrator::printStats(std::ostream &stream) const {
+    stream << "number of steps taken:                    " << fwd_.nsteps << std::endl;
+    stream << "number of rejected steps:                 " << fwd_.nrejected << std::endl;
+    stream << "number of calls to the DAE function:      " << fwd_.nevals << std::endl;
+    if (nrx_>0) {
+      stream << "number of backward steps taken:           " << bwd_.nsteps << std::endl;
+      stream << "number of rejected backward steps:        " << bwd_.nrejected << std::endl;
+      stream << "number of calls to the backward function: " << bwd_.nevals << std::endl;
+      stream << "number of checkpoints stored:             " << ck_t_.size() << std::endl;
+      stream << "calls to the DAE function to recompute:   " << ck_.nevals << std::endl;
+    }
+    stream << std::endl;
+  }
+
+} // namespace casadi
@@ -0,0 +1,187 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_DOPRI_INTEGRATOR_HPP
+#define CASADI_DOPRI_INTEGRATOR_HPP
+
+#include "casadi/core/function/integrator_internal.hpp"
+#include <casadi/solvers/casadi_integrator_dopri_export.h>
+
+/** \defgroup plugin_Integrator_dopri
+      Adaptive-step explicit Runge-Kutta integrator for ODEs
+
+      Embedded Runge-Kutta pairs with error control on the local error and
+      continuous (dense) output, so that the integrator can be stopped at any
+      point of the time horizon without restricting the step size:
+      the Dormand-Prince 5(4) pair (default) or the Bogacki-Shampine 3(2) pair.
+
+      Adjoint sensitivities are calculated by integrating the backward problem
+      with its own adaptive steps. The forward state is stored at the start of
+      every forward step, and a forward step is recomputed from this checkpoint
+      when the backward integration needs the forward state inside it.
+*/
+/** \pluginsection{Integrator,dopri} */
+
+/// \cond INTERNAL
+namespace casadi {
+
+  /** \brief \pluginbrief{Integrator,dopri}
+
+
+      @copydoc DAE_doc
+      @copydoc plugin_Integrator_dopri
+
+      \author Joel Andersson
+      \date 2014
+  */
+  class CASADI_INTEGRATOR_DOPRI_EXPORT DopriIntegrator : public IntegratorInternal {
+  public:
+
+    /// Constructor
+    explicit DopriIntegrator(const Function& f, const Function& g);
+
+    /// Deep copy data members
+    virtual void deepCopyMembers(std::map<SharedObjectNode*, SharedObject>& already_copied);
+
+    /// Clone
+    virtual DopriIntegrator* clone() const { return new DopriIntegrator(*this);}
+
+    /// Create a new integrator
+    virtual DopriIntegrator* create(const Function& f, const Function& g) const
+    { return new DopriIntegrator(f, g);}
+
+    /** \brief  Create a new integrator */
+    static IntegratorInternal* creator(const Function& f, const Function& g)
+    { return new DopriIntegrator(f, g);}
+
+    /// Destructor
+    virtual ~DopriIntegrator();
+
+    /// Initialize stage
+    virtual void init();
+
+    /// Reset the forward problem and bring the time back to t0
+    virtual void reset();
+
+    /// Integrate until a specified time point
+    virtual void integrate(double t_out);
+
+    /// Reset the backward problem and take time to tf
+    virtual void resetB();
+
+    /// Integrate backward in time until a specified time point
+    virtual void integrateB(double t_out);
+
+    /// Print solver statistics
+    virtual void printStats(std::ostream &stream) const;
+
+    /// A documentation string
+    static const std::string meta_doc;
+
+    /// Integration in one direction of time
+    struct Stepper {
+      /// Backward problem
+      bool backward;
+      /// Number of states, quadratures included, and number of states under error control
+      int n, n_err;
+      /// Tolerances
+      double abstol, reltol;
+      /// End of the time horizon
+      double t_end;
+      /// Current time, start and (signed) size of the last step, size of the next step
+      double t, t_old, h, h_next;
+      /// State at the current time, at the start of the last step and a work vector
+      std::vector<double> y, y_old, y_new;
+      /// Stages of the last step, the last stage is the derivative at the current time
+      std::vector<double> k;
+      /// Statistics
+      int nsteps, nrejected, nevals;
+    };
+
+  protected:
+    /// Derivative of the forward states and quadratures
+    void rhs(double t, const double* y, double* ydot);
+
+    /// Time derivative of the backward states and quadratures
+    void rhsB(double t, const double* ry, double* rydot);
+
+    /// Evaluate the derivative in the direction of a stepper
+    void eval(Stepper& s, double t, const double* y, double* ydot);
+
+    /// Start integrating from the state in s.y
+    void start(Stepper& s, double t, double t_end);
+
+    /// Estimate a suitable size for the first step
+    double initialStep(Stepper& s);
+
+    /// Calculate the stages and the new state of a step, returns the scaled error estimate
+    double trialStep(Stepper& s, double h);
+
+    /// Make the trial step the current step
+    void acceptStep(Stepper& s, double h, double t_new);
+
+    /// Take one step with error control
+    void step(Stepper& s);
+
+    /// Interpolate n components, starting at offset, of the state inside the last step
+    void interpolate(const Stepper& s, double t, int offset, int n, double* y) const;
+
+    /// Forward state at time t, recomputed from the checkpoints
+    const double* checkpointState(double t);
+
+    /// Tableau: number of stages, order of the error estimate
+    int nstages_, order_;
+
+    /// Tableau: nodes, stage coefficients (row major), error and dense output weights
+    std::vector<double> c_, a_, e_, d_;
+
+    /// Options
+    int max_num_steps_;
+    double max_step_size_, initial_step_size_;
+
+    /// Forward and backward integration, recomputation of forward steps
+    Stepper fwd_, bwd_, ck_;
+
+    /// Checkpoints: start and size of each forward step, state at its start
+    std::vector<double> ck_t_, ck_h_, ck_y_;
+
+    /// Forward step held by ck_, -1 if none
+    int ck_index_;
+
+    /// Forward state interpolated for the backward problem
+    std::vector<double> ck_x_;
+
+    /// Memory for evaluating the DAE functions
+    FunctionMemory f_mem_, g_mem_;
+
+    /// Arguments and results of the DAE functions
+    std::vector<const double*> f_arg_, g_arg_;
+    std::vector<double*> f_res_, g_res_;
+  };
+
+} // namespace casadi
+
+/// \endcond
+#endif // CASADI_DOPRI_INTEGRATOR_HPP
@@ -0,0 +1,135 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+      #include "dopri_integrator.hpp"
+      #include <string>
+
+      const std::string casadi::DopriIntegrator::meta_doc=
+      "\n"
+"Adaptive-step explicit Runge-Kutta integrator for ODEs\n"
+"\n"
+"Embedded Runge-Kutta pairs with error control on the local error and\n"
+"continuous (dense) output, so that the integrator can be stopped at any\n"
+"point of the time horizon without restricting the step size: the\n"
+"Dormand-Prince 5(4) pair (default) or the Bogacki-Shampine 3(2) pair.\n"
+"\n"
+"Adjoint sensitivities are calculated by integrating the backward problem\n"
+"with its own adaptive steps. The forward state is stored at the start of\n"
+"every forward step, and a forward step is recomputed from this checkpoint\n"
+"when the backward integration needs the forward state inside it.\n"
+"\n"
+"\n"
+">List of available options\n"
+"\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"|       Id        |      Type       |     Default     |   Description   |\n"
+"+=================+=================+=================+=================+\n"
+"| abstol          | OT_REAL         | 0.000           | Absolute        |\n"
+"|                 |                 |                 | tolerance for   |\n"
+"|                 |                 |                 | the IVP         |\n"
+"|                 |                 |                 | solution        |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| abstolB         | OT_REAL         | GenericType()   | Absolute        |\n"
+"|                 |                 |                 | tolerance for   |\n"
+"|                 |                 |                 | the adjoint     |\n"
+"|                 |                 |                 | sensitivity     |\n"
+"|                 |                 |                 | solution        |\n"
+"|                 |                 |                 | [default: equal |\n"
+"|                 |                 |                 | to abstol]      |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| expand_f        | OT_BOOLEAN      | false           | Expand the DAE  |\n"
+"|                 |                 |                 | functions in    |\n"
+"|                 |                 |                 | scalar          |\n"
+"|                 |                 |                 | operations, if  |\n"
+"|                 |                 |                 | they are        |\n"
+"|                 |                 |                 | MXFunction      |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| initial_step_si | OT_REAL         | 0               | Size of the     |\n"
+"| ze              |                 |                 | first step, 0   |\n"
+"|                 |                 |                 | to estimate it  |\n"
+"|                 |                 |                 | from the        |\n"
+"|                 |                 |                 | derivatives     |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| max_num_steps   | OT_INTEGER      | 10000           | Maximum number  |\n"
+"|                 |                 |                 | of integrator   |\n"
+"|                 |                 |                 | steps           |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| max_step_size   | OT_REAL         | 0               | Maximum step    |\n"
+"|                 |                 |                 | size, 0 for no  |\n"
+"|                 |                 |                 | limit           |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| quad_err_con    | OT_BOOLEAN      | false           | Should the      |\n"
+"|                 |                 |                 | quadratures     |\n"
+"|                 |                 |                 | affect the step |\n"
+"|                 |                 |                 | size control    |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| reltol          | OT_REAL         | 0.000           | Relative        |\n"
+"|                 |                 |                 | tolerance for   |\n"
+"|                 |                 |                 | the IVP         |\n"
+"|                 |                 |                 | solution        |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| reltolB         | OT_REAL         | GenericType()   | Relative        |\n"
+"|                 |                 |                 | tolerance for   |\n"
+"|                 |                 |                 | the adjoint     |\n"
+"|                 |                 |                 | sensitivity     |\n"
+"|                 |                 |                 | solution        |\n"
+"|                 |                 |                 | [default: equal |\n"
+"|                 |                 |                 | to reltol]      |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| tableau         | OT_STRING       | \"dopri5\"        | Embedded        |\n"
+"|                 |                 |                 | Runge-Kutta     |\n"
+"|                 |                 |                 | pair:           |\n"
+"|                 |                 |                 | Dormand-Prince  |\n"
+"|                 |                 |                 | 5(4) or         |\n"
+"|                 |                 |                 | Bogacki-Shampin |\n"
+"|                 |                 |                 | e 3(2)          |\n"
+"|                 |                 |                 | (dopri5|bs3)    |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"\n"
+"\n"
+">List of available stats\n"
+"\n"
+"+--------------------+\n"
+"|         Id         |\n"
+"+====================+\n"
+"| nfevals            |\n"
+"+--------------------+\n"
+"| nfevalsB           |\n"
+"+--------------------+\n"
+"| nfevals_recomputed |\n"
+"+--------------------+\n"
+"| nrejected          |\n"
+"+--------------------+\n"
+"| nrejectedB         |\n"
+"+--------------------+\n"
+"| nsteps             |\n"
+"+--------------------+\n"
+"| nstepsB            |\n"
+"+--------------------+\n"
+"\n"
+"\n"
+"\n"
+"\n"
+;
@@ -109,6 +109,18 @@ namespace casadi {
     Wrapper::evaluate();
   }
 
+  void DpleToLrDple::evalD(const double** arg, double** res, FunctionMemory& mem) {
+    Wrapper::evalD(arg, res, mem);
+  }
+
+  void DpleToLrDple::allocMemory(FunctionMemory& mem) const {
+    Wrapper::allocMemory(mem);
+  }
+
+  bool DpleToLrDple::isReentrant() const {
+    return Wrapper::isReentrant();
+  }
+
   Function DpleToLrDple::getDerivative(int nfwd, int nadj) {
     return f_.derivative(nfwd, nadj);
   }
@@ -108,6 +108,18 @@ namespace casadi {
     Wrapper::evaluate();
   }
 
+  void FixedSmithDleInternal::evalD(const double** arg, double** res, FunctionMemory& mem) {
+    Wrapper::evalD(arg, res, mem);
+  }
+
+  void FixedSmithDleInternal::allocMemory(FunctionMemory& mem) const {
+    Wrapper::allocMemory(mem);
+  }
+
+  bool FixedSmithDleInternal::isReentrant() const {
+    return Wrapper::isReentrant();
+  }
+
   Function FixedSmithDleInternal::getDerivative(int nfwd, int nadj) {
     return f_.derivative(nfwd, nadj);
   }
@@ -121,6 +121,18 @@ namespace casadi {
     Wrapper::evaluate();
   }
 
+  void FixedSmithLrDleInternal::evalD(const double** arg, double** res, FunctionMemory& mem) {
+    Wrapper::evalD(arg, res, mem);
+  }
+
+  void FixedSmithLrDleInternal::allocMemory(FunctionMemory& mem) const {
+    Wrapper::allocMemory(mem);
+  }
+
+  bool FixedSmithLrDleInternal::isReentrant() const {
+    return Wrapper::isReentrant();
+  }
+
   Function FixedSmithLrDleInternal::getDerivative(int nfwd, int nadj) {
     return f_.derivative(nfwd, nadj);
   }
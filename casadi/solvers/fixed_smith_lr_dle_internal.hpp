@@ -80,6 +80,15 @@ namespace casadi {
     /** \brief  evaluate */
     virtual void evaluate();
 
+    /** \brief  Evaluate with caller-owned arguments, results and memory */
+    virtual void evalD(const double** arg, double** res, FunctionMemory& mem);
+
+    /** \brief  Allocate memory for evalD */
+    virtual void allocMemory(FunctionMemory& mem) const;
+
+    /** \brief  Can evalD be called concurrently with different memory objects? */
+    virtual bool isReentrant() const;
+
     /** \brief  Initialize */
     virtual void init();
 
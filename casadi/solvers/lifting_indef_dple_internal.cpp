@@ -154,6 +154,18 @@ namespace casadi {
     Wrapper::evaluate();
   }
 
+  void LiftingIndefDpleInternal::evalD(const double** arg, double** res, FunctionMemory& mem) {
+    Wrapper::evalD(arg, res, mem);
+  }
+
+  void LiftingIndefDpleInternal::allocMemory(FunctionMemory& mem) const {
+    Wrapper::allocMemory(mem);
+  }
+
+  bool LiftingIndefDpleInternal::isReentrant() const {
+    return Wrapper::isReentrant();
+  }
+
   Function LiftingIndefDpleInternal::getDerivative(int nfwd, int nadj) {
     return f_.derivative(nfwd, nadj);
   }
@@ -187,6 +187,18 @@ namespace casadi {
     Wrapper::evaluate();
   }
 
+  void LiftingLrDpleInternal::evalD(const double** arg, double** res, FunctionMemory& mem) {
+    Wrapper::evalD(arg, res, mem);
+  }
+
+  void LiftingLrDpleInternal::allocMemory(FunctionMemory& mem) const {
+    Wrapper::allocMemory(mem);
+  }
+
+  bool LiftingLrDpleInternal::isReentrant() const {
+    return Wrapper::isReentrant();
+  }
+
   Function LiftingLrDpleInternal::getDerivative(int nfwd, int nadj) {
     return f_.derivative(nfwd, nadj);
   }
@@ -110,6 +110,18 @@ namespace casadi {
     Wrapper::evaluate();
   }
 
+  void LrDleToDle::evalD(const double** arg, double** res, FunctionMemory& mem) {
+    Wrapper::evalD(arg, res, mem);
+  }
+
+  void LrDleToDle::allocMemory(FunctionMemory& mem) const {
+    Wrapper::allocMemory(mem);
+  }
+
+  bool LrDleToDle::isReentrant() const {
+    return Wrapper::isReentrant();
+  }
+
   Function LrDleToDle::getDerivative(int nfwd, int nadj) {
     return f_.derivative(nfwd, nadj);
   }
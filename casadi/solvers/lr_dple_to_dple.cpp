@@ -132,6 +132,18 @@ namespace casadi {
     Wrapper::evaluate();
   }
 
+  void LrDpleToDple::evalD(const double** arg, double** res, FunctionMemory& mem) {
+    Wrapper::evalD(arg, res, mem);
+  }
+
+  void LrDpleToDple::allocMemory(FunctionMemory& mem) const {
+    Wrapper::allocMemory(mem);
+  }
+
+  bool LrDpleToDple::isReentrant() const {
+    return Wrapper::isReentrant();
+  }
+
   Function LrDpleToDple::getDerivative(int nfwd, int nadj) {
     return f_.derivative(nfwd, nadj);
   }
@@ -25,7 +25,6 @@
 
 #include "scpgen.hpp"
 #include "casadi/core/core.hpp"
-#include <ctime>
 #include <iomanip>
 #include <fstream>
 #include <cmath>
@@ -137,6 +136,15 @@ namespace casadi {
       casadi_assert(nlp_.output(NL_F).size()==1);
     }
 
+    // Timed phases
+    timer_eval_mat_ = addTimer("eval_mat");
+    timer_eval_res_ = addTimer("eval_res");
+    timer_eval_vec_ = addTimer("eval_vec");
+    timer_eval_exp_ = addTimer("eval_exp");
+    timer_qp_setup_ = addTimer("qp_setup");
+    timer_qp_solve_ = addTimer("qp_solve");
+    timer_linesearch_ = addTimer("linesearch");
+
     // Name the components
     if (hasSetOption("name_x")) {
       name_x_ = getOption("name_x");
@@ -708,9 +716,8 @@ namespace casadi {
       copy(it->init.begin(), it->init.end(), it->opt.begin());
     }
 
-    // Get current time and reset timers
-    double time1 = clock();
-    t_eval_mat_ = t_eval_res_ = t_eval_vec_ = t_eval_exp_ = t_solve_qp_ = 0;
+    // Reset timers
+    resetTimers();
 
     // Initial evaluation of the residual function
     eval_res();
@@ -735,6 +742,9 @@ namespace casadi {
     // MAIN OPTIMZATION LOOP
     while (true) {
 
+      // Time spent since the previous iterate
+      timerIteration();
+
       // Evaluate the vectors in the condensed QP
       eval_vec();
 
@@ -792,9 +802,6 @@ namespace casadi {
       line_search(ls_iter, ls_success);
     }
 
-    double time2 = clock();
-    t_mainloop_ = (time2-time1)/CLOCKS_PER_SEC;
-
     // Store optimal value
     cout << "optimal cost = " << f_ << endl;
 
@@ -805,20 +812,16 @@ namespace casadi {
     output(NLP_SOLVER_LAM_X).set(x_lam_);
     output(NLP_SOLVER_G).set(g_);
 
+    // Save statistics
+    stats_["iter_count"] = iter;
+    timersToStats();
+
     // Write timers
     if (print_time_) {
       cout << endl;
-      cout << "time spent in eval_mat:    " << setw(9) << t_eval_mat_ << " s." << endl;
-      cout << "time spent in eval_res:    " << setw(9) << t_eval_res_ << " s." << endl;
-      cout << "time spent in eval_vec:    " << setw(9) << t_eval_vec_ << " s." << endl;
-      cout << "time spent in eval_exp:    " << setw(9) << t_eval_exp_ << " s." << endl;
-      cout << "time spent in solve_qp:    " << setw(9) << t_solve_qp_ << " s." << endl;
-      cout << "time spent in main loop:   " << setw(9) << t_mainloop_ << " s." << endl;
+      printTimers();
     }
 
-    // Save statistics
-    stats_["iter_count"] = iter;
-
     cout << endl;
   }
 
@@ -910,8 +913,7 @@ namespace casadi {
   }
 
   void Scpgen::eval_mat() {
-    // Get current time
-    double time1 = clock();
+    ScopedTimer timer(this, timer_eval_mat_);
 
     // Pass parameters
     mat_fcn_.setInput(input(NLP_SOLVER_P), mod_p_);
@@ -961,14 +963,10 @@ namespace casadi {
         gL_[cc] += qpA_data[el]*g_lam_[rr];
       }
     }
-
-    double time2 = clock();
-    t_eval_mat_ += (time2-time1)/CLOCKS_PER_SEC;
   }
 
   void Scpgen::eval_res() {
-    // Get current time
-    double time1 = clock();
+    ScopedTimer timer(this, timer_eval_res_);
 
     // Pass parameters
     res_fcn_.setInput(input(NLP_SOLVER_P), res_p_);
@@ -1013,14 +1011,10 @@ namespace casadi {
 
     // Parameter sensitivities
     res_fcn_.getOutput(output(NLP_SOLVER_LAM_P), res_p_d_);
-
-    double time2 = clock();
-    t_eval_res_ += (time2-time1)/CLOCKS_PER_SEC;
   }
 
   void Scpgen::eval_vec() {
-    // Get current time
-    double time1 = clock();
+    ScopedTimer timer(this, timer_eval_vec_);
 
     // Pass current parameter guess
     vec_fcn_.setInput(input(NLP_SOLVER_P), mod_p_);
@@ -1054,9 +1048,6 @@ namespace casadi {
       transform(gf_.begin(), gf_.end(), vec_fcn_.output(vec_gf_).begin(),
                 gf_.begin(), std::minus<double>());
     }
-
-    double time2 = clock();
-    t_eval_vec_ += (time2-time1)/CLOCKS_PER_SEC;
   }
 
   void Scpgen::regularize() {
@@ -1090,10 +1081,8 @@ namespace casadi {
   }
 
   void Scpgen::solve_qp() {
-    // Get current time
-    double time1 = clock();
-
-    // Solve the QP
+    // Pass the QP data
+    startTimer(timer_qp_setup_);
     qp_solver_.setInput(qpH_, QP_SOLVER_H);
     qp_solver_.setInput(gf_, QP_SOLVER_G);
     qp_solver_.setInput(qpA_, QP_SOLVER_A);
@@ -1105,8 +1094,12 @@ namespace casadi {
                    qp_solver_.input(QP_SOLVER_LBA).begin(), std::minus<double>());
     std::transform(g_ub_.begin(), g_ub_.end(), qpB_.begin(),
                    qp_solver_.input(QP_SOLVER_UBA).begin(), std::minus<double>());
+    stopTimer(timer_qp_setup_);
 
+    // Solve the QP
+    startTimer(timer_qp_solve_);
     qp_solver_.evaluate();
+    stopTimer(timer_qp_solve_);
 
     // Condensed primal step
     const DMatrix& du = qp_solver_.output(QP_SOLVER_X);
@@ -1123,12 +1116,11 @@ namespace casadi {
     copy(lam_g_new.begin(), lam_g_new.end(), g_dlam_.begin());
     std::transform(g_dlam_.begin(), g_dlam_.end(), g_lam_.begin(), g_dlam_.begin(),
                    std::minus<double>());
-
-    double time2 = clock();
-    t_solve_qp_ += (time2-time1)/CLOCKS_PER_SEC;
   }
 
   void Scpgen::line_search(int& ls_iter, bool& ls_success) {
+    ScopedTimer timer(this, timer_linesearch_);
+
     // Make sure that we have a decent direction
     if (!gauss_newton_) {
       // Get the curvature in the step direction
@@ -1243,8 +1235,7 @@ namespace casadi {
   }
 
   void Scpgen::eval_exp() {
-    // Get current time
-    double time1 = clock();
+    ScopedTimer timer(this, timer_eval_exp_);
 
     // Pass current parameter guess
     exp_fcn_.setInput(input(NLP_SOLVER_P), mod_p_);
@@ -1281,9 +1272,6 @@ namespace casadi {
         copy(dlam_v.begin(), dlam_v.end(), it->dlam.begin());
       }
     }
-
-    double time2 = clock();
-    t_eval_exp_ += (time2-time1)/CLOCKS_PER_SEC;
   }
 
 
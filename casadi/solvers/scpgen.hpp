@@ -99,8 +99,9 @@ namespace casadi {
     // Evaluate the step expansion
     void eval_exp();
 
-    // Timings
-    double t_eval_mat_, t_eval_res_, t_eval_vec_, t_eval_exp_, t_solve_qp_, t_mainloop_;
+    /// Timed phases, see NlpSolverInternal::addTimer
+    int timer_eval_mat_, timer_eval_res_, timer_eval_vec_, timer_eval_exp_, timer_qp_setup_,
+      timer_qp_solve_, timer_linesearch_;
 
     /// QP solver for the subproblems
     QpSolver qp_solver_;
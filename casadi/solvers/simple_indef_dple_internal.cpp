@@ -126,6 +126,18 @@ namespace casadi {
     Wrapper::evaluate();
   }
 
+  void SimpleIndefDpleInternal::evalD(const double** arg, double** res, FunctionMemory& mem) {
+    Wrapper::evalD(arg, res, mem);
+  }
+
+  void SimpleIndefDpleInternal::allocMemory(FunctionMemory& mem) const {
+    Wrapper::allocMemory(mem);
+  }
+
+  bool SimpleIndefDpleInternal::isReentrant() const {
+    return Wrapper::isReentrant();
+  }
+
   Function SimpleIndefDpleInternal::getDerivative(int nfwd, int nadj) {
     return f_.derivative(nfwd, nadj);
   }
@@ -29,7 +29,6 @@
 #include "casadi/core/function/sx_function.hpp"
 #include "casadi/core/sx/sx_tools.hpp"
 #include "casadi/core/casadi_calculus.hpp"
-#include <ctime>
 #include <iomanip>
 #include <fstream>
 #include <cmath>
@@ -76,7 +75,14 @@ namespace casadi {
     addOption("merit_memory",      OT_INTEGER,      4,
               "Size of memory to store history of merit function values");
     addOption("lbfgs_memory",      OT_INTEGER,     10,
-              "Size of L-BFGS memory.");
+              "Size of L-BFGS memory: each block of the Hessian approximation is restarted "
+              "from a scaled identity after this many curvature pairs. The QP solver needs "
+              "an explicit Hessian, so the blocks are stored and updated densely, O(n^2) "
+              "memory and work per iteration for a block of n variables.");
+    addOption("lbfgs_structure",   OT_STRING,  "dense",
+              "Structure of the limited-memory Hessian approximation: a single dense block, "
+              "or one block per independent group of variables in the exact Hessian sparsity "
+              "(partitioned quasi-Newton).", "dense|block");
     addOption("regularize",        OT_BOOLEAN,  false,
               "Automatic regularization of Lagrange Hessian.");
     addOption("print_header",      OT_BOOLEAN,   true,
@@ -106,12 +112,26 @@ namespace casadi {
     beta_ = getOption("beta");
     merit_memsize_ = getOption("merit_memory");
     lbfgs_memory_ = getOption("lbfgs_memory");
+    casadi_assert_message(lbfgs_memory_>=1, "Sqpmethod::init: lbfgs_memory must be positive");
     tol_pr_ = getOption("tol_pr");
     tol_du_ = getOption("tol_du");
     regularize_ = getOption("regularize");
     exact_hessian_ = getOption("hessian_approximation")=="exact";
     min_step_size_ = getOption("min_step_size");
 
+    // Timed phases
+    timer_eval_f_ = addTimer("eval_f");
+    timer_eval_grad_f_ = addTimer("eval_grad_f");
+    timer_eval_g_ = addTimer("eval_g");
+    timer_eval_jac_g_ = addTimer("eval_jac_g");
+    timer_eval_h_ = addTimer("eval_h");
+    timer_qp_setup_ = addTimer("qp_setup");
+    timer_qp_solve_ = addTimer("qp_solve");
+    timer_linesearch_ = addTimer("linesearch");
+    timer_update_h_ = addTimer("update_h");
+    timer_callback_fun_ = addTimer("callback_fun");
+    timer_callback_prepare_ = addTimer("callback_prepare");
+
     // Get/generate required functions
     gradF();
     jacG();
@@ -119,9 +139,40 @@ namespace casadi {
       hessLag();
     }
 
+    // Blocks of the limited-memory Hessian approximation
+    hblock_.clear();
+    if (!exact_hessian_) {
+      if (getOption("lbfgs_structure")=="block") {
+        // Variables that are not coupled in the exact Hessian get separate blocks
+        Sparsity sp = spHessLag() + Sparsity::diag(nx_);
+        vector<int> index, offset;
+        int nblock = sp.stronglyConnectedComponents(index, offset);
+        hblock_.resize(nblock);
+        for (int b=0; b<nblock; ++b) {
+          hblock_[b] = vector<int>(index.begin()+offset[b], index.begin()+offset[b+1]);
+          sort(hblock_[b].begin(), hblock_[b].end());
+        }
+      } else {
+        hblock_.resize(1, range(nx_));
+      }
+    }
+
     // Allocate a QP solver
-    Sparsity H_sparsity = exact_hessian_ ? hessLag().output().sparsity()
-        : Sparsity::dense(nx_, nx_);
+    Sparsity H_sparsity;
+    if (exact_hessian_) {
+      H_sparsity = hessLag().output().sparsity();
+    } else {
+      vector<int> h_row, h_col;
+      for (int b=0; b<hblock_.size(); ++b) {
+        for (vector<int>::const_iterator j=hblock_[b].begin(); j!=hblock_[b].end(); ++j) {
+          for (vector<int>::const_iterator i=hblock_[b].begin(); i!=hblock_[b].end(); ++i) {
+            h_row.push_back(*i);
+            h_col.push_back(*j);
+          }
+        }
+      }
+      H_sparsity = Sparsity::triplet(nx_, nx_, h_row, h_col);
+    }
     H_sparsity = H_sparsity + Sparsity::diag(nx_);
     Sparsity A_sparsity = jacG().isNull() ? Sparsity::sparse(0, nx_)
         : jacG().output().sparsity();
@@ -174,38 +225,20 @@ namespace casadi {
     // Gradient of the objective
     gf_.resize(nx_);
 
-    // Create Hessian update function
+    // Limited-memory Hessian approximation
     if (!exact_hessian_) {
-      // Create expressions corresponding to Bk, x, x_old, gLag and gLag_old
-      SX Bk = SX::sym("Bk", H_sparsity);
-      SX x = SX::sym("x", input(NLP_SOLVER_X0).sparsity());
-      SX x_old = SX::sym("x", x.sparsity());
-      SX gLag = SX::sym("gLag", x.sparsity());
-      SX gLag_old = SX::sym("gLag_old", x.sparsity());
-
-      SX sk = x - x_old;
-      SX yk = gLag - gLag_old;
-      SX qk = mul(Bk, sk);
-
-      // Calculating theta
-      SX skBksk = inner_prod(sk, qk);
-      SX omega = if_else(inner_prod(yk, sk) < 0.2 * inner_prod(sk, qk),
-                               0.8 * skBksk / (skBksk - inner_prod(sk, yk)),
-                               1);
-      yk = omega * yk + (1 - omega) * qk;
-      SX theta = 1. / inner_prod(sk, yk);
-      SX phi = 1. / inner_prod(qk, sk);
-      SX Bk_new = Bk + theta * mul(yk, yk.T()) - phi * mul(qk, qk.T());
-
-      // Inputs of the BFGS update function
-      vector<SX> bfgs_in(BFGS_NUM_IN);
-      bfgs_in[BFGS_BK] = Bk;
-      bfgs_in[BFGS_X] = x;
-      bfgs_in[BFGS_X_OLD] = x_old;
-      bfgs_in[BFGS_GLAG] = gLag;
-      bfgs_in[BFGS_GLAG_OLD] = gLag_old;
-      bfgs_ = SXFunction(bfgs_in, Bk_new);
-      bfgs_.init();
+      // Locate the entries of each diagonal block in the nonzeros of Bk_
+      hblock_nz_.resize(hblock_.size());
+      for (int b=0; b<hblock_.size(); ++b) {
+        const vector<int>& v = hblock_[b];
+        hblock_nz_[b].resize(v.size()*v.size());
+        for (int j=0; j<v.size(); ++j) {
+          for (int i=0; i<v.size(); ++i) {
+            hblock_nz_[b][i+j*v.size()] = H_sparsity.getNZ(v[i], v[j]);
+          }
+        }
+      }
+      lbfgs_npairs_.resize(hblock_.size());
 
       // Initial Hessian approximation
       B_init_ = DMatrix::eye(nx_);
@@ -218,7 +251,9 @@ namespace casadi {
       if (exact_hessian_) {
         cout << "Using exact Hessian" << endl;
       } else {
-        cout << "Using limited memory BFGS Hessian approximation" << endl;
+        cout << "Using limited memory BFGS Hessian approximation";
+        if (hblock_.size()>1) cout << " with " << hblock_.size() << " diagonal blocks";
+        cout << endl;
       }
       cout << endl;
       cout << "Number of variables:                       " << setw(9) << nx_ << endl;
@@ -258,12 +293,7 @@ namespace casadi {
     copy(input(NLP_SOLVER_LAM_G0).begin(), input(NLP_SOLVER_LAM_G0).end(), mu_.begin());
     copy(input(NLP_SOLVER_LAM_X0).begin(), input(NLP_SOLVER_LAM_X0).end(), mu_x_.begin());
 
-    t_eval_f_ = t_eval_grad_f_ = t_eval_g_ = t_eval_jac_g_ = t_eval_h_ =
-        t_callback_fun_ = t_callback_prepare_ = t_mainloop_ = 0;
-
-    n_eval_f_ = n_eval_grad_f_ = n_eval_g_ = n_eval_jac_g_ = n_eval_h_ = 0;
-
-    double time1 = clock();
+    resetTimers();
 
     // Initial constraint Jacobian
     eval_jac_g(x_, gk_, Jk_);
@@ -328,9 +358,12 @@ namespace casadi {
         static_cast<std::vector<double> &>(iterations["obj"]).push_back(fk_);
       }
 
+      // Time spent since the previous iterate
+      timerIteration();
+
       // Call callback function if present
       if (!callback_.isNull()) {
-        double time1 = clock();
+        startTimer(timer_callback_prepare_);
 
         if (!output(NLP_SOLVER_F).isEmpty()) output(NLP_SOLVER_F).set(fk_);
         if (!output(NLP_SOLVER_X).isEmpty()) output(NLP_SOLVER_X).set(x_);
@@ -347,12 +380,10 @@ namespace casadi {
         iteration["obj"] = fk_;
         stats_["iteration"] = iteration;
 
-        double time2 = clock();
-        t_callback_prepare_ += (time2-time1)/CLOCKS_PER_SEC;
-        time1 = clock();
+        stopTimer(timer_callback_prepare_);
+        startTimer(timer_callback_fun_);
         int ret = callback_(ref_, user_data_);
-        time2 = clock();
-        t_callback_fun_ += (time2-time1)/CLOCKS_PER_SEC;
+        stopTimer(timer_callback_fun_);
         if (ret) {
           cout << endl;
           cout << "casadi::SQPMethod: aborted by callback..." << endl;
@@ -434,6 +465,7 @@ namespace casadi {
       // Line-search
       log("Starting line-search");
       if (max_iter_ls_>0) { // max_iter_ls_== 0 disables line-search
+        ScopedTimer timer(this, timer_linesearch_);
 
         // Line-search loop
         while (true) {
@@ -520,32 +552,8 @@ namespace casadi {
       // Updating Lagrange Hessian
       if (!exact_hessian_) {
         log("Updating Hessian (BFGS)");
-        // BFGS with careful updates and restarts
-        if (iter % lbfgs_memory_ == 0) {
-          // Reset Hessian approximation by dropping all off-diagonal entries
-          const vector<int>& colind = Bk_.colind();      // Access sparsity (column offset)
-          const vector<int>& row = Bk_.row();            // Access sparsity (row)
-          vector<double>& data = Bk_.data();             // Access nonzero elements
-          for (int cc=0; cc<colind.size()-1; ++cc) {     // Loop over the columns of the Hessian
-            for (int el=colind[cc]; el<colind[cc+1]; ++el) {
-              // Loop over the nonzero elements of the column
-              if (cc!=row[el]) data[el] = 0;               // Remove if off-diagonal entries
-            }
-          }
-        }
-
-        // Pass to BFGS update function
-        bfgs_.setInput(Bk_, BFGS_BK);
-        bfgs_.setInput(x_, BFGS_X);
-        bfgs_.setInput(x_old_, BFGS_X_OLD);
-        bfgs_.setInput(gLag_, BFGS_GLAG);
-        bfgs_.setInput(gLag_old_, BFGS_GLAG_OLD);
-
-        // Update the Hessian approximation
-        bfgs_.evaluate();
-
-        // Get the updated Hessian
-        bfgs_.getOutput(Bk_);
+        ScopedTimer timer(this, timer_update_h_);
+        update_lbfgs();
         if (monitored("bfgs")) {
           cout << "x = " << x_ << endl;
           cout << "BFGS = "  << endl;
@@ -558,9 +566,6 @@ namespace casadi {
       }
     }
 
-    double time2 = clock();
-    t_mainloop_ = (time2-time1)/CLOCKS_PER_SEC;
-
     // Save results to outputs
     output(NLP_SOLVER_F).set(fk_);
     output(NLP_SOLVER_X).set(x_);
@@ -568,51 +573,14 @@ namespace casadi {
     output(NLP_SOLVER_LAM_X).set(mu_x_);
     output(NLP_SOLVER_G).set(gk_);
 
-    if (hasOption("print_time") && static_cast<bool>(getOption("print_time"))) {
-      // Write timings
-      cout << "time spent in eval_f: " << t_eval_f_ << " s.";
-      if (n_eval_f_>0)
-        cout << " (" << n_eval_f_ << " calls, " << (t_eval_f_/n_eval_f_)*1000 << " ms. average)";
-      cout << endl;
-      cout << "time spent in eval_grad_f: " << t_eval_grad_f_ << " s.";
-      if (n_eval_grad_f_>0)
-        cout << " (" << n_eval_grad_f_ << " calls, "
-             << (t_eval_grad_f_/n_eval_grad_f_)*1000 << " ms. average)";
-      cout << endl;
-      cout << "time spent in eval_g: " << t_eval_g_ << " s.";
-      if (n_eval_g_>0)
-        cout << " (" << n_eval_g_ << " calls, " << (t_eval_g_/n_eval_g_)*1000 << " ms. average)";
-      cout << endl;
-      cout << "time spent in eval_jac_g: " << t_eval_jac_g_ << " s.";
-      if (n_eval_jac_g_>0)
-        cout << " (" << n_eval_jac_g_ << " calls, "
-             << (t_eval_jac_g_/n_eval_jac_g_)*1000 << " ms. average)";
-      cout << endl;
-      cout << "time spent in eval_h: " << t_eval_h_ << " s.";
-      if (n_eval_h_>1)
-        cout << " (" << n_eval_h_ << " calls, " << (t_eval_h_/n_eval_h_)*1000 << " ms. average)";
-      cout << endl;
-      cout << "time spent in main loop: " << t_mainloop_ << " s." << endl;
-      cout << "time spent in callback function: " << t_callback_fun_ << " s." << endl;
-      cout << "time spent in callback preparation: " << t_callback_prepare_ << " s." << endl;
-    }
-
     // Save statistics
     stats_["iter_count"] = iter;
+    timersToStats();
 
-    stats_["t_eval_f"] = t_eval_f_;
-    stats_["t_eval_grad_f"] = t_eval_grad_f_;
-    stats_["t_eval_g"] = t_eval_g_;
-    stats_["t_eval_jac_g"] = t_eval_jac_g_;
-    stats_["t_eval_h"] = t_eval_h_;
-    stats_["t_mainloop"] = t_mainloop_;
-    stats_["t_callback_fun"] = t_callback_fun_;
-    stats_["t_callback_prepare"] = t_callback_prepare_;
-    stats_["n_eval_f"] = n_eval_f_;
-    stats_["n_eval_grad_f"] = n_eval_grad_f_;
-    stats_["n_eval_g"] = n_eval_g_;
-    stats_["n_eval_jac_g"] = n_eval_jac_g_;
-    stats_["n_eval_h"] = n_eval_h_;
+    if (hasOption("print_time") && static_cast<bool>(getOption("print_time"))) {
+      // Write timings
+      printTimers();
+    }
   }
 
   void Sqpmethod::printIteration(std::ostream &stream) {
@@ -678,6 +646,7 @@ namespace casadi {
     // Initial Hessian approximation of BFGS
     if (!exact_hessian_) {
       Bk_.set(B_init_);
+      fill(lbfgs_npairs_.begin(), lbfgs_npairs_.end(), 0);
     }
 
     if (monitored("eval_h")) {
@@ -687,6 +656,58 @@ namespace casadi {
     }
   }
 
+  void Sqpmethod::update_lbfgs() {
+    for (int b=0; b<hblock_.size(); ++b) {
+      const vector<int>& v = hblock_[b];
+      vector<double> sk(v.size()), yk(v.size());
+      for (int i=0; i<v.size(); ++i) {
+        sk[i] = x_[v[i]] - x_old_[v[i]];
+        yk[i] = gLag_[v[i]] - gLag_old_[v[i]];
+      }
+
+      // Nothing to learn if the block did not move
+      if (inner_prod(sk, sk)==0) continue;
+
+      // Restart from a scaled identity when the memory is full
+      bool restart = lbfgs_npairs_[b]==0 || lbfgs_npairs_[b]>=lbfgs_memory_;
+      if (restart) lbfgs_npairs_[b] = 0;
+      update_lbfgs_block(b, sk, yk, restart);
+      lbfgs_npairs_[b]++;
+    }
+  }
+
+  void Sqpmethod::update_lbfgs_block(int b, const std::vector<double>& s,
+                                     const std::vector<double>& y, bool restart) {
+    const vector<int>& nz = hblock_nz_[b];
+    vector<double>& Bk = Bk_.data();
+    int n = hblock_[b].size();
+
+    // Seed matrix delta*I, scaled with the pair if it has positive curvature
+    if (restart) {
+      double sy = inner_prod(s, y);
+      double yy = inner_prod(y, y);
+      double delta = sy > 1e-8*sqrt(inner_prod(s, s)*yy) ? yy/sy : 1;
+      for (int j=0; j<n; ++j) {
+        for (int i=0; i<n; ++i) Bk[nz[i+j*n]] = i==j ? delta : 0;
+      }
+    }
+
+    // BFGS update with the pair, damped (Powell) against the current block
+    vector<double> q(n, 0), r(n);
+    for (int j=0; j<n; ++j) {
+      for (int i=0; i<n; ++i) q[i] += Bk[nz[i+j*n]]*s[j];
+    }
+    double sBs = inner_prod(s, q);
+    double sy = inner_prod(s, y);
+    double omega = sy < 0.2*sBs ? 0.8*sBs/(sBs - sy) : 1;
+    for (int i=0; i<n; ++i) r[i] = omega*y[i] + (1-omega)*q[i];
+    double sr = inner_prod(s, r);
+    if (sBs <= 0 || sr <= DBL_EPSILON*sBs) return;
+    for (int j=0; j<n; ++j) {
+      for (int i=0; i<n; ++i) Bk[nz[i+j*n]] += r[i]*r[j]/sr - q[i]*q[j]/sBs;
+    }
+  }
+
   double Sqpmethod::getRegularization(const Matrix<double>& H) {
     const vector<int>& colind = H.colind();
     const vector<int>& row = H.row();
@@ -725,6 +746,7 @@ namespace casadi {
 
   void Sqpmethod::eval_h(const std::vector<double>& x, const std::vector<double>& lambda,
                            double sigma, Matrix<double>& H) {
+    ScopedTimer timer(this, timer_eval_h_);
     try {
       // Get function
       Function& hessLag = this->hessLag();
@@ -763,10 +785,9 @@ namespace casadi {
 
   void Sqpmethod::eval_g(const std::vector<double>& x, std::vector<double>& g) {
     try {
-      double time1 = clock();
-
       // Quick return if no constraints
       if (ng_==0) return;
+      ScopedTimer timer(this, timer_eval_g_);
 
       // Pass the argument to the function
       nlp_.setInput(x, NL_X);
@@ -783,10 +804,6 @@ namespace casadi {
         cout << "x = " << nlp_.input(NL_X) << endl;
         cout << "g = " << nlp_.output(NL_G) << endl;
       }
-
-      double time2 = clock();
-      t_eval_g_ += (time2-time1)/CLOCKS_PER_SEC;
-      n_eval_g_ += 1;
     } catch(exception& ex) {
       cerr << "eval_g failed: " << ex.what() << endl;
       throw;
@@ -796,10 +813,9 @@ namespace casadi {
   void Sqpmethod::eval_jac_g(const std::vector<double>& x, std::vector<double>& g,
                                Matrix<double>& J) {
     try {
-      double time1 = clock();
-
       // Quich finish if no constraints
       if (ng_==0) return;
+      ScopedTimer timer(this, timer_eval_jac_g_);
 
       // Get function
       Function& jacG = this->jacG();
@@ -821,11 +837,6 @@ namespace casadi {
         cout << "J = " << endl;
         J.printSparse();
       }
-
-      double time2 = clock();
-      t_eval_jac_g_ += (time2-time1)/CLOCKS_PER_SEC;
-      n_eval_jac_g_ += 1;
-
     } catch(exception& ex) {
       cerr << "eval_jac_g failed: " << ex.what() << endl;
       throw;
@@ -834,9 +845,8 @@ namespace casadi {
 
   void Sqpmethod::eval_grad_f(const std::vector<double>& x, double& f,
                                 std::vector<double>& grad_f) {
+    ScopedTimer timer(this, timer_eval_grad_f_);
     try {
-      double time1 = clock();
-
       // Get function
       Function& gradF = this->gradF();
 
@@ -861,10 +871,6 @@ namespace casadi {
         cout << "x      = " << x << endl;
         cout << "grad_f = " << grad_f << endl;
       }
-      double time2 = clock();
-      t_eval_grad_f_ += (time2-time1)/CLOCKS_PER_SEC;
-      n_eval_grad_f_ += 1;
-
     } catch(exception& ex) {
       cerr << "eval_grad_f failed: " << ex.what() << endl;
       throw;
@@ -872,10 +878,8 @@ namespace casadi {
   }
 
   void Sqpmethod::eval_f(const std::vector<double>& x, double& f) {
+    ScopedTimer timer(this, timer_eval_f_);
     try {
-       // Log time
-      double time1 = clock();
-
       // Pass the argument to the function
       nlp_.setInput(x, NL_X);
       nlp_.setInput(input(NLP_SOLVER_P), NL_P);
@@ -891,10 +895,6 @@ namespace casadi {
         cout << "x = " << nlp_.input(NL_X) << endl;
         cout << "f = " << f << endl;
       }
-      double time2 = clock();
-      t_eval_f_ += (time2-time1)/CLOCKS_PER_SEC;
-      n_eval_f_ += 1;
-
     } catch(exception& ex) {
       cerr << "eval_f failed: " << ex.what() << endl;
       throw;
@@ -907,6 +907,7 @@ namespace casadi {
                              const std::vector<double>& ubA,
                              std::vector<double>& x_opt, std::vector<double>& lambda_x_opt,
                              std::vector<double>& lambda_A_opt) {
+    startTimer(timer_qp_setup_);
 
     // Pass data to QP solver
     qp_solver_.setInput(H, QP_SOLVER_H);
@@ -941,8 +942,12 @@ namespace casadi {
       cout << "ubA = " << ubA << endl;
     }
 
+    stopTimer(timer_qp_setup_);
+
     // Solve the QP
+    startTimer(timer_qp_solve_);
     qp_solver_.evaluate();
+    stopTimer(timer_qp_solve_);
 
     // Get the optimal solution
     qp_solver_.getOutput(x_opt, QP_SOLVER_X);
@@ -110,9 +110,14 @@ namespace casadi {
     /// Gradient of the objective function
     std::vector<double> gf_;
 
-    /// BFGS update function
-    enum BFGSMdoe { BFGS_BK, BFGS_X, BFGS_X_OLD, BFGS_GLAG, BFGS_GLAG_OLD, BFGS_NUM_IN};
-    Function bfgs_;
+    /// Variables of each diagonal block of the limited-memory Hessian approximation
+    std::vector<std::vector<int> > hblock_;
+
+    /// Nonzero of Bk_ for each entry of the (dense, column-major) diagonal blocks
+    std::vector<std::vector<int> > hblock_nz_;
+
+    /// Number of curvature pairs in each block since its last restart
+    std::vector<int> lbfgs_npairs_;
 
     /// Initial Hessian approximation (BFGS)
     DMatrix B_init_;
@@ -145,6 +150,13 @@ namespace casadi {
     // Reset the Hessian or Hessian approximation
     void reset_h();
 
+    /// Add the latest curvature pairs and update the limited-memory Hessian approximation
+    void update_lbfgs();
+
+    /// Damped BFGS update of a diagonal block of Bk_, optionally restarted from a scaled identity
+    void update_lbfgs_block(int b, const std::vector<double>& s, const std::vector<double>& y,
+                            bool restart);
+
     // Evaluate the gradient of the objective
     virtual void eval_f(const std::vector<double>& x, double& f);
 
@@ -185,22 +197,10 @@ namespace casadi {
     /// Calculates <tt>inner_prod(x, mul(A, x))</tt>
     static double quad_form(const std::vector<double>& x, const DMatrix& A);
 
-    // Accumulated time since last reset:
-    double t_eval_f_; // time spent in eval_f
-    double t_eval_grad_f_; // time spent in eval_grad_f
-    double t_eval_g_; // time spent in eval_g
-    double t_eval_jac_g_; // time spent in eval_jac_g
-    double t_eval_h_; // time spent in eval_h
-    double t_callback_fun_;  // time spent in callback function
-    double t_callback_prepare_; // time spent in callback preparation
-    double t_mainloop_; // time spent in the main loop of the solver
-
-    // Accumulated counts since last reset:
-    int n_eval_f_; // number of calls to eval_f
-    int n_eval_grad_f_; // number of calls to eval_grad_f
-    int n_eval_g_; // number of calls to eval_g
-    int n_eval_jac_g_; // number of calls to eval_jac_g
-    int n_eval_h_; // number of calls to eval_h
+    /// Timed phases, see NlpSolverInternal::addTimer
+    int timer_eval_f_, timer_eval_grad_f_, timer_eval_g_, timer_eval_jac_g_, timer_eval_h_,
+      timer_qp_setup_, timer_qp_solve_, timer_linesearch_, timer_update_h_, timer_callback_fun_,
+      timer_callback_prepare_;
 
     /// A documentation string
     static const std::string meta_doc;
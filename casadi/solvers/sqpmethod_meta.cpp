@@ -54,6 +54,23 @@
 "| lbfgs_memory    | OT_INTEGER      | 10              | Size of L-BFGS  |\n"
 "|                 |                 |                 | memory.         |\n"
 "+-----------------+-----------------+-----------------+-----------------+\n"
+"| lbfgs_structure | OT_STRING       | \"dense\"         | Structure of    |\n"
+"|                 |                 |                 | the limited-    |\n"
+"|                 |                 |                 | memory Hessian  |\n"
+"|                 |                 |                 | approximation:  |\n"
+"|                 |                 |                 | a single dense  |\n"
+"|                 |                 |                 | block, or one   |\n"
+"|                 |                 |                 | block per       |\n"
+"|                 |                 |                 | independent     |\n"
+"|                 |                 |                 | group of        |\n"
+"|                 |                 |                 | variables in    |\n"
+"|                 |                 |                 | the exact       |\n"
+"|                 |                 |                 | Hessian         |\n"
+"|                 |                 |                 | sparsity        |\n"
+"|                 |                 |                 | (partitioned    |\n"
+"|                 |                 |                 | quasi-Newton).  |\n"
+"|                 |                 |                 | (dense|block)   |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
 "| max_iter        | OT_INTEGER      | 50              | Maximum number  |\n"
 "|                 |                 |                 | of SQP          |\n"
 "|                 |                 |                 | iterations      |\n"
@@ -29,7 +29,6 @@
 #include "casadi/core/function/sx_function.hpp"
 #include "casadi/core/sx/sx_tools.hpp"
 #include "casadi/core/casadi_calculus.hpp"
-#include <ctime>
 #include <iomanip>
 #include <fstream>
 #include <cmath>
@@ -66,7 +65,7 @@ namespace casadi {
     addOption("max_iter_ls",        OT_INTEGER,      20,
               "Maximum number of linesearch iterations");
     addOption("max_time",          OT_REAL,       1e12,
-              "Timeout");
+              "Timeout (wall-clock seconds)");
     addOption("tol_pr",            OT_REAL,       1e-5,
               "Stopping criterion for primal infeasibility");
     addOption("tol_du",            OT_REAL,       1e-5,
@@ -85,6 +84,8 @@ namespace casadi {
               "Print the header with problem statistics");
     addOption("min_step_size",     OT_REAL,   1e-10,
               "The size (inf-norm) of the step size should not become smaller than this.");
+    addOption("print_time",        OT_BOOLEAN,    false,
+              "Print information about execution time");
 
     // Monitors
     addOption("monitor",      OT_STRINGVECTOR, GenericType(),  "",
@@ -160,6 +161,18 @@ namespace casadi {
     gamma2_ = getOption("gamma2");
     gamma3_ = getOption("gamma3");
 
+    // Timed phases
+    timer_eval_f_ = addTimer("eval_f");
+    timer_eval_grad_f_ = addTimer("eval_grad_f");
+    timer_eval_g_ = addTimer("eval_g");
+    timer_eval_jac_g_ = addTimer("eval_jac_g");
+    timer_eval_h_ = addTimer("eval_h");
+    timer_qp_setup_ = addTimer("qp_setup");
+    timer_qp_solve_ = addTimer("qp_solve");
+    timer_linesearch_ = addTimer("linesearch");
+    timer_update_h_ = addTimer("update_h");
+    timer_callback_fun_ = addTimer("callback_fun");
+
     // Get/generate required functions
     gradF();
     jacG();
@@ -325,6 +338,8 @@ namespace casadi {
     copy(input(NLP_SOLVER_LAM_G0).begin(), input(NLP_SOLVER_LAM_G0).end(), mu_.begin());
     copy(input(NLP_SOLVER_LAM_X0).begin(), input(NLP_SOLVER_LAM_X0).end(), mu_x_.begin());
 
+    resetTimers();
+
     // Initial constraint Jacobian
     eval_jac_g(x_, gk_, Jk_);
 
@@ -376,8 +391,9 @@ namespace casadi {
     double t = 0;
 
     // MAIN OPTIMIZATION LOOP
-    double initial_time = clock();
     while (true) {
+      // Time spent since the previous iterate
+      timerIteration();
 
       // Primal infeasability
       double pr_inf = primalInfeasibility(x_, lbx, ubx, gk_, lbg, ubg);
@@ -409,7 +425,9 @@ namespace casadi {
         if (!output(NLP_SOLVER_LAM_G).isEmpty()) output(NLP_SOLVER_LAM_G).set(mu_);
         if (!output(NLP_SOLVER_LAM_X).isEmpty()) output(NLP_SOLVER_LAM_X).set(mu_x_);
         if (!output(NLP_SOLVER_G).isEmpty()) output(NLP_SOLVER_G).set(gk_);
+        startTimer(timer_callback_fun_);
         int ret = callback_(ref_, user_data_);
+        stopTimer(timer_callback_fun_);
 
         if (!ret) {
           cout << endl;
@@ -506,7 +524,7 @@ namespace casadi {
         break;
       }
 
-      if ((clock()-initial_time)/CLOCKS_PER_SEC > static_cast<double>(getOption("max_time"))) {
+      if (timerElapsed() > static_cast<double>(getOption("max_time"))) {
         cout << endl;
         cout << "casadi::StabilizedSQPMethod: Maximum time (" << getOption("max_time")
              << " sec.) exceeded." << endl;
@@ -660,6 +678,7 @@ namespace casadi {
         log("Starting line-search");
 
         casadi_assert_message(max_iter_ls_ > 0, "max line search iterations should be > 0");
+        ScopedTimer timer(this, timer_linesearch_);
 
         // Line-search loop
         while (true) {
@@ -769,6 +788,7 @@ namespace casadi {
       // Updating Lagrange Hessian
       if (!exact_hessian_) {
         log("Updating Hessian (BFGS)");
+        ScopedTimer timer(this, timer_update_h_);
         // BFGS with careful updates and restarts
         if (iter % lbfgs_memory_ == 0) {
           // Reset Hessian approximation by dropping all off-diagonal entries
@@ -817,6 +837,11 @@ namespace casadi {
 
     // Save statistics
     stats_["iter_count"] = iter;
+    timersToStats();
+
+    if (static_cast<bool>(getOption("print_time"))) {
+      printTimers();
+    }
   }
 
   void StabilizedSqp::printIteration(std::ostream &stream) {
@@ -935,6 +960,7 @@ namespace casadi {
   void StabilizedSqp::eval_h(const std::vector<double>& x,
                                      const std::vector<double>& lambda, double sigma,
                                      Matrix<double>& H) {
+    ScopedTimer timer(this, timer_eval_h_);
     try {
       // Get function
       Function& hessLag = this->hessLag();
@@ -976,6 +1002,7 @@ namespace casadi {
 
       // Quick return if no constraints
       if (ng_==0) return;
+      ScopedTimer timer(this, timer_eval_g_);
 
       // Pass the argument to the function
       nlp_.setInput(x, NL_X);
@@ -1003,6 +1030,7 @@ namespace casadi {
     try {
       // Quich finish if no constraints
       if (ng_==0) return;
+      ScopedTimer timer(this, timer_eval_jac_g_);
 
       // Get function
       Function& jacG = this->jacG();
@@ -1032,6 +1060,7 @@ namespace casadi {
 
   void StabilizedSqp::eval_grad_f(const std::vector<double>& x,
                                           double& f, std::vector<double>& grad_f) {
+    ScopedTimer timer(this, timer_eval_grad_f_);
     try {
       // Get function
       Function& gradF = this->gradF();
@@ -1064,6 +1093,7 @@ namespace casadi {
   }
 
   void StabilizedSqp::eval_f(const std::vector<double>& x, double& f) {
+    ScopedTimer timer(this, timer_eval_f_);
     try {
       // Pass the argument to the function
       nlp_.setInput(x, NL_X);
@@ -1098,6 +1128,7 @@ namespace casadi {
                                        double muR,
                                        const std::vector<double> & mu,
                                        const std::vector<double> & muE) {
+    startTimer(timer_qp_setup_);
 
     // Pass data to QP solver
     stabilized_qp_solver_.setInput(H, STABILIZED_QP_SOLVER_H);
@@ -1135,8 +1166,12 @@ namespace casadi {
       cout << "ubA = " << ubA << endl;
     }
 
+    stopTimer(timer_qp_setup_);
+
     // Solve the QP
+    startTimer(timer_qp_solve_);
     stabilized_qp_solver_.evaluate();
+    stopTimer(timer_qp_solve_);
 
     // Get the optimal solution
     stabilized_qp_solver_.getOutput(x_opt, QP_SOLVER_X);
@@ -232,6 +232,10 @@ namespace casadi {
     /// Calculate 1-norm of a matrix
     double norm1matrix(const DMatrix& A);
 
+    /// Timed phases, see NlpSolverInternal::addTimer
+    int timer_eval_f_, timer_eval_grad_f_, timer_eval_g_, timer_eval_jac_g_, timer_eval_h_,
+      timer_qp_setup_, timer_qp_solve_, timer_linesearch_, timer_update_h_, timer_callback_fun_;
+
     /// A documentation string
     static const std::string meta_doc;
 
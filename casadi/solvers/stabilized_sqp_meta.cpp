@@ -97,7 +97,8 @@
 "|                 |                 |                 | of linesearch   |\n"
 "|                 |                 |                 | iterations      |\n"
 "+-----------------+-----------------+-----------------+-----------------+\n"
-"| max_time        | OT_REAL         | 1.000e+12       | Timeout         |\n"
+"| max_time        | OT_REAL         | 1.000e+12       | Timeout (wall-  |\n"
+"|                 |                 |                 | clock seconds)  |\n"
 "+-----------------+-----------------+-----------------+-----------------+\n"
 "| merit_memory    | OT_INTEGER      | 4               | Size of memory  |\n"
 "|                 |                 |                 | to store        |\n"
@@ -130,6 +131,11 @@
 "|                 |                 |                 | problem         |\n"
 "|                 |                 |                 | statistics      |\n"
 "+-----------------+-----------------+-----------------+-----------------+\n"
+"| print_time      | OT_BOOLEAN      | false           | Print           |\n"
+"|                 |                 |                 | information     |\n"
+"|                 |                 |                 | about execution |\n"
+"|                 |                 |                 | time            |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
 "| regularize      | OT_BOOLEAN      | false           | Automatic       |\n"
 "|                 |                 |                 | regularization  |\n"
 "|                 |                 |                 | of Lagrange     |\n"
@@ -0,0 +1,138 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+/** \brief Batched evaluation of generated C code
+ * Generates code with the option "codegen_batch" and calls the entry point
+ * evaluateBatch(n, x, r), which evaluates n instances of the function in one call.
+ * Nonzero k of instance j of an input or output is stored at x[i][k*n+j]. The results
+ * are compared with evaluating the function itself instance by instance, for an SXFunction
+ * (vectorizable kernel), for the same function with an output that is not requested and
+ * for an MXFunction (generic implementation).
+ *
+ * Usage: codegen_batch [number of instances]
+ */
+
+#include <casadi/casadi.hpp>
+#include <dlfcn.h>
+#include <cstdlib>
+#include <cmath>
+
+using namespace casadi;
+using namespace std;
+
+/// Signature of the batched entry point
+typedef int (*evaluateBatchPtr)(int n, const double** x, double** r);
+
+/// Generate code for f, compile it and compare evaluateBatch with f, returns the largest error
+double check(Function f, const string& name, int n, bool skip_last_output) {
+  // Generate C-code with the batched entry point and compile it to a shared library
+  f.setOption("codegen_batch", true);
+  f.init();
+  f.generateCode(name + ".c");
+  string compile_command = "gcc -fPIC -shared -O3 " + name + ".c -o " + name + ".so -lm";
+  int flag = system(compile_command.c_str());
+  casadi_assert_message(flag==0, "Compilation failed");
+
+  // Load the entry point
+  void* handle = dlopen(("./" + name + ".so").c_str(), RTLD_LAZY);
+  casadi_assert_message(handle!=0, "Cannot open " << name << ".so: " << dlerror());
+  evaluateBatchPtr evaluateBatch = (evaluateBatchPtr)dlsym(handle, "evaluateBatch");
+  casadi_assert_message(evaluateBatch!=0, "Failed to retrieve \"evaluateBatch\" function");
+
+  // Inputs of all instances, instance j has the inputs 0.1*(k+1) + 0.01*j
+  int n_in = f.getNumInputs(), n_out = f.getNumOutputs();
+  vector<vector<double> > x(n_in), r(n_out);
+  vector<const double*> x_ptr(n_in);
+  vector<double*> r_ptr(n_out, static_cast<double*>(0));
+  for (int i=0; i<n_in; ++i) {
+    int nnz = f.input(i).size();
+    x[i].resize(nnz*n);
+    for (int k=0; k<nnz; ++k) {
+      for (int j=0; j<n; ++j) x[i][k*n+j] = 0.1*(k+1) + 0.01*j;
+    }
+    x_ptr[i] = getPtr(x[i]);
+  }
+  for (int i=0; i<n_out; ++i) {
+    r[i].resize(f.output(i).size()*n);
+    if (!(skip_last_output && i==n_out-1)) r_ptr[i] = getPtr(r[i]);
+  }
+
+  // Evaluate all instances in one call
+  flag = evaluateBatch(n, getPtr(x_ptr), getPtr(r_ptr));
+  casadi_assert_message(flag==0, "evaluateBatch failed");
+
+  // Compare with the evaluation instance by instance
+  double err = 0;
+  for (int j=0; j<n; ++j) {
+    for (int i=0; i<n_in; ++i) {
+      vector<double>& in = f.input(i).data();
+      for (int k=0; k<in.size(); ++k) in[k] = x[i][k*n+j];
+    }
+    f.evaluate();
+    for (int i=0; i<n_out; ++i) {
+      if (r_ptr[i]==0) continue;
+      const vector<double>& out = f.output(i).data();
+      for (int k=0; k<out.size(); ++k) err = max(err, fabs(r[i][k*n+j] - out[k]));
+    }
+  }
+  dlclose(handle);
+
+  cout << name << ": " << n << " instances, largest deviation: " << err << endl;
+  return err;
+}
+
+int main(int argc, char* argv[]) {
+  int n = argc>1 ? atoi(argv[1]) : 13;
+
+  // Function with a matrix input, divisions and transcendental functions
+  SX x = SX::sym("x", 2, 2);
+  SX y = SX::sym("y");
+  vector<SX> f_in;
+  f_in.push_back(x);
+  f_in.push_back(y);
+  vector<SX> f_out;
+  f_out.push_back(sqrt(y) - x(0, 1)/(1+y));
+  f_out.push_back(sin(x)*y + exp(-x));
+  SXFunction f(f_in, f_out);
+  f.init();
+
+  // The same function as an MXFunction
+  MX xm = MX::sym("x", 2, 2);
+  MX ym = MX::sym("y");
+  vector<MX> g_in;
+  g_in.push_back(xm);
+  g_in.push_back(ym);
+  MXFunction g(g_in, f.call(g_in));
+  g.init();
+
+  double err = 0;
+  err = max(err, check(f, "f_batch", n, false));
+  err = max(err, check(f, "f_batch_skip", n, true));
+  err = max(err, check(g, "g_batch", n, false));
+  casadi_assert_message(err<1e-12, "evaluateBatch does not match evaluate");
+
+  return 0;
+}
@@ -248,6 +248,18 @@ int main(){
   // Example 3, usage from C++
   usage_cplusplus();
 
+  // Example 4, large functions: split the code into several files compiled in parallel
+  flag = system("mkdir -p f_split");
+  casadi_assert_message(flag==0, "Could not create directory");
+  f.generateCodeSplit("f_split", "f", 4);
+  flag = system("make -C f_split -j4");
+  casadi_assert_message(flag==0, "Compilation failed");
+  ExternalFunction fs("./f_split/f.so");
+  fs.init();
+  fs.setInput(1.5, 1);
+  fs.evaluate();
+  cout << "split result (1): " << fs.output(1) << endl;
+
   return 0;
 }
 
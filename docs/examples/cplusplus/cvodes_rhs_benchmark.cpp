@@ -0,0 +1,107 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+/** \brief Microbenchmark for the cost of the right-hand-side callbacks of CVodes
+ * NOTE: Example is mainly intended for developers of CasADi.
+ * Integrates a small non-stiff ODE (the Lorenz system) over a long horizon, so that the
+ * integration is dominated by the calls to the right-hand side, and compares the time
+ * per call with the time of evaluating the ODE function on its own. The difference is the
+ * overhead of the interface: passing data between CVodes and the function, logging and
+ * timing.
+ *
+ * Usage: cvodes_rhs_benchmark [number of repetitions]
+ */
+
+#include "casadi/casadi.hpp"
+#include <cstdlib>
+#include <ctime>
+
+using namespace casadi;
+using namespace std;
+
+/// CVodes with functional iteration, so that no Jacobians are involved
+Integrator cvodes(const Function& f, bool gather_stats) {
+  Integrator integrator("cvodes", f);
+  integrator.setOption("tf", 100.);
+  integrator.setOption("linear_multistep_method", "adams");
+  integrator.setOption("nonlinear_solver_iteration", "functional");
+  integrator.setOption("max_num_steps", 1000000);
+  integrator.setOption("reltol", 1e-10);
+  integrator.setOption("abstol", 1e-10);
+  integrator.setOption("gather_stats", gather_stats);
+  integrator.init();
+  return integrator;
+}
+
+int main(int argc, char* argv[]) {
+  int n_rep = argc>1 ? atoi(argv[1]) : 20;
+
+  // Lorenz system
+  SX x = SX::sym("x", 3);
+  SX p = SX::sym("p", 3);
+  SX ode = SX::zeros(3);
+  ode[0] = p[0]*(x[1]-x[0]);
+  ode[1] = x[0]*(p[1]-x[2]) - x[1];
+  ode[2] = x[0]*x[1] - p[2]*x[2];
+  SXFunction f(daeIn("x", x, "p", p), daeOut("ode", ode));
+  f.init();
+
+  // Nominal values
+  double x0[] = {1, 1, 1};
+  double p0[] = {10, 28, 8./3};
+
+  // Count the right-hand side calls with an integrator that gathers statistics
+  Integrator counter = cvodes(f, true);
+  counter.setInput(x0, "x0");
+  counter.setInput(p0, "p");
+  counter.evaluate();
+  int n_rhs = counter.getStat("nfevals");
+  n_rhs *= n_rep;
+
+  // Same integrator, but without statistics
+  Integrator integrator = cvodes(f, false);
+  integrator.setInput(x0, "x0");
+  integrator.setInput(p0, "p");
+
+  // Integrate, without statistics
+  clock_t t_start = clock();
+  for (int rep=0; rep<n_rep; ++rep) integrator.evaluate();
+  double t_int = double(clock()-t_start)/CLOCKS_PER_SEC;
+
+  // The same number of evaluations of the ODE function alone
+  f.setInput(x0, "x");
+  f.setInput(p0, "p");
+  t_start = clock();
+  for (int k=0; k<n_rhs; ++k) f.evaluate();
+  double t_f = double(clock()-t_start)/CLOCKS_PER_SEC;
+
+  cout << "right-hand side calls:           " << n_rhs << endl;
+  cout << "integration:                     " << t_int << " s" << endl;
+  cout << "time per right-hand side call:   " << 1e9*t_int/n_rhs << " ns" << endl;
+  cout << "time per function evaluation:    " << 1e9*t_f/n_rhs << " ns" << endl;
+  cout << "xf: " << integrator.output("xf") << endl;
+  return 0;
+}
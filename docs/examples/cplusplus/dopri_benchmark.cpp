@@ -0,0 +1,183 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+/** \brief Benchmark of the adaptive-step Runge-Kutta integrator against CVodes
+ * NOTE: Example is mainly intended for developers of CasADi.
+ * Integrates three non-stiff test problems (Lorenz system, Arenstorf orbit, Van der Pol
+ * oscillator with a small parameter) with "dopri" (both tableaus) and with "cvodes"
+ * (Adams with functional iteration, and BDF with Newton iteration) for a range of
+ * tolerances. For each run, the time per integration, the number of calls to the ODE
+ * function and the error in the final state, compared with a CVodes solution at a
+ * tolerance of 1e-13, are printed.
+ *
+ * Usage: dopri_benchmark [number of repetitions]
+ */
+
+#include "casadi/casadi.hpp"
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+
+using namespace casadi;
+using namespace std;
+
+/// A test problem
+struct Problem {
+  string name;
+  SXFunction f;
+  vector<double> x0;
+  double tf;
+};
+
+/// Integrator with given tolerances
+Integrator integrator(const string& solver, const Dictionary& opts, const Problem& prob,
+                      double tol) {
+  Integrator I(solver, prob.f);
+  I.setOption(opts);
+  I.setOption("tf", prob.tf);
+  I.setOption("abstol", tol);
+  I.setOption("reltol", tol);
+  I.setOption("max_num_steps", 1000000);
+  I.init();
+  I.setInput(prob.x0, "x0");
+  return I;
+}
+
+int main(int argc, char* argv[]) {
+  int n_rep = argc>1 ? atoi(argv[1]) : 20;
+  vector<Problem> problems;
+
+  // Lorenz system
+  {
+    Problem prob;
+    prob.name = "lorenz";
+    SX x = SX::sym("x", 3);
+    SX ode = SX::zeros(3);
+    ode[0] = 10*(x[1]-x[0]);
+    ode[1] = x[0]*(28-x[2]) - x[1];
+    ode[2] = x[0]*x[1] - 8./3*x[2];
+    prob.f = SXFunction(daeIn("x", x), daeOut("ode", ode));
+    prob.x0 = vector<double>(3, 1);
+    prob.tf = 10;
+    problems.push_back(prob);
+  }
+
+  // Arenstorf orbit, one period of a satellite in the earth-moon system
+  {
+    Problem prob;
+    prob.name = "arenstorf";
+    SX x = SX::sym("x", 4);
+    double mu = 0.012277471, mu1 = 1-mu;
+    SX r1 = (x[0]+mu)*(x[0]+mu) + x[1]*x[1];
+    SX r2 = (x[0]-mu1)*(x[0]-mu1) + x[1]*x[1];
+    SX d1 = r1*sqrt(r1);
+    SX d2 = r2*sqrt(r2);
+    SX ode = SX::zeros(4);
+    ode[0] = x[2];
+    ode[1] = x[3];
+    ode[2] = x[0] + 2*x[3] - mu1*(x[0]+mu)/d1 - mu*(x[0]-mu1)/d2;
+    ode[3] = x[1] - 2*x[2] - mu1*x[1]/d1 - mu*x[1]/d2;
+    prob.f = SXFunction(daeIn("x", x), daeOut("ode", ode));
+    double x0[] = {0.994, 0, 0, -2.00158510637908252240537862224};
+    prob.x0 = vector<double>(x0, x0+4);
+    prob.tf = 17.0652165601579625588917206249;
+    problems.push_back(prob);
+  }
+
+  // Van der Pol oscillator, non-stiff
+  {
+    Problem prob;
+    prob.name = "vanderpol";
+    SX x = SX::sym("x", 2);
+    SX ode = SX::zeros(2);
+    ode[0] = x[1];
+    ode[1] = (1-x[0]*x[0])*x[1] - x[0];
+    prob.f = SXFunction(daeIn("x", x), daeOut("ode", ode));
+    double x0[] = {2, 0};
+    prob.x0 = vector<double>(x0, x0+2);
+    prob.tf = 20;
+    problems.push_back(prob);
+  }
+
+  // Integrators to compare
+  vector<string> solver;
+  vector<Dictionary> opts;
+  solver.push_back("dopri");
+  opts.push_back(Dictionary());
+  opts.back()["tableau"] = "dopri5";
+  solver.push_back("dopri");
+  opts.push_back(Dictionary());
+  opts.back()["tableau"] = "bs3";
+  solver.push_back("cvodes");
+  opts.push_back(Dictionary());
+  opts.back()["linear_multistep_method"] = "adams";
+  opts.back()["nonlinear_solver_iteration"] = "functional";
+  solver.push_back("cvodes");
+  opts.push_back(Dictionary());
+  opts.back()["linear_multistep_method"] = "bdf";
+  opts.back()["nonlinear_solver_iteration"] = "newton";
+
+  double tols[] = {1e-4, 1e-6, 1e-8, 1e-10};
+  cout << setw(10) << "problem" << setw(8) << "solver" << setw(8) << "method"
+       << setw(8) << "tol" << setw(12) << "time [ms]" << setw(10) << "nfevals"
+       << setw(12) << "error" << endl;
+  for (int ip=0; ip<problems.size(); ++ip) {
+    Problem& prob = problems[ip];
+    prob.f.init();
+
+    // Reference solution
+    Integrator ref = integrator("cvodes", Dictionary(), prob, 1e-13);
+    ref.evaluate();
+    DMatrix xf_ref = ref.output("xf");
+
+    for (int is=0; is<solver.size(); ++is) {
+      for (int it=0; it<sizeof(tols)/sizeof(double); ++it) {
+        // Count the calls to the ODE function
+        Dictionary opts_stats = opts[is];
+        opts_stats["gather_stats"] = true;
+        Integrator counter = integrator(solver[is], opts_stats, prob, tols[it]);
+        counter.evaluate();
+        int nfevals = counter.getStat("nfevals");
+
+        // Time the integration, without statistics
+        Integrator I = integrator(solver[is], opts[is], prob, tols[it]);
+        clock_t t_start = clock();
+        for (int rep=0; rep<n_rep; ++rep) I.evaluate();
+        double t_int = double(clock()-t_start)/CLOCKS_PER_SEC/n_rep;
+
+        // Error in the final state
+        double err = norm_inf(I.output("xf") - xf_ref).toScalar();
+
+        string method = solver[is]=="dopri" ? opts[is]["tableau"].toString() :
+            opts[is]["linear_multistep_method"].toString();
+        cout << setw(10) << prob.name << setw(8) << solver[is] << setw(8) << method
+             << setw(8) << tols[it] << setw(12) << 1e3*t_int << setw(10) << nfevals
+             << setw(12) << err << endl;
+      }
+    }
+  }
+  return 0;
+}
@@ -36,28 +36,32 @@ using namespace std;
  *  Joel Andersson, K.U. Leuven 2013
  */
 
-Function generateCodeAndCompile(Function fcn, const std::string& name, bool expand){
-  cout << "Generating code for " << name << endl;
-
-  // Convert to an SXFunction (may or may not improve efficiency)
-  if(expand && is_a<MXFunction>(fcn)){
-    fcn = SXFunction(shared_cast<MXFunction>(fcn));
-    fcn.init();
+void generateLibraryAndCompile(vector<Function>& fcn, const vector<string>& names,
+                               const std::string& libname, bool expand){
+  cout << "Generating code for " << libname << endl;
+
+  // Convert to SXFunctions (may or may not improve efficiency)
+  for(int k=0; k<fcn.size(); ++k){
+    if(expand && is_a<MXFunction>(fcn[k])){
+      fcn[k] = SXFunction(shared_cast<MXFunction>(fcn[k]));
+      fcn[k].init();
+    }
   }
 
-  // Generate C code
-  fcn.generateCode(name + ".c");
+  // Generate C code for all functions in one file, sharing sparsity patterns and constants
+  Function::generateLibrary(libname + ".c", fcn, names);
 
   // Compilation command
-  string compile_command = "gcc -fPIC -shared -O3 " + name + ".c -o " + name + ".so";
+  string compile_command = "gcc -fPIC -shared -O3 " + libname + ".c -o " + libname + ".so";
 
   // Compile the c-code
   int flag = system(compile_command.c_str());
   casadi_assert_message(flag==0, "Compilation failed");
 
-  // Load the generated function for evaluation
-  ExternalFunction fcn_e("./" + name + ".so");
-  return fcn_e;
+  // Load the generated functions for evaluation
+  for(int k=0; k<fcn.size(); ++k){
+    fcn[k] = ExternalFunction("./" + libname + ".so", names[k]);
+  }
 }
 
 int main(){
@@ -97,10 +101,21 @@ int main(){
   hess_lag.init();
 
   // Codegen and compile
-  nlp = generateCodeAndCompile(nlp,"nlp", expand);
-  grad_f = generateCodeAndCompile(grad_f,"grad_f", expand);
-  jac_g = generateCodeAndCompile(jac_g,"jac_g", expand);
-  hess_lag = generateCodeAndCompile(hess_lag,"hess_lag", expand);
+  vector<Function> fcn;
+  fcn.push_back(nlp);
+  fcn.push_back(grad_f);
+  fcn.push_back(jac_g);
+  fcn.push_back(hess_lag);
+  vector<string> names;
+  names.push_back("nlp");
+  names.push_back("grad_f");
+  names.push_back("jac_g");
+  names.push_back("hess_lag");
+  generateLibraryAndCompile(fcn, names, "nlp_fcns", expand);
+  nlp = fcn[0];
+  grad_f = fcn[1];
+  jac_g = fcn[2];
+  hess_lag = fcn[3];
 
   // Create an NLP solver passing derivative information
   NlpSolver solver("ipopt", nlp);
@@ -0,0 +1,122 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/** \brief Benchmark of the dense and sparse matrix paths of the qpOASES interface
+ * NOTE: Example is mainly intended for developers of CasADi.
+ * A QP with the structure of a linear MPC problem (banded Hessian, dynamics as equality
+ * constraints coupling consecutive stages) is solved once and then hotstarted with
+ * perturbed data, with the option "sparse" off and on. The solutions are compared.
+ *
+ * Usage: qpoases_sparse_benchmark [number of stages]
+ */
+
+#include "casadi/casadi.hpp"
+#include <cstdlib>
+#include <ctime>
+
+using namespace casadi;
+using namespace std;
+
+int main(int argc, char* argv[]) {
+  // Problem dimensions: nx states and nu controls per stage
+  int N = argc>1 ? atoi(argv[1]) : 50;
+  int nx = 4, nu = 2, nv = N*(nx+nu), nc = (N-1)*nx;
+
+  // Hessian: diagonal plus a coupling between consecutive variables of each stage
+  DMatrix H = DMatrix::zeros(Sparsity::band(nv, 1));
+  for (int i=0; i<nv; ++i) {
+    H(i, i) = 2 + (i%3);
+    if (i+1<nv && (i+1)%(nx+nu)!=0) {
+      H(i, i+1) = 0.5;
+      H(i+1, i) = 0.5;
+    }
+  }
+
+  // Dynamics: x_{k+1} = A x_k + B u_k
+  DMatrix A = DMatrix::zeros(nc, nv);
+  for (int k=0; k+1<N; ++k) {
+    int s = k*(nx+nu), s_next = (k+1)*(nx+nu);
+    for (int i=0; i<nx; ++i) {
+      A(k*nx+i, s_next+i) = -1;
+      A(k*nx+i, s+i) = 0.9;
+      A(k*nx+i, s+(i+1)%nx) = 0.1;
+      A(k*nx+i, s+nx+i%nu) = 0.2;
+    }
+  }
+  A = sparse(A);
+  H = sparse(H);
+  cout << "Variables " << nv << ", constraints " << nc << ", nnz(H) " << H.size()
+       << ", nnz(A) " << A.size() << endl;
+
+  vector<Sparsity> st(2);
+  st[0] = H.sparsity();
+  st[1] = A.sparsity();
+
+  DMatrix x_ref;
+  for (int sparse=0; sparse<2; ++sparse) {
+    QpSolver solver("qpoases", qpStruct("h", st[0], "a", st[1]));
+    solver.setOption("sparse", static_cast<bool>(sparse));
+    solver.setOption("printLevel", "none");
+    solver.init();
+    solver.setInput(H, "h");
+    solver.setInput(A, "a");
+    solver.setInput(-1.0, "lbx");
+    solver.setInput(1.0, "ubx");
+    solver.setInput(0.0, "lba");
+    solver.setInput(0.0, "uba");
+
+    // Initial state fixed by the bounds
+    for (int i=0; i<nx; ++i) {
+      solver.input("lbx").at(i) = solver.input("ubx").at(i) = 0.5;
+    }
+
+    // First solve and hotstarts with a perturbed gradient and Hessian
+    double t_init = 0, t_hot = 0;
+    int n_hot = 10;
+    for (int k=0; k<=n_hot; ++k) {
+      DMatrix g = DMatrix::zeros(nv);
+      for (int i=0; i<nv; ++i) g.at(i) = sin(0.1*i + k);
+      solver.setInput(g, "g");
+      for (int i=0; i<nv; ++i) solver.input("h")(i, i) = 2 + (i%3) + 0.01*k;
+      clock_t t0 = clock();
+      solver.evaluate();
+      double t = static_cast<double>(clock()-t0)/CLOCKS_PER_SEC;
+      if (k==0) {
+        t_init = t;
+      } else {
+        t_hot += t/n_hot;
+      }
+    }
+    cout << (sparse ? "sparse" : "dense ") << ": first solve " << t_init << " s, hotstart "
+         << t_hot << " s" << endl;
+    if (sparse) {
+      double err = norm_inf(solver.output("x") - x_ref).at(0);
+      cout << "Difference in the solution: " << err << endl;
+    } else {
+      x_ref = solver.output("x");
+    }
+  }
+  return 0;
+}
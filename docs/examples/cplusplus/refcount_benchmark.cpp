@@ -0,0 +1,116 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+/** \brief Microbenchmark for the reference counting of symbolic expressions
+ * NOTE: Example is mainly intended for developers of CasADi.
+ * Measures the single-threaded cost of creating, copying and destroying SX expressions
+ * and of creating (cached) sparsity patterns. Compare the timings of a build with
+ * WITH_THREADSAFE_SYMBOLICS=ON with those of a default build to quantify the overhead of
+ * atomic reference counting. In a thread-safe build, the same work is additionally
+ * distributed over several threads.
+ *
+ * Usage: refcount_benchmark [number of repetitions]
+ */
+
+#include "casadi/casadi.hpp"
+#include <cstdlib>
+#include <ctime>
+#ifdef WITH_THREADSAFE_SYMBOLICS
+#include <thread>
+#include <chrono>
+#endif // WITH_THREADSAFE_SYMBOLICS
+
+using namespace casadi;
+using namespace std;
+
+/// Build and destroy an expression graph, returns a checksum
+double build_expressions(int n_rep) {
+  double checksum = 0;
+  for (int rep=0; rep<n_rep; ++rep) {
+    SX x = SX::sym("x", 20);
+    SX f = 0;
+    for (int i=0; i<x.size1(); ++i) {
+      SX t = x[i];
+      for (int k=0; k<10; ++k) t = sin(t)*(k+1.5) + t;
+      f += t;
+    }
+    // Copying the vector of elements exercises the reference counting
+    vector<SXElement> copies(f.data().begin(), f.data().end());
+    checksum += copies.size();
+  }
+  return checksum;
+}
+
+/// Create and destroy sparsity patterns, returns a checksum
+double build_sparsity(int n_rep) {
+  double checksum = 0;
+  for (int rep=0; rep<n_rep; ++rep) {
+    for (int n=2; n<40; ++n) {
+      Sparsity sp = Sparsity::upper(n) + Sparsity::band(n, 1);
+      checksum += sp.size();
+    }
+  }
+  return checksum;
+}
+
+int main(int argc, char* argv[]) {
+  int n_rep = argc>1 ? atoi(argv[1]) : 2000;
+
+#ifdef WITH_THREADSAFE_SYMBOLICS
+  cout << "Thread-safe reference counting: enabled" << endl;
+#else // WITH_THREADSAFE_SYMBOLICS
+  cout << "Thread-safe reference counting: disabled" << endl;
+#endif // WITH_THREADSAFE_SYMBOLICS
+
+  // Single-threaded timings
+  clock_t t_start = clock();
+  double checksum = build_expressions(n_rep);
+  double t_sx = double(clock()-t_start)/CLOCKS_PER_SEC;
+  t_start = clock();
+  checksum += build_sparsity(n_rep);
+  double t_sp = double(clock()-t_start)/CLOCKS_PER_SEC;
+  cout << "SX expressions:    " << t_sx << " s" << endl;
+  cout << "Sparsity patterns: " << t_sp << " s" << endl;
+
+#ifdef WITH_THREADSAFE_SYMBOLICS
+  // Distribute the same work over several threads
+  int n_threads = max(2u, thread::hardware_concurrency());
+  chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+  vector<thread> workers;
+  vector<double> thread_checksum(n_threads);
+  for (int t=0; t<n_threads; ++t) {
+    workers.push_back(thread([&thread_checksum, t, n_rep, n_threads]() {
+      thread_checksum[t] = build_expressions(n_rep/n_threads) + build_sparsity(n_rep/n_threads);
+    }));
+  }
+  for (int t=0; t<n_threads; ++t) workers[t].join();
+  double t_par = chrono::duration<double>(chrono::steady_clock::now()-t0).count();
+  cout << "Both, using " << n_threads << " threads: " << t_par << " s (wall time)" << endl;
+#endif // WITH_THREADSAFE_SYMBOLICS
+
+  cout << "checksum: " << checksum << endl;
+  return 0;
+}
@@ -0,0 +1,190 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+/** \brief Benchmark for the parallel evaluation of a Simulator
+ * NOTE: Example is mainly intended for developers of CasADi.
+ * First, the forward sensitivities of a Simulator with respect to many parameters
+ * (the Lorenz-96 model with one forcing parameter per state) are calculated with the
+ * directions split into batches of the option "num_threads". Second, a long horizon of the
+ * Van der Pol oscillator is simulated with the Parareal iteration, with one time slice per
+ * thread. The wall time is compared with the time for one thread (sensitivities) and with the
+ * sequential simulation (Parareal); the speedup can only be expected on a machine with at least
+ * as many cores as threads. Note that the batches of sensitivity directions are integrated with
+ * separate error control and step sizes, so the timings and results also change with the batch
+ * size. The Parareal iteration needs a few iterations, each integrating all slices with the fine
+ * integrator, so its speedup is bounded by the number of slices over the number of iterations.
+ *
+ * Usage: simulator_parallel_benchmark [maximum number of threads]
+ */
+
+#include "casadi/casadi.hpp"
+#include <cstdlib>
+#include <ctime>
+#include <cmath>
+#ifdef USE_CXX11
+#include <chrono>
+#include <thread>
+#endif // USE_CXX11
+
+using namespace casadi;
+using namespace std;
+
+/// Wall time in seconds (processor time if C++11 is not available)
+double wallTime() {
+#ifdef USE_CXX11
+  return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+#else // USE_CXX11
+  return double(clock())/CLOCKS_PER_SEC;
+#endif // USE_CXX11
+}
+
+/// CVodes with tight tolerances
+Integrator cvodes(const Function& f) {
+  Integrator integrator("cvodes", f);
+  integrator.setOption("abstol", 1e-10);
+  integrator.setOption("reltol", 1e-10);
+  integrator.setOption("max_num_steps", 100000);
+  return integrator;
+}
+
+/// Largest difference between two matrices, relative to the largest entry of the reference
+double maxDiff(const DMatrix& a, const DMatrix& ref) {
+  double ret = 0, ref_max = 0;
+  for (int k=0; k<a.size(); ++k) {
+    ret = max(ret, fabs(a.at(k)-ref.at(k)));
+    ref_max = max(ref_max, fabs(ref.at(k)));
+  }
+  return ref_max>0 ? ret/ref_max : ret;
+}
+
+int main(int argc, char* argv[]) {
+  int max_threads = 4;
+#ifdef USE_CXX11
+  max_threads = max(max_threads, static_cast<int>(thread::hardware_concurrency()));
+#endif // USE_CXX11
+  if (argc>1) max_threads = atoi(argv[1]);
+
+  // Number of threads to compare
+  vector<int> num_threads;
+  for (int n=1; n<=max_threads; n*=2) num_threads.push_back(n);
+  if (num_threads.back()!=max_threads) num_threads.push_back(max_threads);
+
+  // Lorenz-96 model with a forcing parameter for each state
+  int n = 20;
+  SX x = SX::sym("x", n);
+  SX p = SX::sym("p", n);
+  SX ode = SX::zeros(n);
+  for (int i=0; i<n; ++i) {
+    ode[i] = (x[(i+1)%n]-x[(i+n-2)%n])*x[(i+n-1)%n] - x[i] + p[i];
+  }
+  SXFunction f(daeIn("x", x, "p", p), daeOut("ode", ode));
+  f.init();
+
+  // Output grid
+  vector<double> grid;
+  for (int k=0; k<=20; ++k) grid.push_back(0.1*k);
+
+  // Nominal values
+  vector<double> x0(n, 8.), p0(n, 8.);
+  x0[0] = 8.01;
+
+  cout << "Forward sensitivities of a simulator, " << n << " states, " << n << " parameters, "
+       << grid.size() << " grid points" << endl;
+  DMatrix J_ref;
+  double t_ref = 0;
+  for (int k=0; k<num_threads.size(); ++k) {
+    Simulator sim(cvodes(f), grid);
+    sim.setOption("num_threads", num_threads[k]);
+    sim.init();
+    Function J = sim.jacobian("p", 0);
+    J.init();
+    J.setInput(x0, "x0");
+    J.setInput(p0, "p");
+    J.evaluate(); // The first evaluation creates the thread pool
+
+    double t_start = wallTime();
+    J.evaluate();
+    double t = wallTime()-t_start;
+    if (k==0) {
+      J_ref = J.output();
+      t_ref = t;
+    }
+    cout << "  threads: " << num_threads[k] << ", time: " << t << " s, speedup: "
+         << t_ref/t << ", deviation: " << maxDiff(J.output(), J_ref) << endl;
+  }
+
+  // Van der Pol oscillator
+  SX y = SX::sym("y", 2);
+  SX mu = SX::sym("mu");
+  SX vdp = SX::zeros(2);
+  vdp[0] = y[1];
+  vdp[1] = mu*(1-y[0]*y[0])*y[1] - y[0];
+  SXFunction g(daeIn("x", y, "p", mu), daeOut("ode", vdp));
+  g.init();
+
+  // Long horizon
+  vector<double> grid2;
+  for (int k=0; k<=800; ++k) grid2.push_back(0.05*k);
+  double y0[] = {2, 0};
+
+  // Sequential simulation as reference
+  Simulator sim_ref(cvodes(g), grid2);
+  sim_ref.init();
+  sim_ref.setInput(y0, "x0");
+  sim_ref.setInput(1., "p");
+  sim_ref.evaluate();
+  double t_start = wallTime();
+  sim_ref.evaluate();
+  t_ref = wallTime()-t_start;
+
+  cout << "Parareal iteration, " << grid2.size() << " grid points" << endl;
+  cout << "  sequential, time: " << t_ref << " s" << endl;
+  for (int k=0; k<num_threads.size(); ++k) {
+    // Coarse propagator: fixed step Runge-Kutta with a step size of 0.2
+    Dictionary coarse_options;
+    coarse_options["number_of_finite_elements"] = int(ceil(grid2.back()/0.2/num_threads[k]));
+
+    Simulator sim(cvodes(g), grid2);
+    sim.setOption("parareal", true);
+    sim.setOption("num_threads", num_threads[k]);
+    sim.setOption("parareal_tol", 1e-6);
+    sim.setOption("coarse_integrator_options", coarse_options);
+    sim.setOption("gather_stats", true);
+    sim.init();
+    sim.setInput(y0, "x0");
+    sim.setInput(1., "p");
+    sim.evaluate(); // The first evaluation creates the thread pool
+
+    t_start = wallTime();
+    sim.evaluate();
+    double t = wallTime()-t_start;
+    cout << "  threads (and slices): " << num_threads[k] << ", iterations: "
+         << sim.getStat("parareal_iter") << ", time: " << t << " s, speedup: " << t_ref/t
+         << ", deviation: " << maxDiff(sim.output(), sim_ref.output()) << endl;
+  }
+
+  return 0;
+}
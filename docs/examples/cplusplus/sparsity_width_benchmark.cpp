@@ -0,0 +1,81 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+/** \brief Benchmark of the Jacobian sparsity pattern generation for different widths
+ * NOTE: Example is mainly intended for developers of CasADi.
+ * The sparsity pattern of the Jacobian of a large SXFunction is generated with
+ * the option "sparsity_width" set to 64 (one bit vector per sweep, with hierarchical
+ * block structure recognition) and then to larger values (several bit vectors per
+ * sweep). Two structures are tested: a cyclic band and randomly coupled variables.
+ * The patterns are checked to be identical.
+ *
+ * Usage: sparsity_width_benchmark [number of variables]
+ */
+
+#include "casadi/casadi.hpp"
+#include <cstdlib>
+#include <ctime>
+
+using namespace casadi;
+using namespace std;
+
+int main(int argc, char* argv[]) {
+  int n = argc>1 ? atoi(argv[1]) : 20000;
+  SX x = SX::sym("x", n);
+
+  for (int structure=0; structure<2; ++structure) {
+    // Right-hand side
+    srand(1);
+    SX f = SX::zeros(n);
+    for (int i=0; i<n; ++i) {
+      SX xi = x[i];
+      if (structure==0) {
+        SX xn = x[(i+1)%n];
+        f[i] = sin(xi)*xn;
+      } else {
+        SX xa = x[rand()%n], xb = x[rand()%n];
+        f[i] = xi*xa + xb;
+      }
+    }
+    cout << (structure==0 ? "Cyclic band" : "Random coupling") << ", n = " << n << endl;
+
+    // Generate the sparsity pattern for different widths
+    Sparsity ref;
+    int width[] = {64, 256, 512, 1024};
+    for (int k=0; k<4; ++k) {
+      SXFunction F(x, f);
+      F.setOption("sparsity_width", width[k]);
+      F.init();
+      clock_t t0 = clock();
+      Sparsity sp = F.jacSparsity();
+      double t = static_cast<double>(clock()-t0)/CLOCKS_PER_SEC;
+      if (k==0) ref = sp;
+      cout << "  width " << width[k] << ": " << t << " s" << endl;
+      casadi_assert_message(sp==ref, "Sparsity patterns differ");
+    }
+  }
+  return 0;
+}
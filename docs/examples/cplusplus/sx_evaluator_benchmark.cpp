@@ -0,0 +1,133 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+/** \brief Microbenchmark comparing the numeric evaluation engines of SXFunction
+ * NOTE: Example is mainly intended for developers of CasADi.
+ * A small, MPC-sized right-hand side is evaluated repeatedly, first with the
+ * default switch-based interpreter and then with the threaded bytecode interpreter
+ * (option "evaluator"). The outputs of the two engines are checked to be bit-identical.
+ * Finally, the same number of distinct points is evaluated with evaluateBatch and
+ * compared with point-by-point evaluation.
+ *
+ * Usage: sx_evaluator_benchmark [number of evaluations]
+ */
+
+#include "casadi/casadi.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+using namespace casadi;
+using namespace std;
+
+int main(int argc, char* argv[]) {
+  int n_eval = argc>1 ? atoi(argv[1]) : 1000000;
+
+  // Dynamics of a chain of pendulums, with a mix of elementary operations
+  const int n = 6;
+  SX x = SX::sym("x", 2*n);
+  SX u = SX::sym("u", n);
+  SX ode = SX::zeros(2*n);
+  for (int i=0; i<n; ++i) {
+    SX th = x[i], om = x[n+i];
+    SX coupling = i>0 ? 0.3*sin(th - x[i-1]) : SX(0);
+    ode[i] = om;
+    ode[n+i] = -9.81*sin(th) - 0.1*om + coupling + u[i]/(1+th*th) + 2.*sqrt(1+om*om);
+  }
+  vector<SX> f_in;
+  f_in.push_back(x);
+  f_in.push_back(u);
+
+  // Numerical values of the inputs
+  vector<double> x0(2*n), u0(n);
+  for (int i=0; i<2*n; ++i) x0[i] = 0.1*i - 0.4;
+  for (int i=0; i<n; ++i) u0[i] = 0.05*i;
+
+  const char* engines[] = {"switch", "threaded"};
+  vector<double> res[2];
+  double t_engine[2];
+  for (int k=0; k<2; ++k) {
+    SXFunction f(f_in, ode);
+    f.setOption("evaluator", engines[k]);
+    f.init();
+    f.setInput(x0, 0);
+    f.setInput(u0, 1);
+
+    clock_t t_start = clock();
+    for (int i=0; i<n_eval; ++i) {
+      f.evaluate();
+    }
+    t_engine[k] = double(clock() - t_start)/CLOCKS_PER_SEC;
+    res[k] = f.output().data();
+
+    cout << engines[k] << ": " << f.getAlgorithmSize() << " operations, "
+         << 1e9*t_engine[k]/n_eval << " ns per evaluation" << endl;
+  }
+
+  // The engines must agree to the last bit
+  bool identical = memcmp(getPtr(res[0]), getPtr(res[1]), res[0].size()*sizeof(double))==0;
+  cout << "speedup: " << t_engine[0]/t_engine[1] << ", results "
+       << (identical ? "bit-identical" : "DIFFER") << endl;
+
+  // Distinct points, stacked horizontally
+  const int n_batch = 1000;
+  DMatrix x_batch = repmat(DMatrix(x0), 1, n_batch);
+  DMatrix u_batch = repmat(DMatrix(u0), 1, n_batch);
+  for (int k=0; k<x_batch.size(); ++k) x_batch.at(k) += 1e-4*k;
+
+  SXFunction f(f_in, ode);
+  f.init();
+
+  // Point by point
+  vector<double> res_scalar(n_batch*f.output().size());
+  clock_t t_start = clock();
+  for (int i=0; i<n_eval/n_batch; ++i) {
+    for (int k=0; k<n_batch; ++k) {
+      f.setInput(&x_batch.at(k*2*n), 0);
+      f.setInput(&u_batch.at(k*n), 1);
+      f.evaluate();
+      f.getOutput(&res_scalar.at(k*2*n));
+    }
+  }
+  double t_scalar = double(clock() - t_start)/CLOCKS_PER_SEC;
+
+  // Batched, using the low-level API to avoid allocating the outputs for every call
+  vector<double> res_batch(res_scalar.size());
+  const double* arg_ptr[] = {getPtr(x_batch.data()), getPtr(u_batch.data())};
+  double* res_ptr[] = {getPtr(res_batch)};
+  t_start = clock();
+  for (int i=0; i<n_eval/n_batch; ++i) {
+    f.evaluateBatch(n_batch, arg_ptr, res_ptr);
+  }
+  double t_batch = double(clock() - t_start)/CLOCKS_PER_SEC;
+
+  bool batch_identical = memcmp(getPtr(res_scalar), getPtr(res_batch),
+                                res_scalar.size()*sizeof(double))==0;
+  cout << "batch: " << 1e9*t_batch/n_eval << " ns per point, speedup: "
+       << t_scalar/t_batch << ", results "
+       << (batch_identical ? "bit-identical" : "DIFFER") << endl;
+  return identical && batch_identical ? 0 : 1;
+}
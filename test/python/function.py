@@ -129,7 +129,7 @@ class Functiontests(casadiTestCase):
     
     #! Evaluate this function ten times in parallel
     pp = Parallelizer([f]*2)
-    for mode in ["serial","openmp"]:
+    for mode in ["serial","openmp","threadpool","process"]:
       pp.setOption("parallelization",mode)
       pp.init()
       
@@ -154,7 +154,36 @@ class Functiontests(casadiTestCase):
 
       self.checkarray(sin(n1)+N1,p.getOutput(0),"output")
       self.checkarray(sin(n2)+N2,p.getOutput(1),"output")
-          
+
+  def test_ParallelizerProcessFailure(self):
+    self.message("Parallelizer: recovery of the worker processes after a failure")
+    import os
+
+    # Terminates the worker process for a negative input, fails for a large input
+    @pyfunction([Sparsity.dense(1,1)], [Sparsity.dense(1,1)])
+    def Fun((x,)):
+      if x<0: os._exit(1)
+      if x>100: raise Exception("input too large")
+      return [2*x]
+    Fun.init()
+
+    pp = Parallelizer([Fun]*4)
+    pp.setOption("parallelization","process")
+    pp.setOption("num_threads",2)
+    pp.init()
+
+    for failing in [[1,-2,3,4],[1,2,300,4]]:
+      for i in range(4):
+        pp.setInput(failing[i],i)
+      self.assertRaises(Exception,lambda : pp.evaluate())
+
+      # The next evaluation is not affected by the tasks that were left with the workers
+      for i in range(4):
+        pp.setInput(10+i,i)
+      pp.evaluate()
+      for i in range(4):
+        self.checkarray(pp.getOutput(i),DMatrix(2*(10+i)),"output")
+
   def test_ParallelizerMXCall(self):
     self.message("MX parallel call")
     x = MX.sym("x",2)
@@ -187,6 +216,34 @@ class Functiontests(casadiTestCase):
     self.checkarray(sin(n1)+N1,p.getOutput(0),"output")
     self.checkarray(sin(n2)+N2,p.getOutput(1),"output")
 
+  def test_isReentrant(self):
+    self.message("re-entrant evaluation")
+    x = SX.sym("x",2)
+    f = SXFunction([x],[sin(x)])
+    f.init()
+    self.assertTrue(f.isReentrant())
+
+    X = MX.sym("x",2)
+    g = MXFunction([X],[f.call([X])[0]*2])
+    g.init()
+    self.assertTrue(g.isReentrant())
+
+    A = MX.sym("A",2,2)
+    h = MXFunction([A,X],[solve(A,X)])
+    h.init()
+    self.assertFalse(h.isReentrant())
+
+    # A Parallelizer over re-entrant functions shares a single instance between the tasks
+    pp = Parallelizer([g]*2)
+    for mode in ["serial","openmp","threadpool","process"]:
+      pp.setOption("parallelization",mode)
+      pp.init()
+      pp.setInput([1,2],0)
+      pp.setInput([3,4],1)
+      pp.evaluate()
+      self.checkarray(sin(DMatrix([1,2]))*2,pp.getOutput(0),"output")
+      self.checkarray(sin(DMatrix([3,4]))*2,pp.getOutput(1),"output")
+
   def test_set_wrong(self):
     self.message("setter, wrong sparsity")
     x = SX.sym("x")
@@ -226,6 +283,103 @@ class Functiontests(casadiTestCase):
     self.assertEqual(g.getNumInputs(),f.getNumInputs())
     self.assertEqual(g.getNumOutputs(),f.getNumOutputs()+1)
 
+  def test_jacobian_num_threads(self):
+    self.message("Jacobian with color groups evaluated in parallel")
+    x = SX.sym("x",6)
+    f = SXFunction([x],[vertcat([x[i]*x[i+1]**2 for i in range(5)]+[sin(x[0])])])
+    f.init()
+
+    X = MX.sym("x",6)
+    r = []
+    for nt in [1,3]:
+      F = f.call([X])[0]
+      g = MXFunction([X],[F,sumAll(F)])
+      g.setOption("jacobian_num_threads",nt)
+      g.init()
+      J = g.jacobian(0,0)
+      J.init()
+      J.setInput(range(1,7))
+      J.evaluate()
+      H = g.hessian(0,1)
+      H.init()
+      H.setInput(range(1,7))
+      H.evaluate()
+      r.append((J.getOutput(),H.getOutput()))
+    self.checkarray(r[0][0],r[1][0],"jacobian")
+    self.checkarray(r[0][1],r[1][1],"hessian")
+    self.assertTrue(r[0][0].sparsity()==r[1][0].sparsity())
+
+  def test_sparsity_cache(self):
+    self.message("on-disk cache of Jacobian sparsity patterns and colorings")
+    import tempfile, shutil, os
+    d = tempfile.mkdtemp()
+    try:
+      x = SX.sym("x",10)
+      r = []
+      for k in range(2):
+        f = SXFunction([x],[vertcat([x[i]*x[i+1]**2 for i in range(9)]+[sin(x[0])])])
+        f.setOption("sparsity_cache",d)
+        f.init()
+        J = f.jacobian()
+        J.init()
+        J.setInput(range(1,11))
+        J.evaluate()
+        r.append(J.getOutput())
+        if k==0: self.assertTrue(len(os.listdir(d))>0)
+      self.checkarray(r[0],r[1],"jacobian")
+      self.assertTrue(r[0].sparsity()==r[1].sparsity())
+    finally:
+      shutil.rmtree(d)
+
+  def test_sparsity_cache_collision(self):
+    self.message("sparsity cache entries of another function are rejected")
+    import tempfile, shutil, os
+    x = SX.sym("x",10)
+    fexpr = vertcat([x[i]*x[i+1]**2 for i in range(9)]+[sin(x[0])])
+    gexpr = vertcat([x[i]*x[(i+2)%10]**2 for i in range(9)]+[sin(x[0])])
+    d = [tempfile.mkdtemp() for k in range(2)]
+    try:
+      def jac(e,cache):
+        f = SXFunction([x],[e])
+        if cache is not None: f.setOption("sparsity_cache",cache)
+        f.init()
+        J = f.jacobian()
+        J.init()
+        return J.output().sparsity()
+      ref = jac(fexpr,None)
+      jac(fexpr,d[0])
+      jac(gexpr,d[1])
+
+      # Overwrite the entries of f with those of g, keeping the keys of f (bytes 16 to 24)
+      def files(dd):
+        return sorted([os.path.join(dd,n) for n in os.listdir(dd)], key=os.path.getsize)
+      ff, gf = files(d[0]), files(d[1])
+      self.assertEqual(len(ff),len(gf))
+      for fn, gn in zip(ff,gf):
+        key = open(fn,"rb").read()[16:24]
+        data = open(gn,"rb").read()
+        open(fn,"wb").write(data[:16]+key+data[24:])
+      self.assertTrue(jac(fexpr,d[0])==ref)
+    finally:
+      for dd in d: shutil.rmtree(dd)
+
+  def test_sparsity_width(self):
+    self.message("Jacobian sparsity with several bit vectors per sweep")
+    x = SX.sym("x",300)
+    y = SX.sym("y",7)
+    f = vertcat([x[(7*i)%300]*x[(11*i)%300]+sin(y[i%7]) for i in range(500)])
+    for ad_mode in ["forward","reverse","automatic"]:
+      for ii in range(2):
+        F0 = SXFunction([y,x],[f,sumAll(x)])
+        F0.setOption("ad_mode",ad_mode)
+        F0.init()
+        F1 = SXFunction([y,x],[f,sumAll(x)])
+        F1.setOption("ad_mode",ad_mode)
+        F1.setOption("sparsity_width",300)
+        F1.init()
+        for oi in range(2):
+          self.assertTrue(F0.jacSparsity(ii,oi)==F1.jacSparsity(ii,oi))
+
   def test_xfunction(self):
     x = SX.sym("x",3,1)
     y = SX.sym("y",2,1)
@@ -1166,6 +1320,98 @@ class Functiontests(casadiTestCase):
 
     self.checkarray(f(x=0.3)[0],DMatrix(0.09))
     
+  def test_jit(self):
+    x = SX.sym("x",3)
+    f = SXFunction([x],[sin(x)*x[0]+2])
+    f.init()
+
+    import tempfile, os, shutil
+    cache = tempfile.mkdtemp()
+    try:
+      g = SXFunction([x],[sin(x)*x[0]+2])
+      g.setOption("jit",True)
+      g.setOption("jit_cache",cache)
+      g.init()
+
+      for fun in [f,g]:
+        fun.setInput([0.3,1.2,-2])
+        fun.evaluate()
+      self.checkarray(f.getOutput(),g.getOutput())
+      self.assertEqual(len([n for n in os.listdir(cache) if n.endswith(".c")]),1)
+    finally:
+      shutil.rmtree(cache)
+
+  def test_jit_stale(self):
+    self.message("a cached library whose source differs is not reused")
+    x = SX.sym("x",3)
+    import tempfile, os, shutil
+    cache = [tempfile.mkdtemp() for k in range(2)]
+    try:
+      def jit(e,d):
+        f = SXFunction([x],[e])
+        f.setOption("jit",True)
+        f.setOption("jit_cache",d)
+        f.init()
+        f.setInput([0.3,1.2,-2])
+        f.evaluate()
+        return f.getOutput()
+      jit(sin(x)*x[0]+2,cache[0])
+      jit(cos(x)*x[1],cache[1])
+
+      # Put the library and source of the second function under the name of the first
+      name = [n[:-3] for n in os.listdir(cache[0]) if n.endswith(".so")][0]
+      other = [n[:-3] for n in os.listdir(cache[1]) if n.endswith(".so")][0]
+      for ext in [".so",".c"]:
+        shutil.copy(os.path.join(cache[1],other+ext),os.path.join(cache[0],name+ext))
+      self.checkarray(jit(sin(x)*x[0]+2,cache[0]),sin(DMatrix([0.3,1.2,-2]))*0.3+2)
+    finally:
+      for d in cache: shutil.rmtree(d)
+
+  def test_generateLibrary(self):
+    x = SX.sym("x",2)
+    p = SX.sym("p")
+    f = SXFunction([x,p],[sin(x)*p,mul(x.T,x)+p])
+    f.init()
+    g = SXFunction([x],[sin(x)+cos(x)*x])
+    g.init()
+
+    import tempfile, os, shutil, subprocess
+    tmpdir = tempfile.mkdtemp()
+    try:
+      cfile = os.path.join(tmpdir,"fg.c")
+      bfile = os.path.join(tmpdir,"fg.so")
+      Function.generateLibrary(cfile,[f,g],["f","g"],"fg")
+      self.assertEqual(subprocess.call(["gcc","-fPIC","-shared","-O2",cfile,"-o",bfile,"-lm"]),0)
+
+      fe = ExternalFunction(bfile,"f")
+      ge = ExternalFunction(bfile,"g")
+      fge = ExternalFunction(bfile,"fg")
+      for fun in [fe,ge,fge]:
+        fun.init()
+
+      # The fused function has the inputs x and p once, and the outputs of f and g
+      self.assertEqual(fge.getNumInputs(),2)
+      self.assertEqual(fge.getNumOutputs(),3)
+
+      for fun in [f,g,fe,ge,fge]:
+        fun.setInput([0.3,-1.2],0)
+      for fun in [f,fe,fge]:
+        fun.setInput(0.7,1)
+      for fun in [f,g,fe,ge,fge]:
+        fun.evaluate()
+
+      for i in range(2):
+        self.checkarray(f.getOutput(i),fe.getOutput(i))
+        self.checkarray(f.getOutput(i),fge.getOutput(i))
+      self.checkarray(g.getOutput(),ge.getOutput())
+      self.checkarray(g.getOutput(),fge.getOutput(2))
+
+      # Names that are not C identifiers are rejected
+      self.assertRaises(Exception,lambda : Function.generateLibrary(cfile,[f],["1f"]))
+      self.assertRaises(Exception,lambda : Function.generateLibrary(cfile,[f,g],["f","f"]))
+    finally:
+      shutil.rmtree(tmpdir)
+
 if __name__ == '__main__':
     unittest.main()
 
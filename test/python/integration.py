@@ -62,6 +62,7 @@ except:
   pass
 
 integrators.append(("rk",["ode"],{"number_of_finite_elements": 1000}))
+integrators.append(("dopri",["ode"],{"abstol": 1e-12,"reltol":1e-12}))
 
 print "Will test these integrators:"
 for cl, t, options in integrators:
@@ -257,6 +258,8 @@ class Integrationtests(casadiTestCase):
               if "banded" in allowedOpts:
                   yield {"linear_solver_type" +post: "banded" }
               yield {"linear_solver_type" +post: "user_defined", "linear_solver"+post: "csparse" }
+              if "sparse" in allowedOpts:
+                  yield {"linear_solver_type" +post: "sparse" }
                 
             for a_options in solveroptions("B"):
               for f_options in solveroptions():
@@ -372,6 +375,8 @@ class Integrationtests(casadiTestCase):
             if "banded" in allowedOpts:
                 yield {"linear_solver_type" +post: "banded" }
             yield {"linear_solver_type" +post: "user_defined", "linear_solver"+post: "csparse" }
+            if "sparse" in allowedOpts:
+                yield {"linear_solver_type" +post: "sparse" }
               
           for a_options in solveroptions("B"):
             for f_options in solveroptions():
@@ -730,8 +735,26 @@ class Integrationtests(casadiTestCase):
     p=num['p']
 
     self.assertAlmostEqual(integrator.getOutput()[0],q0*exp((tend**3-0.7**3)/(3*p)),9,"Evaluation output mismatch")
-    
-    
+
+  def test_dopri_max_step_size(self):
+    self.message('dopri integration: maximum step size dividing the horizon')
+    t=SX.sym("t")
+    x=SX.sym("x")
+    f=SXFunction(daeIn(t=t,x=x),daeOut(ode=SX(1)))
+    f.init()
+    for h in [0.1,0.01,0.3,0.7,1e-3]:
+      for m in range(1,41):
+        integrator=Integrator("dopri",f)
+        integrator.setOption("initial_step_size",h)
+        integrator.setOption("max_step_size",h)
+        integrator.setOption("max_num_steps",100000)
+        integrator.setOption("tf",m*h)
+        integrator.init()
+        integrator.setInput(1,"x0")
+        integrator.evaluate()
+        self.assertAlmostEqual(integrator.getOutput()[0],1+m*h,9,"Evaluation output mismatch")
+
+
   def test_jac1(self):
     self.message('CVodes integration: jacobian to q0')
     num=self.num
@@ -33,6 +33,7 @@ lsolvers = []
 try:
   LinearSolver.loadPlugin("csparse")
   lsolvers.append(("csparse",{}))
+  lsolvers.append(("csparse",{"ordering": "colamd", "refactorize": True}))
 except:
   pass
   
@@ -502,6 +503,83 @@ class LinearSolverTests(casadiTestCase):
         f.evaluate()
 
         self.checkarray(mul(A_,f.getOutput()),b)
-      
+
+  @requiresPlugin(LinearSolver,"csparse")
+  def test_csparse_refactorize(self):
+    numpy.random.seed(1)
+    n = 10
+    A = self.randDMatrix(n,n,sparsity=0.5) + 4*DMatrix.eye(n)
+    b = self.randDMatrix(n,1)
+    for ordering in ["natural","amd","colamd"]:
+      S = LinearSolver("csparse",A.sparsity(),1)
+      S.setOption("ordering",ordering)
+      S.setOption("refactorize",True)
+      S.init()
+      for k in range(4):
+        A_ = DMatrix(A)
+        A_.set(A.nonzeros()*(1+0.1*k))
+        if k==2:
+          # Tiny diagonal forces the pivot sequence to be recomputed
+          A_[0,0] = 1e-12
+        S.setInput(A_,"A")
+        S.setInput(b,"B")
+        S.evaluate()
+        self.checkarray(mul(A_,S.getOutput()),b)
+      stats = S.getStats()
+      self.assertEqual(stats["n_factorize"]+stats["n_refactorize"],4)
+      self.assertTrue(stats["n_refactorize"]>=1)
+      self.assertTrue(stats["fill_in"]>=0)
+
+  @requiresPlugin(LinearSolver,"supernodal")
+  def test_supernodal(self):
+    numpy.random.seed(1)
+    # KKT matrix of an equality constrained QP: symmetric indefinite, zero block
+    nx = 12
+    nc = 5
+    H = self.randDMatrix(nx,nx,sparsity=0.3)
+    H = H + H.T + 10*DMatrix.eye(nx)
+    J = self.randDMatrix(nc,nx,sparsity=0.4) + horzcat([DMatrix.eye(nc),DMatrix.zeros(nc,nx-nc)])
+    K = blockcat([[H,J.T],[J,DMatrix.zeros(nc,nc)]])
+    b = self.randDMatrix(nx+nc,3)
+    for ordering in ["amd","natural"]:
+      S = LinearSolver("supernodal",K.sparsity(),3)
+      S.setOption("ordering",ordering)
+      S.init()
+      S.setInput(K,"A")
+      S.setInput(b,"B")
+      S.evaluate()
+      self.checkarray(mul(K,S.getOutput()),b)
+      self.assertEqual(list(S.getInertia()),[nx,nc,0])
+
+      # Same solver, new values
+      S.setInput(2*K,"A")
+      S.evaluate()
+      self.checkarray(mul(2*K,S.getOutput()),b)
+
+    C = solve(K,b,"supernodal")
+    self.checkarray(mul(K,C),b)
+
+  @requiresPlugin(LinearSolver,"supernodal")
+  def test_supernodal_singular(self):
+    # KKT matrix with a dependent constraint: one zero eigenvalue
+    nx = 6
+    nc = 3
+    H = 2*DMatrix.eye(nx)
+    for i in range(nx-1):
+      H[i,i+1] = H[i+1,i] = 0.5
+    J = horzcat([DMatrix.eye(nc),DMatrix.ones(nc,nx-nc)])
+    J[2,:] = J[1,:]
+    K = blockcat([[H,J.T],[J,DMatrix(Sparsity.dense(nc,nc),0)]])
+    b = mul(K,DMatrix.ones(nx+nc,1))
+    for ordering in ["amd","natural"]:
+      S = LinearSolver("supernodal",K.sparsity(),1)
+      S.setOption("ordering",ordering)
+      S.init()
+      S.setInput(K,"A")
+      S.setInput(b,"B")
+      S.evaluate()
+      self.checkarray(mul(K,S.getOutput()),b)
+      self.assertEqual(list(S.getInertia()),[nx,nc-1,1])
+
 if __name__ == '__main__':
     unittest.main()
@@ -2706,5 +2706,39 @@ class MXtests(casadiTestCase):
 
     h = g.jacobian(0,0,False,True)
 
+  def test_arena(self):
+    self.message("MXFunction arena")
+    x = MX.sym("x",3)
+    p = MX.sym("p",2,2)
+    A = MX.sym("A",3,3)
+    y = x
+    for i in range(4):
+      z = mul(p,y[:2])
+      y = vertcat([sin(z)+1,inner_prod(y,y)*0.1])
+      y = mul(DMatrix.ones(3,3)*0.1,y) + cos(y)
+      y[1] = y[0]*2
+      y = y.T.T
+      y = solve(A,y)
+      s = vertsplit(y,1)
+      y = vertcat([s[2],s[0],s[1]])
+    out = [y,2*y,x,y,mul(p,p).T]
+
+    f = MXFunction([x,p,A],out)
+    f.init()
+    g = MXFunction([x,p,A],out)
+    g.setOption("arena",True)
+    g.setOption("gather_stats",True)
+    g.init()
+    for h in [f,g]:
+      h.setInput([0.3,-0.2,0.5],0)
+      h.setInput(DMatrix([[0.5,-0.2],[0.1,0.7]]),1)
+      h.setInput(DMatrix([[2,0.1,0],[0,3,0.2],[0.3,0,1]]),2)
+      h.evaluate()
+    for i in range(len(out)):
+      self.checkarray(f.getOutput(i),g.getOutput(i),"output %d" % i)
+    self.checkarray(g.getInput(0),DMatrix([0.3,-0.2,0.5]))
+    self.assertTrue(g.getStat("memory_work")>0)
+    self.assertTrue(g.getStat("t_evaluate")>=0)
+
 if __name__ == '__main__':
     unittest.main()
@@ -229,7 +229,57 @@ class NLPtests(casadiTestCase):
       self.assertAlmostEqual(solver.getOutput("x")[1],1,6,str(Solver))
       self.assertAlmostEqual(solver.getOutput("lam_x")[0],0,5,str(Solver))
       self.assertAlmostEqual(solver.getOutput("lam_x")[1],0,5,str(Solver))
-    
+
+  def test_sqpmethod_lbfgs_block(self):
+    self.message("separable rosenbrock, block-diagonal limited-memory hessian approx")
+    x=SX.sym("x",6)
+
+    nlp=SXFunction(nlpIn(x=x),nlpOut(f=sum([(1-x[i])**2+10*(x[i+1]-x[i]**2)**2 for i in range(0,6,2)])))
+
+    for Solver, solver_options in solvers:
+      if Solver!="sqpmethod": continue
+      for structure in ["dense","block"]:
+        self.message(str(Solver) + " " + structure)
+        solver = NlpSolver(Solver, nlp)
+        solver.setOption(solver_options)
+        solver.setOption("hessian_approximation","limited-memory")
+        solver.setOption("lbfgs_structure",structure)
+        solver.setOption("max_iter",200)
+        solver.init()
+        solver.setInput([0.5,0.2,-0.3,0.1,0.8,0.4],"x0")
+        solver.setInput([-10]*6,"lbx")
+        solver.setInput([10]*6,"ubx")
+        solver.evaluate()
+        self.assertAlmostEqual(solver.getOutput("f")[0],0,8,str(Solver))
+        for i in range(6):
+          self.assertAlmostEqual(solver.getOutput("x")[i],1,4,str(Solver))
+
+  def test_sqpmethod_timers(self):
+    self.message("sqpmethod timing statistics")
+    x=SX.sym("x")
+    y=SX.sym("y")
+
+    nlp=SXFunction(nlpIn(x=vertcat([x,y])),nlpOut(f=(1-x)**2+100*(y-x**2)**2,g=x+y))
+
+    for Solver, solver_options in solvers:
+      if Solver!="sqpmethod": continue
+      solver = NlpSolver(Solver, nlp)
+      solver.setOption(solver_options)
+      solver.setOption("gather_stats",True)
+      solver.init()
+      solver.setInput(-10,"lbg")
+      solver.setInput(10,"ubg")
+      solver.evaluate()
+      stats = solver.getStats()
+      for phase in ["eval_f","eval_grad_f","eval_g","eval_jac_g","eval_h","qp_setup","qp_solve"]:
+        self.assertTrue(stats["t_"+phase]>=0)
+        self.assertTrue(stats["t_proc_"+phase]>=0)
+      self.assertEqual(stats["n_qp_solve"],stats["iter_count"])
+      self.assertTrue(stats["t_mainloop"]>=stats["t_qp_solve"])
+      iterations = stats["iterations"]
+      self.assertEqual(len(iterations["t_iter"]),len(iterations["obj"]))
+      self.assertEqual(len(iterations["t_qp_solve"]),len(iterations["obj"]))
+
   def testIPOPTrb2(self):
     self.message("rosenbrock, limited-memory hessian approx")
     x=SX.sym("x")
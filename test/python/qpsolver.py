@@ -46,6 +46,7 @@ if QpSolver.hasPlugin("ooqp"):
 
 if QpSolver.hasPlugin("qpoases"):
   qpsolvers.append(("qpoases",{}))
+  qpsolvers.append(("qpoases",{"sparse":True}))
 
 if QpSolver.hasPlugin("cplex"):
   qpsolvers.append(("cplex",{}))
@@ -516,7 +516,126 @@ class Simulatortests(casadiTestCase):
     p=num['p']
 
     self.assertAlmostEqual(sim.getOutput()[0,-1],q0*exp((tend**3-0.7**3)/(3*p)),9,"Evaluation output mismatch")
-            
+
+  def test_sim_num_threads(self):
+    self.message("Simulator: forward sensitivities in parallel batches")
+    num = self.num
+    tc = DMatrix(n.linspace(0,num['tend'],4))
+
+    t=SX.sym("t")
+    q=SX.sym("q",3)
+    p=SX.sym("p",3)
+
+    out = SXFunction(daeIn(t=t, x=q, p=p),[q])
+    out.init()
+
+    f=SXFunction(daeIn(t=t, x=q, p=p),daeOut(ode=q/p*t**2))
+    f.init()
+    integrator = Integrator("cvodes", f)
+    integrator.setOption("reltol",1e-15)
+    integrator.setOption("abstol",1e-15)
+    integrator.setOption("fsens_err_con", True)
+    integrator.setOption("t0",0)
+    integrator.setOption("tf",2.3)
+    integrator.init()
+    sim = Simulator(integrator,out,tc)
+    sim.setOption("num_threads",2)
+    sim.init()
+
+    solution = SXFunction(integratorIn(x0=q, p=p),[horzcat([q*exp(t**3/(3*p)) for t in tc])])
+    solution.init()
+
+    for f in [sim,solution]:
+      f.setInput([0.3,0.5,0.7],"x0")
+      f.setInput([0.7,0.9,1.1],"p")
+
+    self.checkfunction(sim,solution,adj=False,jacobian=True,gradient=False,hessian=False,sens_der=False,evals=False,digits=6)
+
+  def test_sim_parareal(self):
+    self.message("Simulator: Parareal iteration")
+    num = self.num
+    tc = n.linspace(0,num['tend'],21)
+    for nslice in [1,3,20]:
+      sim = Simulator(self.integrator,tc)
+      sim.setOption("parareal",True)
+      sim.setOption("parareal_slices",nslice)
+      sim.setOption("parareal_tol",1e-12)
+      sim.setOption("coarse_integrator_options",{"number_of_finite_elements":10})
+      sim.init()
+      sim.setInput([num['q0']],"x0")
+      sim.setInput([num['p']],"p")
+      sim.evaluate()
+
+      self.checkarray(sim.getOutput().T,num['q0']*exp(tc**3/(3*num['p'])),"Parareal with %d slices" % nslice,digits=7)
+
+    # Time slices in parallel, a loose tolerance stops the iteration early
+    nslice = 10
+    for num_threads in [2,3]:
+      sim = Simulator(self.integrator,tc)
+      sim.setOption("parareal",True)
+      sim.setOption("parareal_slices",nslice)
+      sim.setOption("parareal_tol",1e-6)
+      sim.setOption("num_threads",num_threads)
+      sim.setOption("gather_stats",True)
+      sim.setOption("coarse_integrator_options",{"number_of_finite_elements":10})
+      sim.init()
+      sim.setInput([num['q0']],"x0")
+      sim.setInput([num['p']],"p")
+      sim.evaluate()
+
+      self.assertTrue(sim.getStats()["parareal_iter"]<nslice)
+      self.checkarray(sim.getOutput().T,num['q0']*exp(tc**3/(3*num['p'])),"Parareal with %d threads" % num_threads,digits=5)
+
+    # Only ODEs are supported
+    t=SX.sym("t")
+    x=SX.sym("x")
+    z=SX.sym("z")
+    f=SXFunction(daeIn(t=t,x=x,z=z),daeOut(ode=z,alg=z-x))
+    f.init()
+    integrator = Integrator("idas", f)
+    integrator.setOption("tf",num['tend'])
+    integrator.init()
+    sim = Simulator(integrator,tc)
+    sim.setOption("parareal",True)
+    self.assertRaises(Exception,lambda : sim.init())
+
+  def test_sim_dopri_dense(self):
+    self.message("Simulator: dense output of the dopri integrator")
+    num = self.num
+    tc = n.linspace(0,num['tend'],201)
+    for tableau, tol, digits in [("dopri5",1e-8,5),("bs3",1e-6,3)]:
+      integrator = Integrator("dopri", self.f)
+      integrator.setOption("tableau",tableau)
+      integrator.setOption("reltol",tol)
+      integrator.setOption("abstol",tol)
+      integrator.setOption("tf",num['tend'])
+      integrator.setOption("gather_stats",True)
+      integrator.init()
+
+      # Fewer steps than grid intervals: most grid points are interpolated inside a step
+      integrator.setInput([num['q0']],"x0")
+      integrator.setInput([num['p']],"p")
+      integrator.evaluate()
+      self.assertTrue(integrator.getStats()["nsteps"]<len(tc)-1)
+
+      sim = Simulator(integrator,tc)
+      sim.init()
+      sim.setInput([num['q0']],"x0")
+      sim.setInput([num['p']],"p")
+      sim.evaluate()
+      self.checkarray(sim.getOutput().T,num['q0']*exp(tc**3/(3*num['p'])),"Dense output with %s" % tableau,digits=digits)
+
+    # max_num_steps counts the steps over the whole horizon, not per grid interval
+    integrator = Integrator("dopri", self.f)
+    integrator.setOption("max_num_steps",5)
+    integrator.setOption("tf",num['tend'])
+    integrator.init()
+    sim = Simulator(integrator,tc)
+    sim.init()
+    sim.setInput([num['q0']],"x0")
+    sim.setInput([num['p']],"p")
+    self.assertRaises(Exception,lambda : sim.evaluate())
+
 if __name__ == '__main__':
     unittest.main()
 
@@ -328,6 +328,144 @@ class SXtests(casadiTestCase):
     Jr=matrix([[1,1],[3,2],[4,27]])
     self.checkarray(J.getOutput(0),Jr,"SXfunction jacobian evaluates incorrectly")
           
+  def test_evaluator(self):
+    self.message("SXFunction threaded bytecode evaluator")
+    x=SX.sym("x")
+    y=SX.sym("y")
+    z=vertcat([x*y+3,2*sin(x)+x*x,y/(1+x),fmax(x,y)-atan2(y,x),3-x])
+    L=[0.7,-1.3]
+    res = []
+    for evaluator in ["switch","threaded"]:
+      f=SXFunction([vertcat([x,y])],[z])
+      f.setOption("evaluator",evaluator)
+      f.init()
+      f.setInput(L)
+      f.evaluate()
+      res.append(f.getOutput())
+    self.assertEqual(list(res[0].data()),list(res[1].data()))
+
+  def test_evaluateBatch(self):
+    self.message("SXFunction batched evaluation")
+    x=SX.sym("x",2)
+    p=SX.sym("p")
+    f=SXFunction([x,p],[vertcat([x[0]*x[1]+p,sin(x[0])/(1+p*p)]),sqrt(x[1]**2+3)])
+    f.init()
+    n = 5
+    X = DMatrix([[0.1*k+0.2 for k in range(n)],[1.5-0.3*k for k in range(n)]])
+    P = DMatrix([[0.7*k for k in range(n)]])
+    res = f.evaluateBatch(n,[X,P])
+    for k in range(n):
+      f.setInput(X[:,k],0)
+      f.setInput(P[:,k],1)
+      f.evaluate()
+      self.checkarray(res[0][:,k],f.getOutput(0),digits=15)
+      self.checkarray(res[1][:,k],f.getOutput(1),digits=15)
+
+    # Same number of rows and nonzeros, but not the pattern of n copies of the input
+    self.assertRaises(Exception,lambda : f.evaluateBatch(n,[horzcat([X,DMatrix.sparse(2,1)]),P]))
+
+  def test_codegen_batch(self):
+    self.message("SXFunction batched entry point of generated code")
+    x=SX.sym("x",2)
+    p=SX.sym("p")
+    f=SXFunction([x,p],[vertcat([x[0]*x[1]+p,sin(x[0])/(1+p*p)]),sqrt(x[1]**2+3)])
+    f.setOption("codegen_batch",True)
+    f.init()
+    n = 5
+    X = DMatrix([[0.1*k+0.2 for k in range(n)],[1.5-0.3*k for k in range(n)]])
+    P = DMatrix([[0.7*k for k in range(n)]])
+    res = f.evaluateBatch(n,[X,P])
+
+    import tempfile, os, shutil, subprocess, ctypes
+    tmpdir = tempfile.mkdtemp()
+    try:
+      cfile = os.path.join(tmpdir,"f.c")
+      bfile = os.path.join(tmpdir,"f.so")
+      f.generateCode(cfile)
+      self.assertEqual(subprocess.call(["gcc","-fPIC","-shared","-O3",cfile,"-o",bfile,"-lm"]),0)
+      lib = ctypes.CDLL(bfile)
+
+      # evaluateBatch stores the points one after the other, the generated code interleaves them
+      def interleave(v,nnz):
+        return [v[j*nnz+k] for k in range(nnz) for j in range(n)]
+      x_buf = [(ctypes.c_double*len(a.data()))(*interleave(a.data(),f.input(i).size())) for i,a in enumerate([X,P])]
+      r_buf = [(ctypes.c_double*len(a.data()))() for a in res]
+      x_ptr = (ctypes.POINTER(ctypes.c_double)*2)(*[ctypes.cast(b,ctypes.POINTER(ctypes.c_double)) for b in x_buf])
+      r_ptr = (ctypes.POINTER(ctypes.c_double)*2)(*[ctypes.cast(b,ctypes.POINTER(ctypes.c_double)) for b in r_buf])
+      self.assertEqual(lib.evaluateBatch(ctypes.c_int(n),x_ptr,r_ptr),0)
+
+      for i in range(2):
+        self.checkarray(DMatrix(list(r_buf[i])),DMatrix(interleave(res[i].data(),f.output(i).size())),digits=12)
+    finally:
+      shutil.rmtree(tmpdir)
+
+  def test_compact_tape(self):
+    self.message("SXFunction compact tape")
+    x=SX.sym("x")
+    y=SX.sym("y")
+    z=vertcat([x*y+3,2*sin(x)+x*x,y/(1+x),fmax(x,y)-atan2(y,x),3-x])
+    L=[0.7,-1.3]
+    f=SXFunction([vertcat([x,y])],[z])
+    f.init()
+    f.setInput(L)
+    f.evaluate()
+    g=SXFunction([vertcat([x,y])],[z])
+    g.setOption("compact_tape",True)
+    g.init()
+    g.clearSymbolic()
+    self.assertEqual(g.getStat("memory_algorithm"),0)
+    self.assertTrue(g.getStat("memory_compact_tape")>0)
+    g.setInput(L)
+    g.evaluate()
+    self.assertEqual(list(f.getOutput().data()),list(g.getOutput().data()))
+    self.assertTrue(f.jacSparsity()==g.jacSparsity())
+    self.assertRaises(Exception,lambda : g.getAlgorithmSize())
+
+  def test_cse(self):
+    self.message("SXFunction common subexpression elimination")
+    x=SX.sym("x")
+    y=SX.sym("y")
+    z=vertcat([cos(x)*y-sin(x),sin(x)*y+cos(x),y*sin(x)+3,3+sin(x)*y])
+    L=[0.7,-1.3]
+    f=SXFunction([vertcat([x,y])],[z])
+    f.init()
+    f.setInput(L)
+    f.evaluate()
+    g=SXFunction([vertcat([x,y])],[z])
+    g.setOption("cse",True)
+    g.init()
+    self.assertTrue(g.getStat("cse_nodes_after")<g.getStat("cse_nodes_before"))
+    self.assertTrue(g.getAlgorithmSize()<f.getAlgorithmSize())
+    g.setInput(L)
+    g.evaluate()
+    self.checkarray(f.getOutput(),g.getOutput())
+    J=g.jacobian()
+    J.init()
+    J.setInput(L)
+    J.evaluate()
+    Jf=f.jacobian()
+    Jf.init()
+    Jf.setInput(L)
+    Jf.evaluate()
+    self.checkarray(Jf.getOutput(),J.getOutput())
+
+  def test_cse_shared_outputs(self):
+    self.message("SXFunction common subexpression elimination: outputs sharing a node")
+    x=SX.sym("x")
+    y=SX.sym("y")
+    outputs=[vertcat([sin(x),sin(x),x,x]),vertcat([sin(x)*y,y*sin(x)]),sin(x)]
+    f=SXFunction([vertcat([x,y])],outputs)
+    f.init()
+    g=SXFunction([vertcat([x,y])],outputs)
+    g.setOption("cse",True)
+    g.init()
+    for fun in [f,g]:
+      fun.setInput([0.5,2])
+      fun.evaluate()
+    for i in range(len(outputs)):
+      self.checkarray(f.getOutput(i),g.getOutput(i))
+    self.checkarray(g.getOutput(0),DMatrix([sin(0.5),sin(0.5),0.5,0.5]))
+
   def test_SX2(self):
     self.message("SXFunction evalution 2")
     fun = lambda x,y: [3-sin(x*x)-y, sqrt(y)*x]